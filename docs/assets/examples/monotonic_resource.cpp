@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <vector>
+
+#include <lexy/action/parse.hpp>
+#include <lexy/callback.hpp>
+#include <lexy/dsl.hpp>
+#include <lexy/memory_resource.hpp>
+#include <lexy_ext/compiler_explorer.hpp>
+#include <lexy_ext/report_error.hpp>
+
+namespace dsl = lexy::dsl;
+
+//{
+struct point
+{
+    int x, y;
+};
+
+// A list whose memory comes from the arena.
+using point_list = std::vector<point*, lexy::memory_resource_allocator<point*, //
+                                                                       lexy::monotonic_resource>>;
+
+struct point_production
+{
+    static constexpr auto rule = [] {
+        auto integer = dsl::integer<int>;
+        return dsl::parenthesized(dsl::twice(integer, dsl::sep(dsl::comma)));
+    }();
+
+    // Allocate the point from the arena, which is the parse state.
+    static constexpr auto value = lexy::new_<point>.resource();
+};
+
+struct production
+{
+    static constexpr auto whitespace = dsl::ascii::space;
+    static constexpr auto rule       = dsl::list(dsl::p<point_production>);
+
+    // Construct the list with the arena as allocator.
+    static constexpr auto value = lexy::as_list<point_list>.allocator();
+};
+//}
+
+int main()
+{
+    // The arena frees the memory of the buffer, the list, and the points at once.
+    lexy::monotonic_resource arena;
+
+    auto input = lexy_ext::compiler_explorer_input();
+    auto buffer
+        = lexy::buffer<lexy::utf8_encoding, lexy::monotonic_resource>(input.data(), input.size(),
+                                                                      &arena);
+
+    auto result = lexy::parse<production>(buffer, arena, lexy_ext::report_error);
+    if (!result)
+        return 1;
+
+    for (auto p : result.value())
+        std::printf("(%d, %d)\n", p->x, p->y);
+}
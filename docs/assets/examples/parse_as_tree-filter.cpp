@@ -0,0 +1,42 @@
+#include <cstdio>
+
+#include <lexy/action/parse_as_tree.hpp>
+#include <lexy/dsl.hpp>
+#include <lexy/parse_tree.hpp>
+#include <lexy_ext/compiler_explorer.hpp>
+#include <lexy_ext/report_error.hpp>
+
+namespace dsl = lexy::dsl;
+
+//{
+struct key
+{
+    static constexpr auto rule = dsl::identifier(dsl::ascii::alnum);
+};
+
+struct integer
+{
+    static constexpr auto rule = dsl::digits<>;
+};
+
+struct key_value_pair
+{
+    static constexpr auto whitespace = dsl::ascii::space;
+    static constexpr auto rule       = dsl::p<key> + dsl::lit_c<'='> + dsl::p<integer>;
+};
+
+int main()
+{
+    auto input = lexy_ext::compiler_explorer_input();
+
+    // Neither the whitespace nor the `=` end up in the tree.
+    using filter = lexy::drop_tokens<lexy::whitespace_token_kind, lexy::literal_token_kind>;
+
+    lexy::parse_tree_for<decltype(input)> tree;
+    if (!lexy::parse_as_tree<key_value_pair, filter>(tree, input, lexy_ext::report_error))
+        return 1;
+
+    lexy::visualize(stdout, tree, {lexy::visualize_fancy});
+}
+//}
+
@@ -0,0 +1,75 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_ADDRESS_TABLE_HPP_INCLUDED
+#define LEXY_DETAIL_ADDRESS_TABLE_HPP_INCLUDED
+
+#include <cstdint>
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+
+namespace lexy::_detail
+{
+// A fixed-capacity hash table that maps addresses to indices.
+// It uses open addressing with linear probing and a load factor of at most one half.
+template <typename MemoryResource>
+class address_table
+{
+    struct slot
+    {
+        void*       address;
+        std::size_t value;
+    };
+
+public:
+    // Allocates enough memory for inserting `count` addresses.
+    explicit address_table(std::size_t count, MemoryResource* resource)
+    : _capacity(_capacity_for(count)), _slots(_capacity, resource)
+    {
+        for (auto i = std::size_t(0); i != _capacity; ++i)
+            _slots[i] = slot{nullptr, 0};
+    }
+
+    void insert(void* address, std::size_t value) noexcept
+    {
+        LEXY_PRECONDITION(address != nullptr);
+
+        auto idx = _hash(address);
+        while (_slots[idx].address != nullptr)
+            idx = (idx + 1) & (_capacity - 1);
+        _slots[idx] = slot{address, value};
+    }
+
+    std::size_t find(void* address) const noexcept
+    {
+        for (auto idx = _hash(address);; idx = (idx + 1) & (_capacity - 1))
+        {
+            LEXY_PRECONDITION(_slots[idx].address != nullptr); // address was not inserted
+            if (_slots[idx].address == address)
+                return _slots[idx].value;
+        }
+    }
+
+private:
+    static std::size_t _capacity_for(std::size_t count) noexcept
+    {
+        auto capacity = std::size_t(2);
+        while (capacity < 2 * count)
+            capacity *= 2;
+        return capacity;
+    }
+
+    std::size_t _hash(void* address) const noexcept
+    {
+        auto value = std::uint_least64_t(reinterpret_cast<std::uintptr_t>(address));
+        return std::size_t((value * 0x9E37'79B9'7F4A'7C15) >> 32) & (_capacity - 1);
+    }
+
+    std::size_t                          _capacity;
+    resource_array<slot, MemoryResource> _slots;
+};
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_ADDRESS_TABLE_HPP_INCLUDED
+
@@ -0,0 +1,250 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_BLOB_DECODE_HPP_INCLUDED
+#define LEXY_DETAIL_BLOB_DECODE_HPP_INCLUDED
+
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/swar.hpp>
+
+namespace lexy::_detail
+{
+// The numerical value of a hex digit, or -1 if it isn't one.
+template <typename IntT>
+constexpr int hex_digit_value(IntT c) noexcept
+{
+    if (c >= '0' && c <= '9')
+        return static_cast<int>(c - '0');
+    else if (c >= 'a' && c <= 'f')
+        return static_cast<int>(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+        return static_cast<int>(c - 'A' + 10);
+    else
+        return -1;
+}
+
+// The numerical value of a char of the base64 alphabet, or -1 if it isn't one.
+template <typename IntT>
+constexpr int base64_digit_value(IntT c) noexcept
+{
+    if (c >= 'A' && c <= 'Z')
+        return static_cast<int>(c - 'A');
+    else if (c >= 'a' && c <= 'z')
+        return static_cast<int>(c - 'a' + 26);
+    else if (c >= '0' && c <= '9')
+        return static_cast<int>(c - '0' + 52);
+    else if (c == '+')
+        return 62;
+    else if (c == '/')
+        return 63;
+    else
+        return -1;
+}
+
+#if LEXY_ENABLE_SIMD
+inline const unsigned char* _simd_decode_hex_sse2(const unsigned char* ptr,
+                                                  const unsigned char* end, unsigned char*& out,
+                                                  unsigned char* out_end) noexcept
+{
+    while ((end == nullptr || end - ptr >= 16) && out_end - out >= 8)
+    {
+        // c is a digit if c - '0' <= 9 (unsigned), and a letter if (c | 0x20) - 'a' <= 5.
+        auto block    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        auto digit    = _mm_sub_epi8(block, _mm_set1_epi8('0'));
+        auto is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+        auto letter = _mm_sub_epi8(_mm_or_si128(block, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        auto is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+        if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF)
+            break;
+
+        auto values
+            = _mm_or_si128(_mm_and_si128(is_digit, digit),
+                           _mm_andnot_si128(is_digit, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+
+        // Each 16 bit word has the high nibble in its first byte and the low one in its second.
+        auto high  = _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0xFF)), 4);
+        auto low   = _mm_srli_epi16(values, 8);
+        auto bytes = _mm_packus_epi16(_mm_or_si128(high, low), _mm_setzero_si128());
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+
+        ptr += 16;
+        out += 8;
+    }
+    return ptr;
+}
+
+LEXY_SIMD_TARGET_AVX2 inline const unsigned char* _simd_decode_hex_avx2(
+    const unsigned char* ptr, const unsigned char* end, unsigned char*& out,
+    unsigned char* out_end) noexcept
+{
+    while ((end == nullptr || end - ptr >= 32) && out_end - out >= 16)
+    {
+        auto block    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        auto digit    = _mm256_sub_epi8(block, _mm256_set1_epi8('0'));
+        auto is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+        auto letter   = _mm256_sub_epi8(_mm256_or_si256(block, _mm256_set1_epi8(0x20)),
+                                        _mm256_set1_epi8('a'));
+        auto is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+        if (static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)))
+            != 0xFFFF'FFFF)
+            break;
+
+        auto values = _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+                                      _mm256_andnot_si256(is_digit,
+                                                          _mm256_add_epi8(letter,
+                                                                          _mm256_set1_epi8(10))));
+
+        auto high  = _mm256_slli_epi16(_mm256_and_si256(values, _mm256_set1_epi16(0xFF)), 4);
+        auto low   = _mm256_srli_epi16(values, 8);
+        auto bytes = _mm256_packus_epi16(_mm256_or_si256(high, low), _mm256_setzero_si256());
+        // The packed bytes are in the first half of each lane.
+        bytes = _mm256_permute4x64_epi64(bytes, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(bytes));
+
+        ptr += 32;
+        out += 16;
+    }
+    return ptr;
+}
+
+// The lookup tables to validate and decode base64 using shuffles, as described by Wojciech Muła
+// (http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html).
+// A char c is valid if lo[c & 0xF] & hi[c >> 4] is zero, and its value is c + roll[c >> 4],
+// except for '/', which uses the entry before.
+constexpr char _base64_lut_lo[16]   = {0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                       0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A};
+constexpr char _base64_lut_hi[16]   = {0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                       0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10};
+constexpr char _base64_lut_roll[16] = {0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0};
+
+LEXY_SIMD_TARGET_SSSE3 inline const unsigned char* _simd_decode_base64_ssse3(
+    const unsigned char* ptr, const unsigned char* end, unsigned char*& out,
+    unsigned char* out_end) noexcept
+{
+    auto lut_lo      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_base64_lut_lo));
+    auto lut_hi      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_base64_lut_hi));
+    auto lut_roll    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_base64_lut_roll));
+    auto nibble_mask = _mm_set1_epi8(0x0F);
+    // We write 16 bytes, even though only 12 of them are used.
+    while ((end == nullptr || end - ptr >= 16) && out_end - out >= 16)
+    {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        auto hi    = _mm_and_si128(_mm_srli_epi32(block, 4), nibble_mask);
+        auto lo    = _mm_and_si128(block, nibble_mask);
+
+        auto invalid = _mm_and_si128(_mm_shuffle_epi8(lut_lo, lo), _mm_shuffle_epi8(lut_hi, hi));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xFFFF)
+            break;
+
+        auto is_slash = _mm_cmpeq_epi8(block, _mm_set1_epi8('/'));
+        auto roll     = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(is_slash, hi));
+        auto values   = _mm_add_epi8(block, roll);
+
+        // Merge the 6 bits of four chars into 24 bits, then put the three bytes in order.
+        auto pairs   = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        auto triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        auto bytes   = _mm_shuffle_epi8(triples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13,
+                                                               12, -1, -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+
+        ptr += 16;
+        out += 12;
+    }
+    return ptr;
+}
+
+LEXY_SIMD_TARGET_AVX2 inline const unsigned char* _simd_decode_base64_avx2(
+    const unsigned char* ptr, const unsigned char* end, unsigned char*& out,
+    unsigned char* out_end) noexcept
+{
+    auto lut_lo = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(_base64_lut_lo)));
+    auto lut_hi = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(_base64_lut_hi)));
+    auto lut_roll = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(_base64_lut_roll)));
+    auto nibble_mask = _mm256_set1_epi8(0x0F);
+    // We write 32 bytes, even though only 24 of them are used.
+    while ((end == nullptr || end - ptr >= 32) && out_end - out >= 32)
+    {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        auto hi    = _mm256_and_si256(_mm256_srli_epi32(block, 4), nibble_mask);
+        auto lo    = _mm256_and_si256(block, nibble_mask);
+
+        auto invalid
+            = _mm256_and_si256(_mm256_shuffle_epi8(lut_lo, lo), _mm256_shuffle_epi8(lut_hi, hi));
+        if (!_mm256_testz_si256(invalid, invalid))
+            break;
+
+        auto is_slash = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('/'));
+        auto roll     = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(is_slash, hi));
+        auto values   = _mm256_add_epi8(block, roll);
+
+        auto pairs   = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        auto triples = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        auto bytes
+            = _mm256_shuffle_epi8(triples, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                                            -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10,
+                                                            9, 8, 14, 13, 12, -1, -1, -1, -1));
+        // Each lane has 12 bytes, move them together.
+        bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), bytes);
+
+        ptr += 32;
+        out += 24;
+    }
+    return ptr;
+}
+#endif
+
+// The maximal number of bytes written by one step of simd_decode_hex/base64().
+constexpr std::size_t simd_decode_block_size = 32;
+
+// Decodes hex digits starting at ptr into out, advancing out, and returns a pointer to the first
+// char that hasn't been decoded.
+// It decodes complete blocks only, so it stops up to simd_block_size chars before the first char
+// that isn't a hex digit or end (unless it is nullptr), or when out_end - out is less than
+// simd_decode_block_size.
+// Requires: if end is nullptr, there is a char that isn't a hex digit at most simd_block_size bytes
+// before the end of the memory.
+template <typename CharT>
+const CharT* simd_decode_hex(const CharT* ptr, const CharT* end, unsigned char*& out,
+                             unsigned char* out_end) noexcept
+{
+    static_assert(sizeof(CharT) == 1);
+#if LEXY_ENABLE_SIMD
+    auto uptr = reinterpret_cast<const unsigned char*>(ptr);
+    auto uend = reinterpret_cast<const unsigned char*>(end);
+    if (get_simd_level() == simd_level::avx2)
+        uptr = _simd_decode_hex_avx2(uptr, uend, out, out_end);
+    else
+        uptr = _simd_decode_hex_sse2(uptr, uend, out, out_end);
+    return reinterpret_cast<const CharT*>(uptr);
+#else
+    (void)end, (void)out, (void)out_end;
+    return ptr;
+#endif
+}
+
+// Same as above, but for the chars of the base64 alphabet; it stops before padding.
+template <typename CharT>
+const CharT* simd_decode_base64(const CharT* ptr, const CharT* end, unsigned char*& out,
+                                unsigned char* out_end) noexcept
+{
+    static_assert(sizeof(CharT) == 1);
+#if LEXY_ENABLE_SIMD
+    auto uptr = reinterpret_cast<const unsigned char*>(ptr);
+    auto uend = reinterpret_cast<const unsigned char*>(end);
+    if (get_simd_level() == simd_level::avx2)
+        uptr = _simd_decode_base64_avx2(uptr, uend, out, out_end);
+    else if (get_simd_level() == simd_level::ssse3)
+        uptr = _simd_decode_base64_ssse3(uptr, uend, out, out_end);
+    return reinterpret_cast<const CharT*>(uptr);
+#else
+    (void)end, (void)out, (void)out_end;
+    return ptr;
+#endif
+}
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_BLOB_DECODE_HPP_INCLUDED
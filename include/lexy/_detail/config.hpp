@@ -113,6 +113,27 @@ using type_or = std::conditional_t<std::is_void_v<T>, Fallback, T>;
 #    define LEXY_CONSTEXPR_DTOR
 #endif
 
+#ifndef LEXY_HAS_IS_CONSTANT_EVALUATED
+#    if defined(__has_builtin)
+#        if __has_builtin(__builtin_is_constant_evaluated)
+#            define LEXY_HAS_IS_CONSTANT_EVALUATED 1
+#        endif
+#    endif
+#    ifndef LEXY_HAS_IS_CONSTANT_EVALUATED
+#        if (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#            define LEXY_HAS_IS_CONSTANT_EVALUATED 1
+#        else
+#            define LEXY_HAS_IS_CONSTANT_EVALUATED 0
+#        endif
+#    endif
+#endif
+
+#if LEXY_HAS_IS_CONSTANT_EVALUATED
+#    define LEXY_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#    define LEXY_IS_CONSTANT_EVALUATED() false
+#endif
+
 //=== char8_t ===//
 #ifndef LEXY_HAS_CHAR8_T
 #    if __cpp_char8_t
@@ -159,6 +180,15 @@ using _char8_t = unsigned char;
 #    endif
 #endif
 
+//=== SIMD ===//
+#ifndef LEXY_ENABLE_SIMD
+#    if defined(__x86_64__) || (defined(_M_X64) && !defined(_M_ARM64EC))
+#        define LEXY_ENABLE_SIMD 1
+#    else
+#        define LEXY_ENABLE_SIMD 0
+#    endif
+#endif
+
 //=== force inline ===//
 #ifndef LEXY_FORCE_INLINE
 #    if defined(__has_cpp_attribute)
@@ -0,0 +1,570 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_DECIMAL_FLOAT_HPP_INCLUDED
+#define LEXY_DETAIL_DECIMAL_FLOAT_HPP_INCLUDED
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <lexy/_detail/config.hpp>
+
+#include <lexy/_detail/power_of_five.hpp>
+
+// Converts the decimal representation of a floating-point number to the nearest float or double.
+//
+// It first tries the exact Clinger fast path, then the Eisel-Lemire algorithm
+// (https://arxiv.org/abs/2101.11408) using the first 19 significant digits.
+// Only if the remaining digits influence the result, it falls back to big decimal arithmetic.
+
+namespace lexy::_detail
+{
+template <typename T>
+struct float_format;
+
+template <>
+struct float_format<float>
+{
+    using bits_type = std::uint32_t;
+
+    static constexpr int mantissa_bits    = 23;
+    static constexpr int minimum_exponent = -127;
+    static constexpr int infinite_power   = 0xFF;
+
+    static constexpr int smallest_power_of_ten = -65;
+    static constexpr int largest_power_of_ten  = 38;
+
+    static constexpr int min_exponent_round_to_even = -17;
+    static constexpr int max_exponent_round_to_even = 10;
+
+    static constexpr int           max_exponent_fast_path = 10;
+    static constexpr std::uint64_t max_mantissa_fast_path = std::uint64_t(2) << mantissa_bits;
+    static constexpr float exact_powers_of_ten[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                                    1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+};
+
+template <>
+struct float_format<double>
+{
+    using bits_type = std::uint64_t;
+
+    static constexpr int mantissa_bits    = 52;
+    static constexpr int minimum_exponent = -1023;
+    static constexpr int infinite_power   = 0x7FF;
+
+    static constexpr int smallest_power_of_ten = -342;
+    static constexpr int largest_power_of_ten  = 308;
+
+    static constexpr int min_exponent_round_to_even = -4;
+    static constexpr int max_exponent_round_to_even = 23;
+
+    static constexpr int           max_exponent_fast_path = 22;
+    static constexpr std::uint64_t max_mantissa_fast_path = std::uint64_t(2) << mantissa_bits;
+    static constexpr double exact_powers_of_ten[]
+        = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+           1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+};
+
+// The binary representation of a floating-point number:
+// the mantissa without the implicit bit and the biased exponent.
+struct adjusted_mantissa
+{
+    std::uint64_t mantissa;
+    int           power2;
+};
+
+template <typename T>
+constexpr T to_float(adjusted_mantissa am) noexcept
+{
+    using format = float_format<T>;
+    if (!LEXY_IS_CONSTANT_EVALUATED())
+    {
+        auto bits = typename format::bits_type(am.mantissa);
+        bits |= typename format::bits_type(am.power2) << format::mantissa_bits;
+
+        T result{};
+        std::memcpy(&result, &bits, sizeof(T));
+        return result;
+    }
+    else if (am.power2 == format::infinite_power)
+    {
+        return std::numeric_limits<T>::infinity();
+    }
+    else
+    {
+        // Compute mantissa * 2^exponent; every intermediate value is exact.
+        auto exponent = am.power2 + format::minimum_exponent - format::mantissa_bits;
+        if (am.power2 == 0)
+            exponent += 1;
+        else
+            am.mantissa |= std::uint64_t(1) << format::mantissa_bits;
+
+        T scale = 1;
+        for (; exponent > 0; --exponent)
+            scale *= 2;
+        for (; exponent < 0; ++exponent)
+            scale /= 2;
+        return T(am.mantissa) * scale;
+    }
+}
+
+//=== Eisel-Lemire ===//
+struct uint128_parts
+{
+    std::uint64_t low, high;
+};
+
+constexpr uint128_parts full_multiplication(std::uint64_t a, std::uint64_t b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    auto product = __uint128_t(a) * b;
+    return {std::uint64_t(product), std::uint64_t(product >> 64)};
+#else
+    auto a_lo = a & 0xFFFF'FFFF, a_hi = a >> 32;
+    auto b_lo = b & 0xFFFF'FFFF, b_hi = b >> 32;
+
+    auto lo_lo = a_lo * b_lo;
+    auto hi_lo = a_hi * b_lo;
+    auto lo_hi = a_lo * b_hi;
+    auto hi_hi = a_hi * b_hi;
+
+    auto cross = (lo_lo >> 32) + (hi_lo & 0xFFFF'FFFF) + lo_hi;
+    return {(cross << 32) | (lo_lo & 0xFFFF'FFFF), (hi_lo >> 32) + (cross >> 32) + hi_hi};
+#endif
+}
+
+constexpr int count_leading_zeroes(std::uint64_t value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#else
+    auto result = 0;
+    for (; (value & (std::uint64_t(1) << 63)) == 0; value <<= 1)
+        ++result;
+    return result;
+#endif
+}
+
+// Computes the nearest floating-point number of w * 10^q.
+// Precondition: w < 10^19.
+template <typename T>
+constexpr adjusted_mantissa compute_float(int q, std::uint64_t w) noexcept
+{
+    using format = float_format<T>;
+    if (w == 0 || q < format::smallest_power_of_ten)
+        return {0, 0};
+    else if (q > format::largest_power_of_ten)
+        return {0, format::infinite_power};
+
+    auto lz = count_leading_zeroes(w);
+    w <<= lz;
+
+    // We need the upper mantissa_bits + 3 bits of the product to be exact;
+    // if they can be affected by the truncation of 5^q, we use more bits of it.
+    constexpr auto precision_mask = ~std::uint64_t(0) >> (format::mantissa_bits + 3);
+
+    auto index   = 2 * (q - power_of_five_128_smallest);
+    auto product = full_multiplication(w, power_of_five_128[index]);
+    if ((product.high & precision_mask) == precision_mask)
+    {
+        auto second = full_multiplication(w, power_of_five_128[index + 1]);
+        product.low += second.high;
+        if (second.high > product.low)
+            ++product.high;
+    }
+
+    auto upperbit = int(product.high >> 63);
+    auto shift    = upperbit + 64 - format::mantissa_bits - 3;
+
+    // power(q) = floor(log2(10^q)) + 63
+    auto power = (((152170 + 65536) * q) >> 16) + 63;
+
+    adjusted_mantissa am{product.high >> shift,
+                         power + upperbit - lz - format::minimum_exponent};
+    if (am.power2 <= 0)
+    {
+        // Subnormal number, we need to shift the mantissa further.
+        if (-am.power2 + 1 >= 64)
+            return {0, 0};
+
+        am.mantissa >>= -am.power2 + 1;
+        am.mantissa += am.mantissa & 1;
+        am.mantissa >>= 1;
+        // Rounding up might have created a normal number.
+        am.power2 = am.mantissa < (std::uint64_t(1) << format::mantissa_bits) ? 0 : 1;
+        return am;
+    }
+
+    // If we're exactly in the middle between two floats, we need to round to even.
+    if (product.low <= 1 && q >= format::min_exponent_round_to_even
+        && q <= format::max_exponent_round_to_even && (am.mantissa & 3) == 1
+        && (am.mantissa << shift) == product.high)
+        am.mantissa &= ~std::uint64_t(1);
+
+    am.mantissa += am.mantissa & 1;
+    am.mantissa >>= 1;
+    if (am.mantissa >= (std::uint64_t(2) << format::mantissa_bits))
+    {
+        am.mantissa = std::uint64_t(1) << format::mantissa_bits;
+        ++am.power2;
+    }
+    am.mantissa &= ~(std::uint64_t(1) << format::mantissa_bits);
+
+    if (am.power2 >= format::infinite_power)
+        return {0, format::infinite_power};
+    return am;
+}
+
+//=== big decimal ===//
+// The decimal number 0.d[0]d[1]...d[count-1] * 10^point.
+class big_decimal
+{
+public:
+    static constexpr int max_digits = 800;
+
+    constexpr big_decimal() noexcept : _digits{}, _count(0), _point(0), _truncated(false) {}
+
+    constexpr void push_digit(unsigned digit) noexcept
+    {
+        if (_count < max_digits)
+            _digits[_count++] = static_cast<unsigned char>(digit);
+        else if (digit != 0)
+            _truncated = true;
+    }
+
+    constexpr void set_point(int point) noexcept
+    {
+        _point = point;
+    }
+
+    template <typename T>
+    constexpr adjusted_mantissa to_float() noexcept
+    {
+        using format = float_format<T>;
+
+        _trim();
+        if (_count == 0 || _point < -330)
+            return {0, 0};
+        else if (_point > 310)
+            return {0, format::infinite_power};
+
+        // Scale by powers of two until we're in [0.5, 1).
+        auto exponent = 0;
+        while (_point > 0)
+        {
+            auto n = _point < powtab_size ? _powtab[_point] : 27;
+            _shift(-n);
+            exponent += n;
+        }
+        while (_point < 0 || (_point == 0 && _digits[0] < 5))
+        {
+            auto n = -_point < powtab_size ? _powtab[-_point] : 27;
+            _shift(n);
+            exponent -= n;
+        }
+
+        // The floating-point representation uses [1, 2) instead.
+        --exponent;
+        // Subnormal numbers have the minimal exponent.
+        if (exponent < format::minimum_exponent + 1)
+        {
+            auto n = format::minimum_exponent + 1 - exponent;
+            _shift(-n);
+            exponent += n;
+        }
+        if (exponent - format::minimum_exponent >= format::infinite_power)
+            return {0, format::infinite_power};
+
+        // Extract the mantissa including the implicit bit.
+        _shift(1 + format::mantissa_bits);
+        auto mantissa = _rounded_integer();
+        if (mantissa == (std::uint64_t(2) << format::mantissa_bits))
+        {
+            // Rounding up has created an additional bit.
+            mantissa >>= 1;
+            ++exponent;
+            if (exponent - format::minimum_exponent >= format::infinite_power)
+                return {0, format::infinite_power};
+        }
+
+        if ((mantissa & (std::uint64_t(1) << format::mantissa_bits)) == 0)
+            // It is a subnormal number.
+            exponent = format::minimum_exponent;
+
+        return {mantissa & ((std::uint64_t(1) << format::mantissa_bits) - 1),
+                exponent - format::minimum_exponent};
+    }
+
+private:
+    // The number of bits we can shift in one go without overflowing an std::uint64_t.
+    static constexpr int max_shift = 60;
+    // _powtab[n] is the number of bits we shift to scale a number with n digits below one.
+    static constexpr int powtab_size        = 9;
+    static constexpr int _powtab[powtab_size] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+
+    constexpr void _trim() noexcept
+    {
+        while (_count > 0 && _digits[_count - 1] == 0)
+            --_count;
+        if (_count == 0)
+            _point = 0;
+    }
+
+    constexpr void _shift(int k) noexcept
+    {
+        if (_count == 0)
+            return;
+
+        for (; k > max_shift; k -= max_shift)
+            _left_shift(max_shift);
+        if (k > 0)
+            _left_shift(k);
+
+        for (; k < -max_shift; k += max_shift)
+            _right_shift(max_shift);
+        if (k < 0)
+            _right_shift(-k);
+    }
+
+    constexpr void _left_shift(int k) noexcept
+    {
+        // We multiply from the back, writing the digits of the result in reverse order.
+        unsigned char result[max_digits + 20] = {};
+        auto          result_count            = 0;
+
+        std::uint64_t n = 0;
+        for (auto i = _count - 1; i >= 0; --i)
+        {
+            n += std::uint64_t(_digits[i]) << k;
+            result[result_count++] = static_cast<unsigned char>(n % 10);
+            n /= 10;
+        }
+        for (; n > 0; n /= 10)
+            result[result_count++] = static_cast<unsigned char>(n % 10);
+
+        _point += result_count - _count;
+
+        _count = 0;
+        for (auto i = result_count - 1; i >= 0; --i)
+            push_digit(result[i]);
+        _trim();
+    }
+
+    constexpr void _right_shift(int k) noexcept
+    {
+        auto read  = 0;
+        auto write = 0;
+
+        // Pick up enough leading digits to cover the first shift.
+        std::uint64_t n = 0;
+        for (; (n >> k) == 0; ++read)
+        {
+            if (read >= _count)
+            {
+                while ((n >> k) == 0)
+                {
+                    n *= 10;
+                    ++read;
+                }
+                break;
+            }
+            n = n * 10 + _digits[read];
+        }
+        _point -= read - 1;
+
+        // Pick up a digit, put down a digit.
+        auto mask = (std::uint64_t(1) << k) - 1;
+        for (; read < _count; ++read)
+        {
+            _digits[write++] = static_cast<unsigned char>(n >> k);
+            n                = (n & mask) * 10 + _digits[read];
+        }
+
+        // Put down the remaining digits.
+        for (; n > 0; n = (n & mask) * 10)
+        {
+            auto digit = n >> k;
+            if (write < max_digits)
+                _digits[write++] = static_cast<unsigned char>(digit);
+            else if (digit > 0)
+                _truncated = true;
+        }
+
+        _count = write;
+        _trim();
+    }
+
+    constexpr std::uint64_t _rounded_integer() const noexcept
+    {
+        std::uint64_t result = 0;
+
+        auto i = 0;
+        for (; i < _point && i < _count; ++i)
+            result = result * 10 + _digits[i];
+        for (; i < _point; ++i)
+            result *= 10;
+
+        if (_point < 0 || _point >= _count)
+            return result;
+        else if (_digits[_point] == 5 && _point + 1 == _count)
+            // Exactly halfway (unless we've truncated something), round to even.
+            return result + (_truncated || (result & 1) != 0 ? 1 : 0);
+        else
+            return result + (_digits[_point] >= 5 ? 1 : 0);
+    }
+
+    unsigned char _digits[max_digits];
+    int           _count, _point;
+    bool          _truncated;
+};
+
+//=== parsing ===//
+template <typename CharT>
+constexpr unsigned decimal_float_digit(CharT c) noexcept
+{
+    // Everything that isn't a digit is mapped to a value >= 10.
+    return static_cast<unsigned>(c) - unsigned('0');
+}
+
+// Parses digits [. digits] [(e|E) [+|-] digits] in ASCII (or a compatible encoding).
+// It does not validate the format: missing digits are treated as zero.
+template <typename T, typename Iterator>
+constexpr T parse_decimal_float(Iterator begin, Iterator end) noexcept
+{
+    using format = float_format<T>;
+
+    // We read the first 19 significant digits into w, so the number is w * 10^q.
+    constexpr auto max_significant = 19;
+    std::uint64_t  w               = 0;
+    auto           significant     = 0;
+    auto           q               = 0;
+    auto           truncated       = false;
+
+    auto cur = begin;
+    for (; cur != end && decimal_float_digit(*cur) < 10; ++cur)
+    {
+        auto digit = decimal_float_digit(*cur);
+        if (significant == 0 && digit == 0)
+            continue;
+
+        if (significant < max_significant)
+        {
+            w = w * 10 + digit;
+            ++significant;
+        }
+        else
+        {
+            ++q;
+            truncated |= digit != 0;
+        }
+    }
+    auto int_end = cur;
+
+    if (cur != end && *cur == '.')
+    {
+        for (++cur; cur != end && decimal_float_digit(*cur) < 10; ++cur)
+        {
+            auto digit = decimal_float_digit(*cur);
+            if (significant == 0 && digit == 0)
+            {
+                --q;
+                continue;
+            }
+
+            if (significant < max_significant)
+            {
+                w = w * 10 + digit;
+                ++significant;
+                --q;
+            }
+            else
+            {
+                truncated |= digit != 0;
+            }
+        }
+    }
+    auto frac_end = cur;
+
+    // The exponent is clamped; anything that large over- or underflows anyway.
+    constexpr auto max_exponent = 100'000;
+    auto           exponent     = 0;
+    if (cur != end && (*cur == 'e' || *cur == 'E'))
+    {
+        ++cur;
+        auto negative = false;
+        if (cur != end && (*cur == '+' || *cur == '-'))
+        {
+            negative = *cur == '-';
+            ++cur;
+        }
+
+        for (; cur != end && decimal_float_digit(*cur) < 10; ++cur)
+            if (exponent < max_exponent)
+                exponent = exponent * 10 + int(decimal_float_digit(*cur));
+
+        if (negative)
+            exponent = -exponent;
+    }
+    q += exponent;
+
+    if (w == 0)
+        return T(0);
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    // Both w and 10^|q| are exactly representable, so a single operation gives the correctly
+    // rounded result.
+    if (!truncated && w <= format::max_mantissa_fast_path && q >= -format::max_exponent_fast_path
+        && q <= format::max_exponent_fast_path)
+    {
+        if (q < 0)
+            return T(w) / format::exact_powers_of_ten[-q];
+        else
+            return T(w) * format::exact_powers_of_ten[q];
+    }
+#endif
+
+    // The exact value is in [w, w + 1) * 10^q; if both bounds give the same float, we're done.
+    auto am = compute_float<T>(q, w);
+    if (!truncated)
+        return to_float<T>(am);
+    else if (auto upper = compute_float<T>(q, w + 1);
+             am.mantissa == upper.mantissa && am.power2 == upper.power2)
+        return to_float<T>(am);
+
+    // Otherwise, we need to look at all digits.
+    big_decimal decimal;
+    auto        point = 0;
+    for (cur = begin; cur != int_end; ++cur)
+    {
+        auto digit = decimal_float_digit(*cur);
+        if (point == 0 && digit == 0)
+            continue;
+
+        decimal.push_digit(digit);
+        ++point;
+    }
+    auto leading_zero = point == 0;
+    cur = int_end;
+    if (cur != frac_end)
+        // Skip the decimal point.
+        ++cur;
+    for (; cur != frac_end; ++cur)
+    {
+        auto digit = decimal_float_digit(*cur);
+        if (leading_zero && digit == 0)
+        {
+            --point;
+            continue;
+        }
+
+        decimal.push_digit(digit);
+        leading_zero = false;
+    }
+    decimal.set_point(point + exponent);
+
+    return to_float<T>(decimal.to_float<T>());
+}
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_DECIMAL_FLOAT_HPP_INCLUDED
@@ -0,0 +1,140 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_MEMO_TABLE_HPP_INCLUDED
+#define LEXY_DETAIL_MEMO_TABLE_HPP_INCLUDED
+
+#include <cstdint>
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/iterator.hpp>
+#include <new>
+
+namespace lexy::_detail
+{
+// Remembers the result of matching a production at a position: either the marker where it
+// ended, or that it failed.
+// The positions are stored as offsets relative to the position where the table was created;
+// earlier positions are never memoized.
+template <typename Reader>
+class memo_table
+{
+    using iterator = typename Reader::iterator;
+    using marker   = typename Reader::marker;
+    static_assert(is_random_access_iterator<iterator>);
+
+    struct entry
+    {
+        const void* key = nullptr; // nullptr if the slot is empty
+        std::size_t begin;
+        bool        success;
+        marker      end;
+    };
+
+    static constexpr std::size_t initial_capacity = 256;
+
+public:
+    explicit memo_table(iterator begin) noexcept
+    : _begin(begin), _entries(nullptr), _size(0), _capacity(0)
+    {}
+
+    ~memo_table() noexcept
+    {
+        if (_entries != nullptr)
+            ::operator delete(_entries);
+    }
+
+    memo_table(const memo_table&)            = delete;
+    memo_table& operator=(const memo_table&) = delete;
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    // Returns the result of matching key at pos, or nullptr if it hasn't been memoized.
+    const entry* lookup(const void* key, iterator pos) const noexcept
+    {
+        if (_capacity == 0 || pos < _begin)
+            return nullptr;
+
+        auto begin = _offset(pos);
+        auto mask  = _capacity - 1;
+        for (auto slot = _hash(key, begin) & mask; _entries[slot].key != nullptr;
+             slot      = (slot + 1) & mask)
+            if (_entries[slot].key == key && _entries[slot].begin == begin)
+                return _entries + slot;
+
+        return nullptr;
+    }
+
+    // Remembers that key matched at pos until end, or failed.
+    void insert(const void* key, iterator pos, bool success, marker end)
+    {
+        if (pos < _begin)
+            return;
+
+        // We keep the table at most half full.
+        if (2 * (_size + 1) > _capacity)
+            _grow();
+
+        auto begin = _offset(pos);
+        auto mask  = _capacity - 1;
+        auto slot  = _hash(key, begin) & mask;
+        for (; _entries[slot].key != nullptr; slot = (slot + 1) & mask)
+        {
+            if (_entries[slot].key == key && _entries[slot].begin == begin)
+                // A nested parse has already memoized it.
+                return;
+        }
+
+        _entries[slot] = {key, begin, success, end};
+        ++_size;
+    }
+
+private:
+    static std::size_t _hash(const void* key, std::size_t begin) noexcept
+    {
+        auto value = static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(key) >> 3);
+        return value * 31u + begin * 0x9E3779B1u;
+    }
+
+    std::size_t _offset(iterator pos) const noexcept
+    {
+        return static_cast<std::size_t>(pos - _begin);
+    }
+
+    void _grow()
+    {
+        auto old_entries  = _entries;
+        auto old_capacity = _capacity;
+
+        _capacity = _capacity == 0 ? initial_capacity : 2 * _capacity;
+        _entries  = static_cast<entry*>(::operator new(_capacity * sizeof(entry)));
+        for (auto i = std::size_t(0); i != _capacity; ++i)
+            ::new (static_cast<void*>(_entries + i)) entry();
+
+        auto mask = _capacity - 1;
+        for (auto i = std::size_t(0); i != old_capacity; ++i)
+        {
+            auto& e = old_entries[i];
+            if (e.key == nullptr)
+                continue;
+
+            auto slot = _hash(e.key, e.begin) & mask;
+            while (_entries[slot].key != nullptr)
+                slot = (slot + 1) & mask;
+            _entries[slot] = e;
+        }
+
+        if (old_entries != nullptr)
+            ::operator delete(old_entries);
+    }
+
+    iterator    _begin;
+    entry*      _entries;
+    std::size_t _size, _capacity;
+};
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_MEMO_TABLE_HPP_INCLUDED
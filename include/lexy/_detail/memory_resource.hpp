@@ -148,5 +148,71 @@ constexpr MemoryResource* get_memory_resource()
 }
 } // namespace lexy::_detail
 
+namespace lexy::_detail
+{
+// An array of trivially destructible objects allocated from a memory resource.
+// It frees the memory on destruction, but doesn't construct or destroy the objects.
+template <typename T, typename MemoryResource>
+class resource_array
+{
+    using resource_ptr = memory_resource_ptr<MemoryResource>;
+
+public:
+    explicit resource_array(MemoryResource* resource) noexcept
+    : _resource(resource), _data(nullptr), _size(0)
+    {}
+
+    explicit resource_array(std::size_t size, MemoryResource* resource) : resource_array(resource)
+    {
+        if (size > 0)
+        {
+            _data = static_cast<T*>(_resource->allocate(size * sizeof(T), alignof(T)));
+            _size = size;
+        }
+    }
+
+    resource_array(const resource_array&)            = delete;
+    resource_array& operator=(const resource_array&) = delete;
+
+    ~resource_array() noexcept
+    {
+        if (_data != nullptr)
+            _resource->deallocate(_data, _size * sizeof(T), alignof(T));
+    }
+
+    void swap(resource_array& other) noexcept
+    {
+        _detail::swap(_resource, other._resource);
+        _detail::swap(_data, other._data);
+        _detail::swap(_size, other._size);
+    }
+
+    T* data() const noexcept
+    {
+        return _data;
+    }
+    T& operator[](std::size_t idx) const noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _data[idx];
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    MemoryResource* resource() const noexcept
+    {
+        return _resource.get();
+    }
+
+private:
+    LEXY_EMPTY_MEMBER resource_ptr _resource;
+    T*                             _data;
+    std::size_t                    _size;
+};
+} // namespace lexy::_detail
+
 #endif // LEXY_DETAIL_MEMORY_RESOURCE_HPP_INCLUDED
 
@@ -0,0 +1,215 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_STACK_SEGMENT_HPP_INCLUDED
+#define LEXY_DETAIL_STACK_SEGMENT_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstdlib>
+#include <lexy/_detail/config.hpp>
+
+#ifndef LEXY_HAS_STACK_SEGMENTS
+#    if defined(__GLIBC__) && defined(__has_include)
+#        if __has_include(<ucontext.h>)
+#            define LEXY_HAS_STACK_SEGMENTS 1
+#        endif
+#    endif
+#    ifndef LEXY_HAS_STACK_SEGMENTS
+#        define LEXY_HAS_STACK_SEGMENTS 0
+#    endif
+#endif
+
+#if LEXY_HAS_STACK_SEGMENTS
+#    include <exception>
+#    include <new>
+#    include <pthread.h>
+#    include <ucontext.h>
+#endif
+
+namespace lexy::_detail
+{
+// Runs recursive parsing on heap allocated stack segments once the current stack segment is mostly
+// used up, so deeply nested input doesn't overflow the stack of the thread.
+// Without LEXY_HAS_STACK_SEGMENTS, everything runs on the current stack.
+class stack_segments
+{
+public:
+    // The stack of the thread is used until only a reserve of it is left,
+    // independent of how big the segments are.
+    explicit stack_segments(std::size_t size) noexcept
+    : _size(size), _limit(_thread_stack_limit(size)), _free(nullptr)
+    {}
+
+    ~stack_segments() noexcept
+    {
+#if LEXY_HAS_STACK_SEGMENTS
+        while (_free != nullptr)
+        {
+            auto next = *static_cast<void**>(_free);
+            ::operator delete(_free);
+            _free = next;
+        }
+#endif
+    }
+
+    stack_segments(const stack_segments&)            = delete;
+    stack_segments& operator=(const stack_segments&) = delete;
+
+    // Whether the current segment is used up, so the parser should continue on a new one.
+    bool exhausted() const noexcept
+    {
+#if LEXY_HAS_STACK_SEGMENTS
+        return _position() < _limit;
+#else
+        return false;
+#endif
+    }
+
+    // Calls fn() on a new stack segment and returns its result.
+    template <typename Fn>
+    bool call(Fn& fn)
+    {
+#if LEXY_HAS_STACK_SEGMENTS
+        _call_data<Fn> data{&fn, false, nullptr, {}};
+
+        auto stack = _allocate();
+        // We don't need to preserve the signal mask, but getcontext() initializes everything.
+        ucontext_t callee;
+        getcontext(&callee);
+        callee.uc_stack.ss_sp   = stack;
+        callee.uc_stack.ss_size = _size;
+        callee.uc_link          = &data.caller;
+
+        // makecontext() only passes int arguments to the function.
+        auto ptr = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&data));
+        auto lo  = static_cast<int>(static_cast<std::uint32_t>(ptr));
+        auto hi  = static_cast<int>(static_cast<std::uint32_t>(ptr >> 32));
+        makecontext(&callee, reinterpret_cast<void (*)()>(&_trampoline<Fn>), 2, lo, hi);
+
+        // The new segment grows downwards from its end.
+        auto old_limit = _limit;
+        _limit         = reinterpret_cast<std::uintptr_t>(stack) + _reserve(_size);
+        swapcontext(&data.caller, &callee);
+        _limit = old_limit;
+
+        _deallocate(stack);
+        if (data.exception)
+            std::rethrow_exception(data.exception);
+        return data.result;
+#else
+        return fn();
+#endif
+    }
+
+private:
+    // We continue on a new segment once only a quarter of the current one is left.
+    static constexpr std::size_t _reserve(std::size_t size) noexcept
+    {
+        return size / 4;
+    }
+
+    static std::uintptr_t _thread_stack_limit(std::size_t size) noexcept
+    {
+#if LEXY_HAS_STACK_SEGMENTS
+        // Querying the bounds can be expensive (for the main thread, glibc parses
+        // /proc/self/maps), so we only do it once per thread.
+        struct bounds
+        {
+            std::uintptr_t begin, end;
+        };
+        static thread_local bounds stack = [] {
+            pthread_attr_t attr;
+            if (pthread_getattr_np(pthread_self(), &attr) != 0)
+                return bounds{0, 0};
+
+            void*       addr      = nullptr;
+            std::size_t addr_size = 0;
+            auto        failed    = pthread_attr_getstack(&attr, &addr, &addr_size) != 0;
+            pthread_attr_destroy(&attr);
+            if (failed)
+                return bounds{0, 0};
+
+            auto begin = reinterpret_cast<std::uintptr_t>(addr);
+            return bounds{begin, begin + addr_size};
+        }();
+
+        // We might not run on the stack of the thread, e.g. inside a user coroutine.
+        auto position = _position();
+        if (stack.begin < position && position < stack.end)
+        {
+            if (position - stack.begin <= _reserve(size))
+                return position; // Switch immediately.
+            return stack.begin + _reserve(size);
+        }
+#endif
+        // We don't know how big the current stack is, so only allow a reserve worth of growth.
+        return _position() - _reserve(size);
+    }
+
+    static std::uintptr_t _position() noexcept
+    {
+#if LEXY_HAS_STACK_SEGMENTS
+        return reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+#else
+        return std::uintptr_t(-1);
+#endif
+    }
+
+#if LEXY_HAS_STACK_SEGMENTS
+    template <typename Fn>
+    struct _call_data
+    {
+        Fn*                fn;
+        bool               result;
+        std::exception_ptr exception;
+        ucontext_t         caller;
+    };
+
+    template <typename Fn>
+    static void _trampoline(int lo, int hi) noexcept
+    {
+        auto ptr  = static_cast<std::uint64_t>(static_cast<std::uint32_t>(hi)) << 32
+                   | static_cast<std::uint32_t>(lo);
+        auto data = reinterpret_cast<_call_data<Fn>*>(static_cast<std::uintptr_t>(ptr));
+
+        // Exceptions can't leave the segment, so we rethrow them on the original stack.
+#    if defined(__cpp_exceptions)
+        try
+        {
+            data->result = (*data->fn)();
+        }
+        catch (...)
+        {
+            data->exception = std::current_exception();
+        }
+#    else
+        data->result = (*data->fn)();
+#    endif
+        // Returning continues with uc_link, i.e. the caller.
+    }
+
+    void* _allocate()
+    {
+        if (_free == nullptr)
+            return ::operator new(_size);
+
+        auto result = _free;
+        _free       = *static_cast<void**>(_free);
+        return result;
+    }
+
+    void _deallocate(void* stack) noexcept
+    {
+        // We keep the segment for the next time.
+        *static_cast<void**>(stack) = _free;
+        _free                       = stack;
+    }
+#endif
+
+    std::size_t    _size;
+    std::uintptr_t _limit;
+    void*          _free;
+};
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_STACK_SEGMENT_HPP_INCLUDED
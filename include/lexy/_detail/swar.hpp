@@ -8,12 +8,22 @@
 #include <cstdint>
 #include <cstring>
 #include <lexy/_detail/config.hpp>
-#include <lexy/input/base.hpp>
 
 #if defined(_MSC_VER)
 #    include <intrin.h>
 #endif
 
+#if LEXY_ENABLE_SIMD
+#    include <immintrin.h>
+#    if defined(__GNUC__)
+#        define LEXY_SIMD_TARGET_SSSE3 __attribute__((target("ssse3")))
+#        define LEXY_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#    else
+#        define LEXY_SIMD_TARGET_SSSE3
+#        define LEXY_SIMD_TARGET_AVX2
+#    endif
+#endif
+
 namespace lexy::_detail
 {
 // Contains the chars in little endian order; rightmost bits are first char.
@@ -192,6 +202,255 @@ constexpr bool swar_has_char(swar_int v)
 }
 } // namespace lexy::_detail
 
+namespace lexy::_detail
+{
+// The maximal number of bytes that are read at once by the SIMD routines.
+constexpr std::size_t simd_block_size = 32;
+
+enum class simd_level
+{
+    none,
+    sse2,
+    ssse3,
+    avx2,
+};
+
+#if LEXY_ENABLE_SIMD
+inline simd_level _detect_simd_level() noexcept
+{
+#    if defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2"))
+        return simd_level::avx2;
+    else if (__builtin_cpu_supports("ssse3"))
+        return simd_level::ssse3;
+    else
+        return simd_level::sse2;
+#    elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    auto max_leaf = info[0];
+
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 9)) == 0)
+        return simd_level::sse2;
+
+    // We need both AVX support of the CPU and the OS saving the YMM registers.
+    auto has_avx     = (info[2] & (1 << 28)) != 0;
+    auto has_osxsave = (info[2] & (1 << 27)) != 0;
+    if (max_leaf < 7 || !has_avx || !has_osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        return simd_level::ssse3;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0 ? simd_level::avx2 : simd_level::ssse3;
+#    else
+#        error "unsupported compiler; please file an issue"
+#    endif
+}
+#endif
+
+// Returns the SIMD instruction set supported by the CPU.
+inline simd_level get_simd_level() noexcept
+{
+#if LEXY_ENABLE_SIMD
+    static const auto level = _detect_simd_level();
+    return level;
+#else
+    return simd_level::none;
+#endif
+}
+
+// A lookup table that classifies ASCII characters by their nibbles:
+// c is in the set if and only if lo[c & 0xF] & hi[c >> 4] is non-zero.
+// As ASCII characters only have eight different high nibbles, this is exact.
+struct simd_nibble_table
+{
+    unsigned char lo[16];
+    unsigned char hi[16];
+
+    constexpr bool contains(unsigned char c) const noexcept
+    {
+        return (lo[c & 0xF] & hi[c >> 4]) != 0;
+    }
+};
+
+// The chars that stop a SIMD loop: all chars in Cs and, unless Less is zero, all chars less than
+// Less.
+template <typename CharT, CharT Less, CharT... Cs>
+struct simd_stop_chars
+{};
+
+#if LEXY_ENABLE_SIMD
+inline std::size_t _simd_find_first(std::uint32_t mask) noexcept
+{
+#    if defined(__GNUC__)
+    return std::size_t(__builtin_ctz(mask));
+#    elif defined(_MSC_VER)
+    unsigned long bit_idx;
+    _BitScanForward(&bit_idx, mask);
+    return std::size_t(bit_idx);
+#    endif
+}
+
+// Returns a bit mask of all bytes in the 16 byte block that are stop chars.
+template <unsigned char Less, unsigned char... Cs>
+inline std::uint32_t _simd_stop_mask_sse2(const unsigned char* ptr) noexcept
+{
+    auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+
+    auto result = _mm_setzero_si128();
+    ((result = _mm_or_si128(result, _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(Cs))))),
+     ...);
+    if constexpr (Less > 0)
+    {
+        // block < Less if and only if min(block, Less - 1) == block.
+        auto max  = _mm_set1_epi8(static_cast<char>(Less - 1));
+        auto less = _mm_cmpeq_epi8(_mm_min_epu8(block, max), block);
+        result    = _mm_or_si128(result, less);
+    }
+
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(result));
+}
+
+// Returns a bit mask of all bytes in the 32 byte block that are stop chars.
+template <unsigned char Less, unsigned char... Cs>
+LEXY_SIMD_TARGET_AVX2 inline std::uint32_t _simd_stop_mask_avx2(const unsigned char* ptr) noexcept
+{
+    auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+
+    auto result = _mm256_setzero_si256();
+    ((result
+      = _mm256_or_si256(result, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(static_cast<char>(Cs))))),
+     ...);
+    if constexpr (Less > 0)
+    {
+        auto max  = _mm256_set1_epi8(static_cast<char>(Less - 1));
+        auto less = _mm256_cmpeq_epi8(_mm256_min_epu8(block, max), block);
+        result    = _mm256_or_si256(result, less);
+    }
+
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(result));
+}
+
+// The loops stop before a block would extend past end, unless it is nullptr.
+template <unsigned char Less, unsigned char... Cs>
+inline const unsigned char* _simd_find_sse2(const unsigned char* ptr,
+                                            const unsigned char* end) noexcept
+{
+    while (end == nullptr || end - ptr >= 16)
+    {
+        if (auto mask = _simd_stop_mask_sse2<Less, Cs...>(ptr))
+            return ptr + _simd_find_first(mask);
+        ptr += 16;
+    }
+    return ptr;
+}
+template <unsigned char Less, unsigned char... Cs>
+LEXY_SIMD_TARGET_AVX2 inline const unsigned char* _simd_find_avx2(const unsigned char* ptr,
+                                                                  const unsigned char* end) noexcept
+{
+    while (end == nullptr || end - ptr >= 32)
+    {
+        if (auto mask = _simd_stop_mask_avx2<Less, Cs...>(ptr))
+            return ptr + _simd_find_first(mask);
+        ptr += 32;
+    }
+    return ptr;
+}
+
+LEXY_SIMD_TARGET_SSSE3 inline const unsigned char* _simd_skip_set_ssse3(
+    const unsigned char* ptr, const unsigned char* end, const simd_nibble_table& table) noexcept
+{
+    auto lo_table    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.lo));
+    auto hi_table    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.hi));
+    auto nibble_mask = _mm_set1_epi8(0x0F);
+    while (end == nullptr || end - ptr >= 16)
+    {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        auto lo    = _mm_and_si128(block, nibble_mask);
+        auto hi    = _mm_and_si128(_mm_srli_epi16(block, 4), nibble_mask);
+
+        auto bits   = _mm_and_si128(_mm_shuffle_epi8(lo_table, lo), _mm_shuffle_epi8(hi_table, hi));
+        auto result = _mm_cmpeq_epi8(bits, _mm_setzero_si128());
+        if (auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(result)))
+            return ptr + _simd_find_first(mask);
+        ptr += 16;
+    }
+    return ptr;
+}
+LEXY_SIMD_TARGET_AVX2 inline const unsigned char* _simd_skip_set_avx2(
+    const unsigned char* ptr, const unsigned char* end, const simd_nibble_table& table) noexcept
+{
+    auto lo_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.lo)));
+    auto hi_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.hi)));
+    auto nibble_mask = _mm256_set1_epi8(0x0F);
+    while (end == nullptr || end - ptr >= 32)
+    {
+        auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        auto lo    = _mm256_and_si256(block, nibble_mask);
+        auto hi    = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble_mask);
+
+        auto bits   = _mm256_and_si256(_mm256_shuffle_epi8(lo_table, lo),
+                                       _mm256_shuffle_epi8(hi_table, hi));
+        auto result = _mm256_cmpeq_epi8(bits, _mm256_setzero_si256());
+        if (auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(result)))
+            return ptr + _simd_find_first(mask);
+        ptr += 32;
+    }
+    return ptr;
+}
+#endif
+
+// Returns a pointer to the first stop char at or after ptr.
+// If end is not nullptr, it may also return a pointer to any char before that if less than
+// simd_block_size chars remain until end.
+// Requires: if end is nullptr, there is a stop char at most simd_block_size bytes before the end of
+// the memory.
+template <simd_level Level, typename CharT, CharT Less, CharT... Cs>
+const CharT* simd_find(const CharT* ptr, const CharT* end,
+                       simd_stop_chars<CharT, Less, Cs...>) noexcept
+{
+    static_assert(sizeof(CharT) == 1);
+    auto uptr = reinterpret_cast<const unsigned char*>(ptr);
+    auto uend = reinterpret_cast<const unsigned char*>(end);
+#if LEXY_ENABLE_SIMD
+    if constexpr (Level == simd_level::avx2)
+        uptr = _simd_find_avx2<make_uchar(Less), make_uchar(Cs)...>(uptr, uend);
+    else if constexpr (Level != simd_level::none)
+        uptr = _simd_find_sse2<make_uchar(Less), make_uchar(Cs)...>(uptr, uend);
+    else
+#endif
+        while (uptr != uend && !((*uptr == make_uchar(Cs)) || ...) && !(*uptr < make_uchar(Less)))
+            ++uptr;
+    return reinterpret_cast<const CharT*>(uptr);
+}
+
+// Returns a pointer to the first char at or after ptr that is not in the set described by table.
+// If end is not nullptr, it may also return a pointer to any char before that if less than
+// simd_block_size chars remain until end.
+// Requires: if end is nullptr, there is such a char at most simd_block_size bytes before the end of
+// the memory.
+template <simd_level Level, typename CharT>
+const CharT* simd_skip_set(const CharT* ptr, const CharT* end,
+                           const simd_nibble_table& table) noexcept
+{
+    static_assert(sizeof(CharT) == 1);
+    auto uptr = reinterpret_cast<const unsigned char*>(ptr);
+    auto uend = reinterpret_cast<const unsigned char*>(end);
+#if LEXY_ENABLE_SIMD
+    if constexpr (Level == simd_level::avx2)
+        uptr = _simd_skip_set_avx2(uptr, uend, table);
+    else if constexpr (Level == simd_level::ssse3)
+        uptr = _simd_skip_set_ssse3(uptr, uend, table);
+    else
+#endif
+        while (uptr != uend && table.contains(*uptr))
+            ++uptr;
+    return reinterpret_cast<const CharT*>(uptr);
+}
+} // namespace lexy::_detail
+
 namespace lexy::_detail
 {
 struct _swar_base
@@ -199,21 +458,30 @@ struct _swar_base
 template <typename Reader>
 constexpr auto is_swar_reader = std::is_base_of_v<_swar_base, Reader>;
 
+// Derived must provide `swar_end()`, which returns the end of the input,
+// or nullptr if the input is padded with EOF.
 template <typename Derived>
 class swar_reader_base : _swar_base
 {
 public:
-    swar_int peek_swar() const
+    constexpr swar_int peek_swar() const
     {
-        auto ptr = static_cast<const Derived&>(*this).position();
+        using char_type = typename Derived::encoding::char_type;
+        auto ptr        = static_cast<const Derived&>(*this).position();
+        auto end        = static_cast<const Derived&>(*this).swar_end();
+
+        if (end != nullptr && std::size_t(end - ptr) < swar_length<char_type>)
+            // We don't have a full swar_int left, pretend the input is padded.
+            return _peek_swar_partial(ptr, std::size_t(end - ptr));
+        if (LEXY_IS_CONSTANT_EVALUATED())
+            return _peek_swar_partial(ptr, swar_length<char_type>);
 
         swar_int result;
 #if LEXY_IS_LITTLE_ENDIAN
         std::memcpy(&result, ptr, sizeof(swar_int));
 #else
-        using char_type = typename Derived::encoding::char_type;
-        auto dst        = reinterpret_cast<char*>(&result);
-        auto length     = sizeof(swar_int) / sizeof(char_type);
+        auto dst    = reinterpret_cast<char*>(&result);
+        auto length = sizeof(swar_int) / sizeof(char_type);
         for (auto i = 0u; i != length; ++i)
         {
             std::memcpy(dst + i, ptr + length - i - 1, sizeof(char_type));
@@ -222,18 +490,74 @@ public:
         return result;
     }
 
-    void bump_swar()
+    constexpr void bump_swar()
     {
         auto ptr = static_cast<Derived&>(*this).position();
         ptr += swar_length<typename Derived::encoding::char_type>;
         static_cast<Derived&>(*this).reset({ptr});
     }
-    void bump_swar(std::size_t char_count)
+    constexpr void bump_swar(std::size_t char_count)
     {
         auto ptr = static_cast<Derived&>(*this).position();
         ptr += char_count;
         static_cast<Derived&>(*this).reset({ptr});
     }
+
+    // Bumps the reader until the next char is a stop char.
+    // Requires: one of the stop chars is EOF.
+    // It may stop earlier, e.g. if SIMD is not available.
+    template <typename CharT, CharT Less, CharT... Cs>
+    constexpr void bump_simd_until([[maybe_unused]] simd_stop_chars<CharT, Less, Cs...> stop)
+    {
+        if constexpr (LEXY_ENABLE_SIMD && sizeof(CharT) == 1)
+        {
+            if (LEXY_IS_CONSTANT_EVALUATED())
+                return;
+
+            auto ptr = static_cast<Derived&>(*this).position();
+            auto end = static_cast<Derived&>(*this).swar_end();
+            if (get_simd_level() == simd_level::avx2)
+                ptr = simd_find<simd_level::avx2>(ptr, end, stop);
+            else
+                ptr = simd_find<simd_level::sse2>(ptr, end, stop);
+            static_cast<Derived&>(*this).reset({ptr});
+        }
+    }
+
+    // Bumps the reader until the next char is not in the set described by table.
+    // Requires: EOF is not in the set.
+    // It may stop earlier, e.g. if SIMD with shuffles is not available.
+    constexpr void bump_simd_set([[maybe_unused]] const simd_nibble_table& table)
+    {
+        using char_type = typename Derived::encoding::char_type;
+        if constexpr (LEXY_ENABLE_SIMD && sizeof(char_type) == 1)
+        {
+            if (LEXY_IS_CONSTANT_EVALUATED())
+                return;
+
+            auto ptr = static_cast<Derived&>(*this).position();
+            auto end = static_cast<Derived&>(*this).swar_end();
+            if (get_simd_level() == simd_level::avx2)
+                ptr = simd_skip_set<simd_level::avx2>(ptr, end, table);
+            else if (get_simd_level() == simd_level::ssse3)
+                ptr = simd_skip_set<simd_level::ssse3>(ptr, end, table);
+            static_cast<Derived&>(*this).reset({ptr});
+        }
+    }
+
+private:
+    // Packs the first count chars, filling the remaining ones with EOF.
+    template <typename CharT>
+    static constexpr swar_int _peek_swar_partial(const CharT* ptr, std::size_t count)
+    {
+        swar_int result = 0;
+        for (auto i = 0u; i != swar_length<CharT>; ++i)
+        {
+            auto c = i < count ? ptr[i] : static_cast<CharT>(Derived::encoding::eof());
+            result |= swar_int(make_uchar(c)) << (i * char_bit_size<CharT>);
+        }
+        return result;
+    }
 };
 
 constexpr std::size_t round_size_for_swar(std::size_t size_in_bytes)
@@ -241,8 +565,8 @@ constexpr std::size_t round_size_for_swar(std::size_t size_in_bytes)
     // We round up to the next multiple.
     if (auto remainder = size_in_bytes % sizeof(swar_int); remainder > 0)
         size_in_bytes += sizeof(swar_int) - remainder;
-    // Then add one extra space of padding on top.
-    size_in_bytes += sizeof(swar_int);
+    // Then add one extra space of padding on top, which is big enough for a SIMD block.
+    size_in_bytes += simd_block_size;
     return size_in_bytes;
 }
 } // namespace lexy::_detail
@@ -6,6 +6,8 @@
 
 #include <lexy/_detail/config.hpp>
 #include <lexy/_detail/lazy_init.hpp>
+#include <lexy/_detail/memo_table.hpp>
+#include <lexy/_detail/stack_segment.hpp>
 #include <lexy/_detail/type_name.hpp>
 #include <lexy/callback/noop.hpp>
 #include <lexy/dsl/base.hpp>
@@ -16,33 +18,40 @@ namespace lexy
 {
 namespace _detail
 {
+    // The number of slots in the control block that cache context variables.
+    constexpr std::size_t parse_context_var_slot_count = 8;
+
+    // Assigns a slot to each context variable at compile-time, using the hash of its name.
+    constexpr std::size_t parse_context_var_slot(const char* name)
+    {
+        auto hash = std::size_t(2166136261u);
+        for (auto cur = name; *cur; ++cur)
+            hash = (hash ^ static_cast<unsigned char>(*cur)) * 16777619u;
+        return hash % parse_context_var_slot_count;
+    }
+
     struct parse_context_var_base
     {
         const void*             id;
         parse_context_var_base* next;
+        // The variable that previously occupied the slot.
+        parse_context_var_base* shadowed;
 
-        constexpr parse_context_var_base(const void* id) : id(id), next(nullptr) {}
-
-        template <typename Context>
-        constexpr void link(Context& context)
-        {
-            auto cb  = context.control_block;
-            next     = cb->vars;
-            cb->vars = this;
-        }
+        constexpr parse_context_var_base(const void* id) : id(id), next(nullptr), shadowed(nullptr)
+        {}
+    };
 
-        template <typename Context>
-        constexpr void unlink(Context& context)
-        {
-            auto cb  = context.control_block;
-            cb->vars = next;
-        }
+    // The innermost variable of each slot.
+    struct parse_context_var_slots
+    {
+        parse_context_var_base* vars[parse_context_var_slot_count];
     };
 
     template <typename Id, typename T>
     struct parse_context_var : parse_context_var_base
     {
         static constexpr auto type_id = lexy::_detail::type_id<Id>();
+        static constexpr auto slot    = parse_context_var_slot(lexy::_detail::type_name<Id>());
 
         T value;
 
@@ -51,9 +60,34 @@ namespace _detail
           value(LEXY_MOV(value))
         {}
 
+        template <typename Context>
+        constexpr void link(Context& context)
+        {
+            auto cb  = context.control_block;
+            next     = cb->vars;
+            cb->vars = this;
+
+            shadowed                 = cb->var_slots.vars[slot];
+            cb->var_slots.vars[slot] = this;
+        }
+
+        template <typename Context>
+        constexpr void unlink(Context& context)
+        {
+            auto cb                  = context.control_block;
+            cb->vars                 = next;
+            cb->var_slots.vars[slot] = shadowed;
+        }
+
         template <typename ControlBlock>
         static constexpr T& get(const ControlBlock* cb)
         {
+            // As variables are linked and unlinked in stack order, the slot contains the innermost
+            // variable unless another one with the same slot was created later.
+            if (auto var = cb->var_slots.vars[slot];
+                var != nullptr && var->id == static_cast<const void*>(&type_id) /* NOLINT */)
+                return static_cast<parse_context_var*>(var)->value;
+
             for (auto cur = cb->vars; cur; cur = cur->next)
                 if (cur->id == static_cast<const void*>(&type_id) /* NOLINT */)
                     return static_cast<parse_context_var*>(cur)->value;
@@ -73,14 +107,19 @@ namespace _detail
         State*                    parse_state;
 
         parse_context_var_base* vars;
+        parse_context_var_slots var_slots;
+        // The _detail::memo_table of memoized productions, if any.
+        void* memo;
+        // The stack segments used for recursion, if enabled.
+        stack_segments* segments;
 
         int  cur_depth, max_depth;
         bool enable_whitespace_skipping;
 
         constexpr parse_context_control_block(Handler&& handler, State* state,
-                                              std::size_t max_depth)
-        : parse_handler(LEXY_MOV(handler)), parse_state(state), //
-          vars(nullptr),                                        //
+                                              std::size_t max_depth, void* memo = nullptr)
+        : parse_handler(LEXY_MOV(handler)), parse_state(state),      //
+          vars(nullptr), var_slots{}, memo(memo), segments(nullptr), //
           cur_depth(0), max_depth(static_cast<int>(max_depth)), enable_whitespace_skipping(true)
         {}
 
@@ -88,7 +127,8 @@ namespace _detail
         constexpr parse_context_control_block(Handler&& handler,
                                               parse_context_control_block<OtherHandler, State>* cb)
         : parse_handler(LEXY_MOV(handler)), parse_state(cb->parse_state), //
-          vars(cb->vars), cur_depth(cb->cur_depth), max_depth(cb->max_depth),
+          vars(cb->vars), var_slots(cb->var_slots), memo(cb->memo), segments(cb->segments),
+          cur_depth(cb->cur_depth), max_depth(cb->max_depth),
           enable_whitespace_skipping(cb->enable_whitespace_skipping)
         {}
 
@@ -96,6 +136,9 @@ namespace _detail
         constexpr void copy_vars_from(parse_context_control_block<OtherHandler, State>* cb)
         {
             vars                       = cb->vars;
+            var_slots                  = cb->var_slots;
+            memo                       = cb->memo;
+            segments                   = cb->segments;
             cur_depth                  = cb->cur_depth;
             max_depth                  = cb->max_depth;
             enable_whitespace_skipping = cb->enable_whitespace_skipping;
@@ -113,6 +156,40 @@ template <typename Handler, typename State, typename Production>
 using _production_value_type =
     typename Handler::template value_callback<Production, State>::return_type;
 
+// Whether the handler wants to reuse productions of a previous parse, see
+// `parse_events::production_reuse`.
+template <typename Handler, typename = void>
+constexpr bool _handler_reuses_productions = false;
+template <typename Handler>
+constexpr bool
+    _handler_reuses_productions<Handler, std::enable_if_t<Handler::reuses_productions>> = true;
+
+// A previous parse of a production, or its memoized result, can only be reused if the input alone
+// determines how it is parsed: context variables and disabled whitespace skipping are not known to
+// the handler or the memo table.
+template <typename Context>
+constexpr bool _can_reuse_production(const Context& context)
+{
+    return context.control_block->vars == nullptr
+           && context.control_block->enable_whitespace_skipping;
+}
+
+// Whether the handler only matches, so the result of a production only depends on the position,
+// see `lexy::memoized_production`.
+template <typename Handler, typename = void>
+constexpr bool _handler_memoizes_productions = false;
+template <typename Handler>
+constexpr bool
+    _handler_memoizes_productions<Handler, std::enable_if_t<Handler::memoizes_productions>> = true;
+
+// Whether the handler needs to see every branch of a choice tried in order,
+// so a choice must not skip branches by looking at the next code unit.
+template <typename Handler, typename = void>
+constexpr bool _handler_tries_all_branches = false;
+template <typename Handler>
+constexpr bool
+    _handler_tries_all_branches<Handler, std::enable_if_t<Handler::tries_all_branches>> = true;
+
 template <typename Handler, typename State, typename Production,
           typename WhitespaceProduction = _whitespace_production_of<Production>>
 struct _pc
@@ -226,12 +303,12 @@ constexpr auto _do_action(_pc<Handler, State, Production>& context, Reader& read
 
 template <typename Production, template <typename> typename Result, typename Handler,
           typename State, typename Reader>
-constexpr auto do_action(Handler&& handler, State* state, Reader& reader)
+constexpr auto _do_action_cb(Handler&& handler, State* state, Reader& reader, void* memo,
+                             _detail::stack_segments* segments)
 {
-    static_assert(!std::is_reference_v<Handler>, "need to move handler in");
-
     _detail::parse_context_control_block control_block(LEXY_MOV(handler), state,
-                                                       max_recursion_depth<Production>());
+                                                       max_recursion_depth<Production>(), memo);
+    control_block.segments = segments;
     _pc<Handler, State, Production>      context(&control_block);
 
     auto rule_result = _do_action(context, reader);
@@ -246,6 +323,43 @@ constexpr auto do_action(Handler&& handler, State* state, Reader& reader)
         return LEXY_MOV(control_block.parse_handler)
             .template get_result<Result<value_type>>(rule_result);
 }
+
+template <typename Production, template <typename> typename Result, typename Handler,
+          typename State, typename Reader>
+constexpr auto _do_action_segments(Handler&& handler, State* state, Reader& reader, void* memo)
+{
+    if constexpr (lexy::stack_segment_size<Production>() > 0)
+    {
+        _detail::stack_segments segments(lexy::stack_segment_size<Production>());
+        return _do_action_cb<Production, Result>(LEXY_MOV(handler), state, reader, memo,
+                                                 &segments);
+    }
+    else
+    {
+        return _do_action_cb<Production, Result>(LEXY_MOV(handler), state, reader, memo, nullptr);
+    }
+}
+
+template <typename Production, template <typename> typename Result, typename Handler,
+          typename State, typename Reader>
+constexpr auto do_action(Handler&& handler, State* state, Reader& reader, void* memo = nullptr)
+{
+    static_assert(!std::is_reference_v<Handler>, "need to move handler in");
+
+    if constexpr (lexy::is_memoized_production<Production>
+                  && _detail::is_random_access_iterator<typename Reader::iterator>)
+    {
+        if (memo == nullptr)
+        {
+            // The table of memoized productions is kept until the end of the parse.
+            _detail::memo_table<Reader> table(reader.position());
+            return _do_action_segments<Production, Result>(LEXY_MOV(handler), state, reader,
+                                                           &table);
+        }
+    }
+
+    return _do_action_segments<Production, Result>(LEXY_MOV(handler), state, reader, memo);
+}
 } // namespace lexy
 
 //=== value callback ===//
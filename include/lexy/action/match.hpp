@@ -11,6 +11,9 @@ namespace lexy
 class _mh
 {
 public:
+    // The result of a production only depends on its position.
+    static constexpr bool memoizes_productions = true;
+
     constexpr _mh() : _failed(false) {}
 
     class event_handler
@@ -40,6 +43,11 @@ public:
         return rule_parse_result && !_failed;
     }
 
+    constexpr bool _has_failed() const
+    {
+        return _failed;
+    }
+
 private:
     bool _failed;
 };
@@ -11,14 +11,53 @@
 
 namespace lexy
 {
-template <typename Tree, typename Reader>
+/// Token filter for `parse_as_tree` that keeps all tokens.
+struct keep_all_tokens
+{
+    template <typename TokenKind>
+    static constexpr bool keep(token_kind<TokenKind>) noexcept
+    {
+        return true;
+    }
+};
+
+/// Token filter for `parse_as_tree` that keeps only tokens of the specified kinds.
+template <auto... Kinds>
+struct keep_tokens
+{
+    template <typename TokenKind>
+    static constexpr bool keep(token_kind<TokenKind> kind) noexcept
+    {
+        return ((kind == token_kind<TokenKind>(Kinds)) || ...);
+    }
+};
+
+/// Token filter for `parse_as_tree` that drops tokens of the specified kinds.
+template <auto... Kinds>
+struct drop_tokens
+{
+    template <typename TokenKind>
+    static constexpr bool keep(token_kind<TokenKind> kind) noexcept
+    {
+        return ((kind != token_kind<TokenKind>(Kinds)) && ...);
+    }
+};
+
+template <typename Tree, typename Reader, typename TokenFilter = keep_all_tokens>
 class _pth
 {
+    // Trees that can reuse productions of a previous parse need to know what the parser has looked
+    // at and where productions begin and end.
+    static constexpr bool _incremental = _handler_reuses_productions<typename Tree::builder>;
+
 public:
+    static constexpr bool reuses_productions = _incremental;
+
     template <typename Input, typename Sink>
     explicit _pth(Tree& tree, const _detail::any_holder<const Input*>& input,
                   _detail::any_holder<Sink>& sink)
-    : _tree(&tree), _depth(0), _validate(input, sink)
+    : _tree(&tree), _depth(0), _dropped_end(), _last_token_dropped(false),
+      _after_production(false), _validate(input, sink)
     {}
 
     class event_handler
@@ -28,11 +67,16 @@ public:
     public:
         event_handler(production_info info) : _validate(info) {}
 
-        void on(_pth& handler, parse_events::grammar_start, iterator)
+        void on(_pth& handler, parse_events::grammar_start, iterator begin)
         {
             LEXY_PRECONDITION(handler._depth == 0);
 
-            handler._builder.emplace(LEXY_MOV(*handler._tree), _validate.get_info());
+            // Trees that store positions relative to the input need its beginning.
+            using builder = typename Tree::builder;
+            if constexpr (std::is_constructible_v<builder, Tree&&, production_info, iterator>)
+                handler._builder.emplace(LEXY_MOV(*handler._tree), _validate.get_info(), begin);
+            else
+                handler._builder.emplace(LEXY_MOV(*handler._tree), _validate.get_info());
         }
         void on(_pth& handler, parse_events::grammar_finish, Reader& reader)
         {
@@ -53,8 +97,17 @@ public:
 
         void on(_pth& handler, parse_events::production_start ev, iterator pos)
         {
+            // A token dropped before the production is not part of it.
+            handler._last_token_dropped = false;
+            handler._after_production   = false;
+
             if (handler._depth++ > 0)
-                _marker = handler._builder->start_production(_validate.get_info());
+            {
+                if constexpr (_incremental)
+                    _marker = handler._builder->start_production(_validate.get_info(), pos);
+                else
+                    _marker = handler._builder->start_production(_validate.get_info());
+            }
 
             _validate.on(handler._validate, ev, pos);
         }
@@ -66,7 +119,18 @@ public:
                 if (handler._builder->current_child_count() == 0)
                     handler._builder->token(lexy::position_token_kind, _validate.production_begin(),
                                             _validate.production_begin());
-                handler._builder->finish_production(LEXY_MOV(_marker));
+                // Likewise, the production still needs to end after a dropped last token.
+                if (handler._last_token_dropped)
+                {
+                    handler._builder->token(lexy::position_token_kind, handler._dropped_end,
+                                            handler._dropped_end);
+                    handler._last_token_dropped = false;
+                }
+                if constexpr (_incremental)
+                    handler._builder->finish_production(LEXY_MOV(_marker), pos);
+                else
+                    handler._builder->finish_production(LEXY_MOV(_marker));
+                handler._after_production = true;
             }
 
             _validate.on(handler._validate, ev, pos);
@@ -81,11 +145,18 @@ public:
                 // as an error token.
                 handler._builder->cancel_production(LEXY_MOV(_marker));
                 handler._builder->token(lexy::error_token_kind, _validate.production_begin(), pos);
+                handler._last_token_dropped = false;
+                handler._after_production   = false;
             }
 
             _validate.on(handler._validate, ev, pos);
         }
 
+        bool on(_pth& handler, parse_events::production_reuse, Reader& reader)
+        {
+            return handler._builder->reuse(_validate.get_info(), reader);
+        }
+
         auto on(_pth& handler, lexy::parse_events::operation_chain_start, iterator)
         {
             // As we don't know the production yet (or whether it is actually an operation),
@@ -109,12 +180,51 @@ public:
         template <typename TokenKind>
         void on(_pth& handler, parse_events::token, TokenKind kind, iterator begin, iterator end)
         {
+            using tree_token_kind
+                = token_kind<typename _parse_tree_traits<Tree>::token_kind>;
+            if (!TokenFilter::keep(tree_token_kind(kind)))
+            {
+                // The production still needs to begin at the dropped token, and a production
+                // before it still needs to end there.
+                // An empty token does not cover any input, so it can be dropped entirely.
+                if (begin != end)
+                {
+                    if (handler._builder->current_child_count() == 0 || handler._after_production)
+                    {
+                        handler._builder->token(lexy::position_token_kind, begin, begin);
+                        handler._after_production = false;
+                    }
+                    handler._dropped_end        = end;
+                    handler._last_token_dropped = true;
+                }
+                return;
+            }
+
             handler._builder->token(kind, begin, end);
+            handler._last_token_dropped = false;
+            handler._after_production   = false;
+        }
+        void on(_pth& handler, parse_events::backtracked ev, iterator begin, iterator end)
+        {
+            if constexpr (_incremental)
+                handler._builder->lookahead(end);
+
+            _validate.on(handler._validate, ev, begin, end);
+        }
+        void on(_pth& handler, parse_events::lookahead ev, iterator pos)
+        {
+            if constexpr (_incremental)
+                handler._builder->lookahead(pos);
+
+            _validate.on(handler._validate, ev, pos);
         }
 
         template <typename Error>
         void on(_pth& handler, parse_events::error ev, Error&& error)
         {
+            if constexpr (_incremental)
+                handler._builder->error(error.position());
+
             _validate.on(handler._validate, ev, LEXY_FWD(error));
         }
 
@@ -144,20 +254,28 @@ private:
     Tree*                                            _tree;
     int                                              _depth;
 
+    // The end of the last token, if it was dropped by the filter,
+    // and whether the last child of the current production is a production.
+    typename Reader::iterator _dropped_end;
+    bool                      _last_token_dropped;
+    bool                      _after_production;
+
     _vh<Reader> _validate;
 };
 
 template <typename State, typename Input, typename ErrorCallback, typename TokenKind = void,
-          typename MemoryResource = void>
+          typename MemoryResource = void,
+          typename Tree        = lexy::parse_tree_for<Input, TokenKind, MemoryResource>,
+          typename TokenFilter = keep_all_tokens>
 struct parse_as_tree_action
 {
-    using tree_type = lexy::parse_tree_for<Input, TokenKind, MemoryResource>;
+    using tree_type = Tree;
 
     tree_type*           _tree;
     const ErrorCallback* _callback;
     State*               _state = nullptr;
 
-    using handler = _pth<tree_type, lexy::input_reader<Input>>;
+    using handler = _pth<tree_type, lexy::input_reader<Input>, TokenFilter>;
     using state   = State;
     using input   = Input;
 
@@ -184,32 +302,43 @@ struct parse_as_tree_action
     }
 };
 
-template <typename Production, typename TokenKind, typename MemoryResource, typename Input,
-          typename ErrorCallback>
-auto parse_as_tree(parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>& tree,
-                   const Input&                                                      input,
-                   const ErrorCallback& callback) -> validate_result<ErrorCallback>
+// Only trees for the reader of the input are accepted.
+template <typename Tree, typename Input, typename ErrorCallback>
+using _parse_as_tree_result = std::enable_if_t<
+    std::is_same_v<typename _parse_tree_traits<Tree>::reader, lexy::input_reader<Input>>,
+    validate_result<ErrorCallback>>;
+
+template <typename State, typename Input, typename ErrorCallback, typename Tree,
+          typename TokenFilter>
+using _parse_as_tree_action_for
+    = parse_as_tree_action<State, Input, ErrorCallback,
+                           typename _parse_tree_traits<Tree>::token_kind,
+                           typename _parse_tree_traits<Tree>::memory_resource, Tree, TokenFilter>;
+
+template <typename Production, typename TokenFilter = keep_all_tokens, typename Tree,
+          typename Input, typename ErrorCallback>
+auto parse_as_tree(Tree& tree, const Input& input, const ErrorCallback& callback)
+    -> _parse_as_tree_result<Tree, Input, ErrorCallback>
 {
-    return parse_as_tree_action<void, Input, ErrorCallback, TokenKind,
-                                MemoryResource>(tree, callback)(Production{}, input);
+    return _parse_as_tree_action_for<void, Input, ErrorCallback, Tree, TokenFilter>(tree, callback)(
+        Production{}, input);
 }
-template <typename Production, typename TokenKind, typename MemoryResource, typename Input,
-          typename State, typename ErrorCallback>
-auto parse_as_tree(parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>& tree,
-                   const Input& input, State& state,
-                   const ErrorCallback& callback) -> validate_result<ErrorCallback>
+template <typename Production, typename TokenFilter = keep_all_tokens, typename Tree,
+          typename Input, typename State, typename ErrorCallback>
+auto parse_as_tree(Tree& tree, const Input& input, State& state, const ErrorCallback& callback)
+    -> _parse_as_tree_result<Tree, Input, ErrorCallback>
 {
-    return parse_as_tree_action<State, Input, ErrorCallback, TokenKind,
-                                MemoryResource>(state, tree, callback)(Production{}, input);
+    return _parse_as_tree_action_for<State, Input, ErrorCallback, Tree,
+                                     TokenFilter>(state, tree, callback)(Production{}, input);
 }
-template <typename Production, typename TokenKind, typename MemoryResource, typename Input,
-          typename State, typename ErrorCallback>
-auto parse_as_tree(parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>& tree,
-                   const Input& input, const State& state,
-                   const ErrorCallback& callback) -> validate_result<ErrorCallback>
+template <typename Production, typename TokenFilter = keep_all_tokens, typename Tree,
+          typename Input, typename State, typename ErrorCallback>
+auto parse_as_tree(Tree& tree, const Input& input, const State& state,
+                   const ErrorCallback& callback)
+    -> _parse_as_tree_result<Tree, Input, ErrorCallback>
 {
-    return parse_as_tree_action<const State, Input, ErrorCallback, TokenKind,
-                                MemoryResource>(state, tree, callback)(Production{}, input);
+    return _parse_as_tree_action_for<const State, Input, ErrorCallback, Tree,
+                                     TokenFilter>(state, tree, callback)(Production{}, input);
 }
 } // namespace lexy
 
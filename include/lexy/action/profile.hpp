@@ -0,0 +1,508 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_ACTION_PROFILE_HPP_INCLUDED
+#define LEXY_ACTION_PROFILE_HPP_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/action/base.hpp>
+
+//=== profile_report ===//
+namespace lexy
+{
+/// The statistics of a single production collected by `lexy::profile()`.
+struct profile_entry
+{
+    production_info production;
+
+    /// How often the production was started, and how often it then succeeded or failed.
+    std::size_t entry_count;
+    std::size_t success_count;
+    std::size_t failure_count;
+
+    /// The time spent parsing the production, with and without its child productions.
+    /// Nested calls of a recursive production only count once in the total time.
+    std::chrono::nanoseconds total_time;
+    std::chrono::nanoseconds self_time;
+
+    /// The number of code units consumed by successful parses.
+    std::size_t consumed;
+
+    /// How often the input was rewound while parsing the production, or because the production
+    /// was a branch condition that didn't match, and how many code units were examined again.
+    std::size_t backtrack_count;
+    std::size_t rescanned;
+
+    // The number of calls that haven't finished yet.
+    std::size_t _active;
+};
+
+template <typename MemoryResource = void>
+class profile_report
+{
+    using resource_ptr = _detail::memory_resource_ptr<MemoryResource>;
+
+public:
+    //=== construction ===//
+    constexpr profile_report() : profile_report(_detail::get_memory_resource<MemoryResource>()) {}
+    constexpr explicit profile_report(MemoryResource* resource)
+    : _resource(resource), _entries(nullptr), _size(0), _capacity(0), _index(nullptr),
+      _index_capacity(0), _input_size(0)
+    {}
+
+    profile_report(profile_report&& other) noexcept
+    : _resource(other._resource), _entries(other._entries), _size(other._size),
+      _capacity(other._capacity), _index(other._index), _index_capacity(other._index_capacity),
+      _input_size(other._input_size)
+    {
+        other._entries        = nullptr;
+        other._size           = 0;
+        other._capacity       = 0;
+        other._index          = nullptr;
+        other._index_capacity = 0;
+        other._input_size     = 0;
+    }
+
+    ~profile_report() noexcept
+    {
+        if (_entries != nullptr)
+            _resource->deallocate(_entries, _capacity * sizeof(profile_entry),
+                                  alignof(profile_entry));
+        if (_index != nullptr)
+            _resource->deallocate(_index, _index_capacity * sizeof(std::uint_least32_t),
+                                  alignof(std::uint_least32_t));
+    }
+
+    profile_report& operator=(profile_report&& other) noexcept
+    {
+        lexy::_detail::swap(_resource, other._resource);
+        lexy::_detail::swap(_entries, other._entries);
+        lexy::_detail::swap(_size, other._size);
+        lexy::_detail::swap(_capacity, other._capacity);
+        lexy::_detail::swap(_index, other._index);
+        lexy::_detail::swap(_index_capacity, other._index_capacity);
+        lexy::_detail::swap(_input_size, other._input_size);
+        return *this;
+    }
+
+    //=== access ===//
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    using iterator = const profile_entry*;
+
+    iterator begin() const noexcept
+    {
+        return _entries;
+    }
+    iterator end() const noexcept
+    {
+        return _entries + _size;
+    }
+
+    /// Returns the entry of the production, or `nullptr` if it hasn't been parsed.
+    const profile_entry* find(production_info production) const noexcept
+    {
+        auto idx = _find(production.id);
+        return idx == _size ? nullptr : _entries + idx;
+    }
+
+    //=== backtracking ===//
+    /// The number of code units that have been parsed, summed over all inputs.
+    std::size_t input_size() const noexcept
+    {
+        return _input_size;
+    }
+
+    /// The number of code units that have been examined again after backtracking.
+    std::size_t rescanned() const noexcept
+    {
+        auto result = std::size_t(0);
+        for (auto& entry : *this)
+            result += entry.rescanned;
+        return result;
+    }
+
+    /// The number of code units examined per code unit of the input.
+    /// It is `1` if the parser never backtracked.
+    double amplification() const noexcept
+    {
+        if (_input_size == 0)
+            return 1;
+        return double(_input_size + rescanned()) / double(_input_size);
+    }
+
+    //=== modifiers ===//
+    /// Sorts the entries, e.g. to put the productions with the highest self time first.
+    template <typename Compare>
+    void sort(Compare comp)
+    {
+        // There are only a few productions, so insertion sort is good enough.
+        for (auto i = std::size_t(1); i < _size; ++i)
+        {
+            auto entry = _entries[i];
+
+            auto j = i;
+            for (; j > 0 && comp(entry, _entries[j - 1]); --j)
+                _entries[j] = _entries[j - 1];
+            _entries[j] = entry;
+        }
+
+        if (_index != nullptr)
+            _rehash(_index_capacity);
+    }
+
+    /// Removes all entries, but keeps the memory for the next use.
+    void clear() noexcept
+    {
+        _size       = 0;
+        _input_size = 0;
+        if (_index != nullptr)
+            std::memset(static_cast<void*>(_index), 0,
+                        _index_capacity * sizeof(std::uint_least32_t));
+    }
+
+    //=== profiling ===//
+    // Returns the index of the production's entry, creating a new one if necessary.
+    std::size_t _start(production_info production)
+    {
+        auto idx = _find(production.id);
+        if (idx == _size)
+            _insert(production);
+
+        auto& entry = _entries[idx];
+        ++entry.entry_count;
+        ++entry._active;
+        return idx;
+    }
+
+    profile_entry& _entry(std::size_t idx) noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _entries[idx];
+    }
+
+    void _finish_input(std::size_t size) noexcept
+    {
+        _input_size += size;
+    }
+
+private:
+    static std::size_t _hash(const char* const* id) noexcept
+    {
+        // The ids are addresses of distinct global variables.
+        auto value = reinterpret_cast<std::uintptr_t>(id);
+        return static_cast<std::size_t>(value ^ (value >> 4) ^ (value >> 12));
+    }
+
+    std::size_t _find(const char* const* id) const noexcept
+    {
+        if (_index_capacity == 0)
+            return _size;
+
+        // _index stores the entry index + 1, or 0 if the slot is empty.
+        auto mask = _index_capacity - 1;
+        for (auto slot = _hash(id) & mask; _index[slot] != 0; slot = (slot + 1) & mask)
+        {
+            auto idx = std::size_t(_index[slot] - 1);
+            if (_entries[idx].production.id == id)
+                return idx;
+        }
+
+        return _size;
+    }
+
+    void _insert(production_info production)
+    {
+        if (_size == _capacity)
+        {
+            auto new_capacity = _capacity == 0 ? std::size_t(64) : 2 * _capacity;
+            auto memory
+                = _resource->allocate(new_capacity * sizeof(profile_entry), alignof(profile_entry));
+            if (_entries != nullptr)
+            {
+                std::memcpy(memory, static_cast<void*>(_entries), _size * sizeof(profile_entry));
+                _resource->deallocate(_entries, _capacity * sizeof(profile_entry),
+                                      alignof(profile_entry));
+            }
+
+            _entries  = static_cast<profile_entry*>(memory);
+            _capacity = new_capacity;
+        }
+
+        ::new (static_cast<void*>(_entries + _size))
+            profile_entry{production, 0, 0, 0, {}, {}, 0, 0, 0, 0};
+        ++_size;
+
+        // We keep the index at most half full.
+        if (2 * _size > _index_capacity)
+            _rehash(_index_capacity == 0 ? std::size_t(128) : 2 * _index_capacity);
+        else
+            _index_insert(_size - 1);
+    }
+
+    void _rehash(std::size_t new_capacity)
+    {
+        if (new_capacity != _index_capacity)
+        {
+            auto memory = _resource->allocate(new_capacity * sizeof(std::uint_least32_t),
+                                              alignof(std::uint_least32_t));
+            if (_index != nullptr)
+                _resource->deallocate(_index, _index_capacity * sizeof(std::uint_least32_t),
+                                      alignof(std::uint_least32_t));
+
+            _index          = static_cast<std::uint_least32_t*>(memory);
+            _index_capacity = new_capacity;
+        }
+
+        std::memset(static_cast<void*>(_index), 0, _index_capacity * sizeof(std::uint_least32_t));
+        for (auto idx = std::size_t(0); idx != _size; ++idx)
+            _index_insert(idx);
+    }
+
+    void _index_insert(std::size_t idx) noexcept
+    {
+        auto mask = _index_capacity - 1;
+        auto slot = _hash(_entries[idx].production.id) & mask;
+        while (_index[slot] != 0)
+            slot = (slot + 1) & mask;
+        _index[slot] = std::uint_least32_t(idx + 1);
+    }
+
+    LEXY_EMPTY_MEMBER resource_ptr _resource;
+    profile_entry*                 _entries;
+    std::size_t                    _size, _capacity;
+    std::uint_least32_t*           _index;
+    std::size_t                    _index_capacity;
+    std::size_t                    _input_size;
+};
+} // namespace lexy
+
+//=== profile action ===//
+namespace lexy
+{
+// Only matches the input like `lexy::match()`: producing values would measure the time of the
+// callbacks instead of the grammar, and errors only determine the result, as the statistics are
+// collected either way.
+// The events don't say which rule has sent them, so everything is attributed to the innermost
+// production, which is the unit users can act on.
+template <typename Report, typename Reader>
+class _pfh
+{
+    using clock    = std::chrono::steady_clock;
+    using iterator = typename Reader::iterator;
+
+public:
+    explicit _pfh(Report& report)
+    : _report(&report), _current(nullptr), _input_begin(), _pos(), _error_count(0)
+    {}
+
+    class event_handler
+    {
+    public:
+        event_handler(production_info info)
+        : _info(info), _entry(0), _begin(), _error_count(0), _parent(nullptr), _start(),
+          _child_time(0)
+        {}
+
+        void on(_pfh& handler, parse_events::grammar_start, iterator begin)
+        {
+            handler._input_begin = begin;
+            handler._pos         = begin;
+        }
+        void on(_pfh& handler, parse_events::grammar_finish, Reader& reader)
+        {
+            handler._finish_input(reader.position());
+        }
+        void on(_pfh& handler, parse_events::grammar_cancel, Reader& reader)
+        {
+            handler._finish_input(reader.position());
+        }
+
+        void on(_pfh& handler, parse_events::production_start, iterator pos)
+        {
+            _entry       = handler._report->_start(_info);
+            _begin       = pos;
+            _error_count = handler._error_count;
+            _parent      = handler._current;
+
+            handler._pos     = pos;
+            handler._current = this;
+            _start           = clock::now();
+        }
+        void on(_pfh& handler, parse_events::production_finish, iterator pos)
+        {
+            auto& entry = _finish(handler);
+            ++entry.success_count;
+            entry.consumed += _detail::range_size(_begin, pos);
+
+            handler._pos = pos;
+        }
+        void on(_pfh& handler, parse_events::production_cancel, iterator pos)
+        {
+            auto& entry = _finish(handler);
+            ++entry.failure_count;
+
+            // A production can only fail without raising an error if it was a branch condition,
+            // in which case the reader is reset to the beginning of the production.
+            if (handler._error_count == _error_count)
+            {
+                _backtrack(entry, _detail::range_size(_begin, pos));
+                handler._pos = _begin;
+            }
+            else
+            {
+                handler._pos = pos;
+            }
+        }
+
+        template <typename TokenKind>
+        void on(_pfh& handler, parse_events::token, TokenKind, iterator, iterator end)
+        {
+            handler._pos = end;
+        }
+        void on(_pfh& handler, parse_events::backtracked, iterator begin, iterator end)
+        {
+            _backtrack(handler._report->_entry(_entry), _detail::range_size(begin, end));
+            handler._pos = begin;
+        }
+        void on(_pfh& handler, parse_events::lookahead, iterator pos)
+        {
+            // Everything between the current position and pos has been examined without
+            // consuming it.
+            // A lookahead at the current position only peeked at the next code unit, e.g. to
+            // select the branch of a choice or to check for EOF; that isn't a backtrack.
+            if (pos == handler._pos || !_detail::precedes(handler._pos, pos))
+                return;
+
+            _backtrack(handler._report->_entry(_entry), _detail::range_size(handler._pos, pos));
+        }
+
+        template <typename Error>
+        void on(_pfh& handler, parse_events::error, Error&&)
+        {
+            ++handler._error_count;
+        }
+
+        template <typename Event, typename... Args>
+        int on(_pfh&, Event, const Args&...)
+        {
+            return 0; // operation_chain_start needs to return something
+        }
+
+    private:
+        profile_entry& _finish(_pfh& handler)
+        {
+            auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - _start);
+
+            // The entry needs to be looked up again, as productions might have been added.
+            auto& entry = handler._report->_entry(_entry);
+            --entry._active;
+            if (entry._active == 0)
+                entry.total_time += time;
+            entry.self_time += time - _child_time;
+
+            if (_parent != nullptr)
+                _parent->_child_time += time;
+            handler._current = _parent;
+
+            return entry;
+        }
+
+        static void _backtrack(profile_entry& entry, std::size_t size)
+        {
+            if (size == 0)
+                return;
+
+            ++entry.backtrack_count;
+            entry.rescanned += size;
+        }
+
+        production_info          _info;
+        std::size_t              _entry;
+        iterator                 _begin;
+        std::size_t              _error_count;
+        event_handler*           _parent;
+        clock::time_point        _start;
+        std::chrono::nanoseconds _child_time;
+    };
+
+    template <typename Production, typename State>
+    using value_callback = _detail::void_value_callback;
+
+    template <typename>
+    constexpr bool get_result(bool rule_parse_result) &&
+    {
+        return rule_parse_result && _error_count == 0;
+    }
+
+private:
+    void _finish_input(iterator end)
+    {
+        _report->_finish_input(_detail::range_size(_input_begin, end));
+    }
+
+    Report*        _report;
+    event_handler* _current;
+    iterator       _input_begin, _pos;
+    std::size_t    _error_count;
+};
+
+template <typename State, typename Input, typename MemoryResource = void>
+struct profile_action
+{
+    using report_type = profile_report<MemoryResource>;
+
+    report_type* _report;
+    State*       _state = nullptr;
+
+    using handler = _pfh<report_type, lexy::input_reader<Input>>;
+    using state   = State;
+    using input   = Input;
+
+    template <typename>
+    using result_type = bool;
+
+    constexpr explicit profile_action(report_type& report) : _report(&report) {}
+    template <typename U = State>
+    constexpr explicit profile_action(U& state, report_type& report)
+    : _report(&report), _state(&state)
+    {}
+
+    template <typename Production>
+    constexpr auto operator()(Production, const Input& input) const
+    {
+        auto reader = input.reader();
+        return lexy::do_action<Production, result_type>(handler(*_report), _state, reader);
+    }
+};
+
+template <typename Production, typename MemoryResource, typename Input>
+bool profile(profile_report<MemoryResource>& report, const Input& input)
+{
+    return profile_action<void, Input, MemoryResource>(report)(Production{}, input);
+}
+template <typename Production, typename MemoryResource, typename Input, typename State>
+bool profile(profile_report<MemoryResource>& report, const Input& input, State& state)
+{
+    return profile_action<State, Input, MemoryResource>(state, report)(Production{}, input);
+}
+template <typename Production, typename MemoryResource, typename Input, typename State>
+bool profile(profile_report<MemoryResource>& report, const Input& input, const State& state)
+{
+    return profile_action<const State, Input, MemoryResource>(state, report)(Production{}, input);
+}
+} // namespace lexy
+
+#endif // LEXY_ACTION_PROFILE_HPP_INCLUDED
@@ -0,0 +1,161 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_ACTION_TOKENIZE_HPP_INCLUDED
+#define LEXY_ACTION_TOKENIZE_HPP_INCLUDED
+
+#include <lexy/action/base.hpp>
+#include <lexy/action/validate.hpp>
+#include <lexy/dsl/any.hpp>
+#include <lexy/token_stream.hpp>
+
+namespace lexy
+{
+template <typename Stream, typename Reader>
+class _tkh
+{
+public:
+    template <typename Input, typename Sink>
+    explicit _tkh(Stream& stream, const _detail::any_holder<const Input*>& input,
+                  _detail::any_holder<Sink>& sink)
+    : _stream(&stream), _validate(input, sink)
+    {}
+
+    class event_handler
+    {
+        using iterator = typename Reader::iterator;
+
+    public:
+        event_handler(production_info info) : _validate(info), _first_token(0) {}
+
+        void on(_tkh& handler, parse_events::grammar_start, iterator begin)
+        {
+            handler._stream->_reset(begin);
+        }
+        void on(_tkh& handler, parse_events::grammar_finish, Reader& reader)
+        {
+            auto begin = reader.position();
+            lexy::try_match_token(dsl::any, reader);
+            auto end = reader.position();
+
+            handler._stream->_finish({begin, end});
+        }
+        void on(_tkh& handler, parse_events::grammar_cancel, Reader&)
+        {
+            handler._stream->clear();
+        }
+
+        void on(_tkh& handler, parse_events::production_start ev, iterator pos)
+        {
+            _first_token = handler._stream->size();
+            _validate.on(handler._validate, ev, pos);
+        }
+
+        void on(_tkh& handler, parse_events::production_cancel ev, iterator pos)
+        {
+            // Like lexy::parse_as_tree, we replace everything consumed by the production with an
+            // error token, so the token stream remains lossless.
+            handler._stream->_truncate(_first_token);
+            handler._stream->_token(lexy::error_token_kind, _validate.production_begin(), pos);
+
+            _validate.on(handler._validate, ev, pos);
+        }
+
+        template <typename TokenKind>
+        void on(_tkh& handler, parse_events::token, TokenKind kind, iterator begin, iterator end)
+        {
+            handler._stream->_token(kind, begin, end);
+        }
+
+        template <typename Event, typename... Args>
+        auto on(_tkh& handler, Event ev, Args&&... args)
+        {
+            return _validate.on(handler._validate, ev, LEXY_FWD(args)...);
+        }
+
+    private:
+        typename _vh<Reader>::event_handler _validate;
+        // The number of tokens when the production was started.
+        std::size_t _first_token;
+    };
+
+    template <typename Production, typename State>
+    using value_callback = _detail::void_value_callback;
+
+    template <typename T>
+    constexpr auto get_result(bool rule_parse_result) &&
+    {
+        return LEXY_MOV(_validate).template get_result<T>(rule_parse_result);
+    }
+
+private:
+    Stream*     _stream;
+    _vh<Reader> _validate;
+};
+
+template <typename State, typename Input, typename ErrorCallback, typename TokenKind = void,
+          typename MemoryResource = void>
+struct tokenize_action
+{
+    using stream_type = lexy::token_stream_for<Input, TokenKind, MemoryResource>;
+
+    stream_type*         _stream;
+    const ErrorCallback* _callback;
+    State*               _state = nullptr;
+
+    using handler = _tkh<stream_type, lexy::input_reader<Input>>;
+    using state   = State;
+    using input   = Input;
+
+    template <typename>
+    using result_type = validate_result<ErrorCallback>;
+
+    constexpr explicit tokenize_action(stream_type& stream, const ErrorCallback& callback)
+    : _stream(&stream), _callback(&callback)
+    {}
+    template <typename U = State>
+    constexpr explicit tokenize_action(U& state, stream_type& stream,
+                                       const ErrorCallback& callback)
+    : _stream(&stream), _callback(&callback), _state(&state)
+    {}
+
+    template <typename Production>
+    constexpr auto operator()(Production, const Input& input) const
+    {
+        _detail::any_holder input_holder(&input);
+        _detail::any_holder sink(_get_error_sink(*_callback));
+        auto                reader = input.reader();
+        return lexy::do_action<Production, result_type>(handler(*_stream, input_holder, sink),
+                                                        _state, reader);
+    }
+};
+
+template <typename Production, typename TokenKind, typename MemoryResource, typename Input,
+          typename ErrorCallback>
+auto tokenize(token_stream<lexy::input_reader<Input>, TokenKind, MemoryResource>& stream,
+              const Input& input, const ErrorCallback& callback) -> validate_result<ErrorCallback>
+{
+    return tokenize_action<void, Input, ErrorCallback, TokenKind,
+                           MemoryResource>(stream, callback)(Production{}, input);
+}
+template <typename Production, typename TokenKind, typename MemoryResource, typename Input,
+          typename State, typename ErrorCallback>
+auto tokenize(token_stream<lexy::input_reader<Input>, TokenKind, MemoryResource>& stream,
+              const Input& input, State& state,
+              const ErrorCallback& callback) -> validate_result<ErrorCallback>
+{
+    return tokenize_action<State, Input, ErrorCallback, TokenKind,
+                           MemoryResource>(state, stream, callback)(Production{}, input);
+}
+template <typename Production, typename TokenKind, typename MemoryResource, typename Input,
+          typename State, typename ErrorCallback>
+auto tokenize(token_stream<lexy::input_reader<Input>, TokenKind, MemoryResource>& stream,
+              const Input& input, const State& state,
+              const ErrorCallback& callback) -> validate_result<ErrorCallback>
+{
+    return tokenize_action<const State, Input, ErrorCallback, TokenKind,
+                           MemoryResource>(state, stream, callback)(Production{}, input);
+}
+} // namespace lexy
+
+#endif // LEXY_ACTION_TOKENIZE_HPP_INCLUDED
@@ -306,6 +306,9 @@ template <typename OutputIt, typename Input, typename TokenKind = void>
 class _th
 {
 public:
+    // The trace shows every branch that is tried.
+    static constexpr bool tries_all_branches = true;
+
     explicit _th(OutputIt out, const Input& input, visualization_options opts = {}) noexcept
     : _writer(out, opts), _input(&input), _anchor(input)
     {
@@ -376,6 +379,7 @@ public:
             auto loc = handler.get_location(begin);
             handler._writer.write_backtrack(loc, lexeme_for<Input>(begin, end));
         }
+        void on(_th&, parse_events::lookahead, iterator) {}
 
         template <typename Error>
         void on(_th& handler, parse_events::error, const Error& error)
@@ -151,7 +151,8 @@ struct _list
     }
     constexpr auto allocator() const
     {
-        return allocator([](const auto& alloc) { return alloc; });
+        // Return a reference, so the state can also be a non-copyable memory resource.
+        return allocator([](auto& alloc) -> auto& { return alloc; });
     }
 };
 
@@ -292,7 +293,8 @@ struct _collection
     }
     constexpr auto allocator() const
     {
-        return allocator([](const auto& alloc) { return alloc; });
+        // Return a reference, so the state can also be a non-copyable memory resource.
+        return allocator([](auto& alloc) -> auto& { return alloc; });
     }
 };
 
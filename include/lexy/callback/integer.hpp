@@ -38,6 +38,10 @@ struct _int
 // A callback that takes an optional sign and an integer and produces the signed integer.
 template <typename T>
 constexpr auto as_integer = _int<T>{};
+
+// A callback that takes an optional sign and a floating-point number and produces the signed one.
+template <typename T>
+constexpr auto as_floating = _int<T>{};
 } // namespace lexy
 
 #endif // LEXY_CALLBACK_INTEGER_HPP_INCLUDED
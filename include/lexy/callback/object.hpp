@@ -5,6 +5,7 @@
 #define LEXY_CALLBACK_OBJECT_HPP_INCLUDED
 
 #include <lexy/callback/base.hpp>
+#include <new>
 
 namespace lexy::_detail
 {
@@ -56,6 +57,39 @@ struct _construct<void>
 template <typename T>
 constexpr auto construct = _construct<T>{};
 
+template <typename T, typename PtrT, typename ResourceFn>
+struct _new_resource
+{
+    ResourceFn _resource;
+
+    using return_type = PtrT;
+
+    template <typename State>
+    struct _with_state
+    {
+        State&            _state;
+        const ResourceFn& _resource;
+
+        template <typename... Args>
+        constexpr auto operator()(Args&&... args) const
+            -> std::enable_if_t<_detail::is_constructible<T, Args&&...>, PtrT>
+        {
+            auto& resource = _detail::invoke(_resource, _state);
+            auto  memory   = resource.allocate(sizeof(T), alignof(T));
+            if constexpr (std::is_constructible_v<T, Args&&...>)
+                return PtrT(::new (memory) T(LEXY_FWD(args)...));
+            else
+                return PtrT(::new (memory) T{LEXY_FWD(args)...});
+        }
+    };
+
+    template <typename State>
+    constexpr auto operator[](State& state) const
+    {
+        return _with_state<State>{state, _resource};
+    }
+};
+
 template <typename T, typename PtrT>
 struct _new
 {
@@ -87,6 +121,19 @@ struct _new
             return PtrT(ptr);
         }
     }
+
+    template <typename ResourceFn>
+    constexpr auto resource(ResourceFn resource_fn) const
+    {
+        // A smart pointer would delete memory that belongs to the resource.
+        static_assert(std::is_pointer_v<PtrT>,
+                      "objects allocated from a memory resource must be returned as raw pointers");
+        return _new_resource<T, PtrT, ResourceFn>{resource_fn};
+    }
+    constexpr auto resource() const
+    {
+        return resource([](auto& resource) -> auto& { return resource; });
+    }
 };
 
 /// A callback that constructs an object of type T on the heap by forwarding the arguments.
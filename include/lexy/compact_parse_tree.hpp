@@ -0,0 +1,1288 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_COMPACT_PARSE_TREE_HPP_INCLUDED
+#define LEXY_COMPACT_PARSE_TREE_HPP_INCLUDED
+
+#include <cstring>
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/grammar.hpp>
+#include <lexy/parse_tree.hpp>
+#include <lexy/token.hpp>
+
+//=== internal: cpt_node ===//
+namespace lexy::_detail
+{
+// Index of a node in the node array of a compact parse tree.
+using cpt_index = std::uint_least32_t;
+// Index that doesn't refer to a node.
+constexpr auto cpt_null = cpt_index(UINT_LEAST32_MAX);
+
+// A node of a compact parse tree.
+// All links are indices into the node array, and tokens are stored relative to the beginning of
+// the input.
+struct cpt_node
+{
+    static constexpr auto type_token      = 0b0u;
+    static constexpr auto type_production = 0b1u;
+
+    static constexpr auto role_sibling = 0b0u;
+    static constexpr auto role_parent  = 0b1u;
+
+    // The "next" node, as in pt_node: either the next sibling or the parent.
+    cpt_index next;
+    // Stores a bit for the type of *this* node, a bit for the role of the next node,
+    // and a bit whether a production is a token production.
+    // The remaining bits store the token kind or the index of the production id.
+    cpt_index header;
+    // For a token, the offset of its beginning from the beginning of the input.
+    // For a production, the index of its first child.
+    cpt_index first;
+    // For a token, its length.
+    // For a production, the number of children.
+    cpt_index second;
+
+    static cpt_node make_token(std::uint_least16_t kind, cpt_index offset,
+                               cpt_index length) noexcept
+    {
+        // We initialize it to a null parent, just like pt_node.
+        return {cpt_null, _make_header(type_token, false, kind), offset, length};
+    }
+    static cpt_node make_production(cpt_index id, bool is_token) noexcept
+    {
+        return {cpt_null, _make_header(type_production, is_token, id), cpt_null, 0};
+    }
+
+    //=== information about the current node ===//
+    unsigned type() const noexcept
+    {
+        return header & 0b1;
+    }
+
+    bool is_token_production() const noexcept
+    {
+        return (header & 0b100) != 0;
+    }
+
+    cpt_index payload() const noexcept
+    {
+        return header >> 3;
+    }
+
+    //=== information about the next node ===//
+    void set_next(cpt_index node, unsigned role) noexcept
+    {
+        next   = node;
+        header = cpt_index((header & ~cpt_index(0b10)) | ((role & 0b1) << 1));
+    }
+
+    unsigned next_role() const noexcept
+    {
+        return (header & 0b10) >> 1;
+    }
+
+private:
+    static cpt_index _make_header(unsigned type, bool is_token, cpt_index payload) noexcept
+    {
+        LEXY_PRECONDITION(payload <= (cpt_null >> 3));
+        return cpt_index((payload << 3) | (is_token ? 0b100u : 0u) | (role_parent << 1) | type);
+    }
+};
+
+// Describes where the nodes of a compact parse tree are stored.
+// For a tree built in memory, it is the beginning of the memory block and the nodes are stored
+// immediately afterwards; for a loaded tree, it points into the loaded data.
+template <typename Iterator>
+struct cpt_header
+{
+    // The beginning of the input; token offsets are relative to it.
+    Iterator base;
+    // The node array.
+    const cpt_node* nodes;
+    // The number of nodes and the number of nodes that fit.
+    cpt_index size;
+    cpt_index capacity;
+
+    // The ids of all productions in the tree, indexed by the payload of production nodes.
+    // A loaded tree has no ids, only the names of the productions.
+    const char* const* const* ids;
+    const cpt_index*          name_offsets;
+    const char*               names;
+    cpt_index                 id_count;
+
+    const char* production_name(cpt_index payload) const noexcept
+    {
+        LEXY_PRECONDITION(payload < id_count);
+        if (ids != nullptr)
+            return *ids[payload];
+        else
+            return names + name_offsets[payload];
+    }
+};
+} // namespace lexy::_detail
+
+//=== internal: cpt_buffer ===//
+namespace lexy::_detail
+{
+// Stores the nodes of a compact parse tree in a single growing array,
+// and interns the production ids.
+template <typename Iterator, typename MemoryResource>
+class cpt_buffer
+{
+    using resource_ptr = _detail::memory_resource_ptr<MemoryResource>;
+    using header       = cpt_header<Iterator>;
+
+    static constexpr cpt_index initial_capacity
+        = (4096 - sizeof(header)) / sizeof(cpt_node); // NOLINT
+    static constexpr cpt_index initial_id_capacity = 16;
+
+public:
+    //=== constructors/destructors/assignment ===//
+    explicit constexpr cpt_buffer(MemoryResource* resource) noexcept
+    : _resource(resource), _header(nullptr), _ids(nullptr), _slots(nullptr), _id_count(0),
+      _id_capacity(0)
+    {}
+
+    cpt_buffer(cpt_buffer&& other) noexcept
+    : _resource(other._resource), _header(other._header), _ids(other._ids), _slots(other._slots),
+      _id_count(other._id_count), _id_capacity(other._id_capacity)
+    {
+        other._header      = nullptr;
+        other._ids         = nullptr;
+        other._slots       = nullptr;
+        other._id_count    = 0;
+        other._id_capacity = 0;
+    }
+
+    ~cpt_buffer() noexcept
+    {
+        if (_header != nullptr)
+            _resource->deallocate(_header, _node_memory_size(_header->capacity), alignof(header));
+        _deallocate_ids();
+    }
+
+    cpt_buffer& operator=(cpt_buffer&& other) noexcept
+    {
+        lexy::_detail::swap(_resource, other._resource);
+        lexy::_detail::swap(_header, other._header);
+        lexy::_detail::swap(_ids, other._ids);
+        lexy::_detail::swap(_slots, other._slots);
+        lexy::_detail::swap(_id_count, other._id_count);
+        lexy::_detail::swap(_id_capacity, other._id_capacity);
+        return *this;
+    }
+
+    //=== nodes ===//
+    // Allocates the node array, if necessary, and removes all nodes.
+    // Must be called before everything else.
+    void reset(Iterator base)
+    {
+        if (_header == nullptr)
+        {
+            auto memory = _resource->allocate(_node_memory_size(initial_capacity), alignof(header));
+            _header     = ::new (memory) header{};
+
+            _header->capacity = initial_capacity;
+        }
+
+        _header->base     = base;
+        _header->nodes    = _nodes();
+        _header->size     = 0;
+        _header->ids      = _ids;
+        _header->id_count = _id_count;
+    }
+
+    // Removes all nodes, but keeps the memory.
+    void clear() noexcept
+    {
+        if (_header != nullptr)
+            _header->size = 0;
+    }
+
+    bool empty() const noexcept
+    {
+        return _header == nullptr || _header->size == 0;
+    }
+
+    const header* get_header() const noexcept
+    {
+        return _header;
+    }
+
+    Iterator base() const noexcept
+    {
+        return _header->base;
+    }
+
+    cpt_node& operator[](cpt_index idx) noexcept
+    {
+        LEXY_PRECONDITION(idx < _header->size);
+        return _nodes()[idx];
+    }
+
+    cpt_index allocate(const cpt_node& node)
+    {
+        LEXY_PRECONDITION(_header); // Forgot to call .reset().
+        if (_header->size == _header->capacity)
+            _grow();
+
+        auto idx = _header->size++;
+        ::new (static_cast<void*>(_nodes() + idx)) cpt_node(node);
+        return idx;
+    }
+
+    cpt_index top() const noexcept
+    {
+        return _header->size;
+    }
+
+    // Destroys all nodes allocated after top() returned the marker.
+    void unwind(cpt_index marker) noexcept
+    {
+        LEXY_PRECONDITION(marker <= _header->size);
+        _header->size = marker;
+    }
+
+    //=== production ids ===//
+    // Returns the index of the production id, adding it if necessary.
+    cpt_index intern(const char* const* id)
+    {
+        if (2 * (_id_count + 1) > _id_capacity)
+            _grow_ids();
+
+        auto mask = _id_capacity - 1;
+        for (auto slot = _hash(id) & mask;; slot = (slot + 1) & mask)
+        {
+            // Slots store the index + 1, so zero is an empty slot.
+            auto idx = _slots[slot];
+            if (idx == 0)
+            {
+                _ids[_id_count] = id;
+                _slots[slot]    = ++_id_count;
+                if (_header != nullptr)
+                    _header->id_count = _id_count;
+                return _id_count - 1;
+            }
+            else if (_ids[idx - 1] == id)
+                return idx - 1;
+        }
+    }
+
+private:
+    cpt_node* _nodes() const noexcept
+    {
+        return static_cast<cpt_node*>(static_cast<void*>(_header + 1));
+    }
+
+    static std::size_t _node_memory_size(cpt_index capacity) noexcept
+    {
+        return sizeof(header) + capacity * sizeof(cpt_node);
+    }
+
+    static cpt_index _hash(const char* const* id) noexcept
+    {
+        // The ids are pointers to static variables, so the lower bits don't vary much.
+        auto value = reinterpret_cast<std::uintptr_t>(id) >> 3;
+        return cpt_index((value * 0x9E3779B1u) >> 7);
+    }
+
+    void _grow()
+    {
+        LEXY_PRECONDITION(_header->capacity < cpt_null / 2); // Tree has too many nodes.
+        auto old_capacity = _header->capacity;
+        auto new_capacity = 2 * old_capacity;
+
+        auto memory = _resource->allocate(_node_memory_size(new_capacity), alignof(header));
+        std::memcpy(memory, static_cast<void*>(_header), _node_memory_size(old_capacity));
+        _resource->deallocate(_header, _node_memory_size(old_capacity), alignof(header));
+
+        _header           = static_cast<header*>(memory);
+        _header->nodes    = _nodes();
+        _header->capacity = new_capacity;
+    }
+
+    void _grow_ids()
+    {
+        auto old_ids   = _ids;
+        auto old_count = _id_count;
+
+        auto new_capacity = _id_capacity == 0 ? initial_id_capacity : 2 * _id_capacity;
+        auto new_ids      = static_cast<const char* const**>(
+            _resource->allocate(new_capacity / 2 * sizeof(const char* const*),
+                                alignof(const char* const*)));
+        auto new_slots    = static_cast<cpt_index*>(
+            _resource->allocate(new_capacity * sizeof(cpt_index), alignof(cpt_index)));
+        std::memset(new_slots, 0, new_capacity * sizeof(cpt_index));
+
+        if (old_count > 0)
+            std::memcpy(new_ids, old_ids, old_count * sizeof(const char* const*));
+        _deallocate_ids();
+
+        _ids         = new_ids;
+        _slots       = new_slots;
+        _id_capacity = new_capacity;
+
+        // Re-insert all ids into the new slots.
+        auto mask = _id_capacity - 1;
+        for (auto idx = cpt_index(0); idx != old_count; ++idx)
+        {
+            auto slot = _hash(_ids[idx]) & mask;
+            while (_slots[slot] != 0)
+                slot = (slot + 1) & mask;
+            _slots[slot] = idx + 1;
+        }
+        _id_count = old_count;
+
+        if (_header != nullptr)
+            _header->ids = _ids;
+    }
+
+    void _deallocate_ids() noexcept
+    {
+        if (_ids == nullptr)
+            return;
+
+        _resource->deallocate(_ids, _id_capacity / 2 * sizeof(const char* const*),
+                              alignof(const char* const*));
+        _resource->deallocate(_slots, _id_capacity * sizeof(cpt_index), alignof(cpt_index));
+        _ids      = nullptr;
+        _slots    = nullptr;
+        _id_count = 0;
+    }
+
+    LEXY_EMPTY_MEMBER resource_ptr _resource;
+    header*                        _header;
+
+    // Hash table from production id to index; the ids are stored in order of insertion.
+    const char* const** _ids;
+    cpt_index*          _slots;
+    cpt_index           _id_count;
+    cpt_index           _id_capacity;
+};
+} // namespace lexy::_detail
+
+//=== compact_parse_tree ===//
+namespace lexy
+{
+template <typename Reader, typename TokenKind>
+class _cpt_node_kind;
+template <typename Reader, typename TokenKind>
+class _cpt_node;
+template <typename Reader, typename TokenKind>
+class _cpt_traverse_range;
+template <typename Reader, typename TokenKind>
+class mapped_parse_tree;
+
+/// A parse tree where all nodes are 16 bytes and links are 32-bit indices.
+/// It has the same interface as `lexy::parse_tree`.
+template <typename Reader, typename TokenKind = void, typename MemoryResource = void>
+class compact_parse_tree
+{
+    static_assert(lexy::is_char_encoding<typename Reader::encoding>);
+    static_assert(_detail::is_random_access_iterator<typename Reader::iterator>,
+                  "compact_parse_tree requires random access iterators");
+
+public:
+    //=== construction ===//
+    class builder;
+
+    constexpr compact_parse_tree()
+    : compact_parse_tree(_detail::get_memory_resource<MemoryResource>())
+    {}
+    constexpr explicit compact_parse_tree(MemoryResource* resource)
+    : _buffer(resource), _size(0), _depth(0)
+    {}
+
+    //=== container access ===//
+    bool empty() const noexcept
+    {
+        return _buffer.empty();
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    std::size_t depth() const noexcept
+    {
+        LEXY_PRECONDITION(!empty());
+        return _depth;
+    }
+
+    void clear() noexcept
+    {
+        _buffer.clear();
+    }
+
+    //=== node access ===//
+    using node_kind = _cpt_node_kind<Reader, TokenKind>;
+    using node      = _cpt_node<Reader, TokenKind>;
+
+    node root() const noexcept
+    {
+        LEXY_PRECONDITION(!empty());
+        return node(_buffer.get_header(), 0);
+    }
+
+    //=== traverse ===//
+    using traverse_range = _cpt_traverse_range<Reader, TokenKind>;
+
+    traverse_range traverse(const node& n) const noexcept
+    {
+        return traverse_range(n);
+    }
+    traverse_range traverse() const noexcept
+    {
+        if (empty())
+            return traverse_range();
+        else
+            return traverse_range(root());
+    }
+
+    //=== remaining input ===//
+    lexy::lexeme<Reader> remaining_input() const noexcept
+    {
+        if (empty())
+            return {};
+
+        auto header = _buffer.get_header();
+        return _cpt_node<Reader, TokenKind>::_token_lexeme(header, header->nodes[0].next);
+    }
+
+private:
+    _detail::cpt_buffer<typename Reader::iterator, MemoryResource> _buffer;
+    std::size_t                                                    _size;
+    std::size_t                                                    _depth;
+};
+
+template <typename Input, typename TokenKind = void, typename MemoryResource = void>
+using compact_parse_tree_for
+    = lexy::compact_parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>;
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+struct _parse_tree_traits<compact_parse_tree<Reader, TokenKind, MemoryResource>>
+{
+    using reader          = Reader;
+    using token_kind      = TokenKind;
+    using memory_resource = MemoryResource;
+};
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+class compact_parse_tree<Reader, TokenKind, MemoryResource>::builder
+{
+    using iterator = typename Reader::iterator;
+    using buffer   = _detail::cpt_buffer<iterator, MemoryResource>;
+
+public:
+    class marker
+    {
+    public:
+        marker() : marker(0, 0) {}
+
+    private:
+        // Where to unwind when done.
+        _detail::cpt_index unwind_pos;
+        // The current production node.
+        // cpt_null if using the container API.
+        _detail::cpt_index prod;
+        // The number of children we've already added.
+        std::size_t child_count;
+        // The first and last child of the container.
+        _detail::cpt_index first_child;
+        _detail::cpt_index last_child;
+
+        // For a production node, depth of the production node.
+        // For a container node, depth of the children.
+        std::size_t cur_depth;
+        // The maximum local depth seen in the subtree beginning at the marker.
+        std::size_t local_max_depth;
+
+        explicit marker(_detail::cpt_index unwind_pos, std::size_t cur_depth,
+                        _detail::cpt_index prod = _detail::cpt_null)
+        : unwind_pos(unwind_pos), prod(prod), child_count(0), first_child(_detail::cpt_null),
+          last_child(_detail::cpt_null), cur_depth(cur_depth), local_max_depth(cur_depth)
+        {}
+
+        void insert(buffer& buf, _detail::cpt_index child)
+        {
+            if (first_child == _detail::cpt_null)
+            {
+                first_child = last_child = child;
+            }
+            else
+            {
+                buf[last_child].set_next(child, _detail::cpt_node::role_sibling);
+                last_child = child;
+            }
+
+            ++child_count;
+        }
+        void insert_list(buffer& buf, std::size_t length, _detail::cpt_index first,
+                         _detail::cpt_index last)
+        {
+            if (length == 0)
+                return;
+
+            if (first_child == _detail::cpt_null)
+            {
+                first_child = first;
+                last_child  = last;
+            }
+            else
+            {
+                buf[last_child].set_next(first, _detail::cpt_node::role_sibling);
+                last_child = last;
+            }
+
+            child_count += length;
+        }
+
+        void insert_children_into(buffer& buf, _detail::cpt_index parent)
+        {
+            LEXY_PRECONDITION(buf[parent].second == 0);
+            if (child_count == 0)
+                return;
+
+            // last_child needs an index to the production.
+            buf[last_child].set_next(parent, _detail::cpt_node::role_parent);
+
+            LEXY_PRECONDITION(child_count < _detail::cpt_null);
+            buf[parent].first  = first_child;
+            buf[parent].second = _detail::cpt_index(child_count);
+        }
+
+        void update_size_depth(std::size_t& size, std::size_t& max_depth)
+        {
+            size += child_count;
+
+            if (cur_depth == local_max_depth && child_count > 0)
+                // We have children we haven't yet accounted for.
+                ++local_max_depth;
+
+            if (max_depth < local_max_depth)
+                max_depth = local_max_depth;
+        }
+
+        friend builder;
+    };
+
+    //=== root node ===//
+    /// `begin` is the beginning of the input, all tokens are stored relative to it.
+    explicit builder(compact_parse_tree&& tree, production_info production, iterator begin)
+    : _result(LEXY_MOV(tree))
+    {
+        // Empty the initial parse tree.
+        _result._buffer.reset(begin);
+
+        // Allocate a new root node.
+        auto root = _result._buffer.allocate(
+            _detail::cpt_node::make_production(_result._buffer.intern(production.id),
+                                               production.is_token));
+        _result._size  = 1;
+        _result._depth = 0;
+
+        // Begin construction at the root.
+        _cur = marker(_result._buffer.top(), 0, root);
+    }
+    explicit builder(production_info production, iterator begin)
+    : builder(compact_parse_tree(), production, begin)
+    {}
+
+    compact_parse_tree&& finish(iterator end) &&
+    {
+        return LEXY_MOV(*this).finish({end, end});
+    }
+    compact_parse_tree&& finish(lexy::lexeme<Reader> remaining_input) &&
+    {
+        LEXY_PRECONDITION(_cur.prod == 0);
+
+        auto& buf = _result._buffer;
+        _cur.insert_children_into(buf, _cur.prod);
+        _cur.update_size_depth(_result._size, _result._depth);
+
+        auto node = buf.allocate(_make_token(lexy::eof_token_kind, remaining_input.begin(),
+                                             remaining_input.end()));
+        buf[_cur.prod].set_next(node, _detail::cpt_node::role_sibling);
+
+        return LEXY_MOV(_result);
+    }
+
+    //=== production nodes ===//
+    auto start_production(production_info production)
+    {
+        if (production.is_transparent)
+            // Don't need to add a new node for a transparent production.
+            return _cur;
+
+        // Allocate a node for the production.
+        // Note: don't append the node yet, we might still backtrack.
+        auto& buf  = _result._buffer;
+        auto  node = buf.allocate(
+            _detail::cpt_node::make_production(buf.intern(production.id), production.is_token));
+
+        // Subsequent insertions are to the new node, so update marker and return old one.
+        auto old = LEXY_MOV(_cur);
+        _cur     = marker(node, old.cur_depth + 1, node);
+        return old;
+    }
+
+    void finish_production(marker&& m)
+    {
+        LEXY_PRECONDITION(_cur.prod != _detail::cpt_null || m.prod == _cur.prod);
+        if (m.prod == _cur.prod)
+            // We're finishing with a transparent production, do nothing.
+            return;
+
+        _cur.update_size_depth(_result._size, m.local_max_depth);
+        _cur.insert_children_into(_result._buffer, _cur.prod);
+
+        // Insert the production node into the parent and continue with it.
+        m.insert(_result._buffer, _cur.prod);
+        _cur = LEXY_MOV(m);
+    }
+
+    void cancel_production(marker&& m)
+    {
+        LEXY_PRECONDITION(_cur.prod != _detail::cpt_null || m.prod == _cur.prod);
+        if (_cur.prod == m.prod)
+            // We're backtracking a transparent production, do nothing.
+            return;
+
+        _result._buffer.unwind(_cur.unwind_pos);
+        // Continue with parent.
+        _cur = LEXY_MOV(m);
+    }
+
+    //=== container nodes ===//
+    marker start_container()
+    {
+        // Unlike parse_tree, we store the first child directly in the production node,
+        // so we don't need to reserve anything.
+        auto old = LEXY_MOV(_cur);
+        _cur     = marker(_result._buffer.top(), old.cur_depth);
+        return old;
+    }
+
+    void set_container_production(production_info production)
+    {
+        LEXY_PRECONDITION(_cur.prod == _detail::cpt_null);
+        if (production.is_transparent)
+            // If the production is transparent, we do nothing.
+            return;
+
+        // Allocate a new node for the production.
+        auto& buf  = _result._buffer;
+        auto  node = buf.allocate(
+            _detail::cpt_node::make_production(buf.intern(production.id), production.is_token));
+
+        // Create a new container that will contain the production as its only child.
+        // As such, it logically starts at the same position and depth as the current container.
+        auto new_container = marker(_cur.unwind_pos, _cur.cur_depth);
+        new_container.insert(buf, node);
+
+        // The production contains all the children.
+        _cur.insert_children_into(buf, node);
+
+        // The local_max_depth of the new container is determined by the old maximum depth + 1.
+        new_container.local_max_depth = [&] {
+            if (_cur.cur_depth == _cur.local_max_depth && _cur.child_count > 0)
+                // There are children we haven't yet accounted for.
+                return _cur.local_max_depth + 1 + 1;
+            else
+                return _cur.local_max_depth + 1;
+        }();
+        _result._size += _cur.child_count;
+
+        // And we continue with the current container.
+        _cur = new_container;
+    }
+
+    void finish_container(marker&& m)
+    {
+        LEXY_PRECONDITION(_cur.prod == _detail::cpt_null);
+
+        // Insert the children of our container into the parent.
+        m.insert_list(_result._buffer, _cur.child_count, _cur.first_child, _cur.last_child);
+
+        // We can't update size yet, it would be double counted.
+        // We do need to update the max depth if necessary, however.
+        std::size_t size = 0;
+        _cur.update_size_depth(size, m.local_max_depth);
+
+        // Continue with the parent.
+        _cur = LEXY_MOV(m);
+    }
+
+    void cancel_container(marker&& m)
+    {
+        LEXY_PRECONDITION(_cur.prod == _detail::cpt_null);
+
+        // Deallocate everything we've inserted.
+        _result._buffer.unwind(_cur.unwind_pos);
+        // Continue with parent.
+        _cur = LEXY_MOV(m);
+    }
+
+    //=== token nodes ===//
+    void token(token_kind<TokenKind> _kind, iterator begin, iterator end)
+    {
+        if (_kind.ignore_if_empty() && begin == end)
+            return;
+
+        auto  kind = token_kind<TokenKind>::to_raw(_kind);
+        auto& buf  = _result._buffer;
+
+        // We merge error tokens.
+        if (kind == lexy::error_token_kind && _cur.last_child != _detail::cpt_null
+            && buf[_cur.last_child].type() == _detail::cpt_node::type_token
+            && buf[_cur.last_child].payload() == lexy::error_token_kind)
+        {
+            // No need to allocate a new node, just extend the previous node.
+            auto& node  = buf[_cur.last_child];
+            node.second = _offset(end) - node.first;
+        }
+        else
+        {
+            // Allocate and append.
+            auto node = buf.allocate(_make_token(kind, begin, end));
+            _cur.insert(buf, node);
+        }
+    }
+
+    //=== accessors ===//
+    std::size_t current_child_count() const noexcept
+    {
+        return _cur.child_count;
+    }
+
+private:
+    _detail::cpt_index _offset(iterator pos) const noexcept
+    {
+        auto offset = pos - _result._buffer.base();
+        LEXY_PRECONDITION(0 <= offset && std::size_t(offset) < _detail::cpt_null);
+        return _detail::cpt_index(offset);
+    }
+
+    _detail::cpt_node _make_token(std::uint_least16_t kind, iterator begin,
+                                  iterator end) const noexcept
+    {
+        auto offset = _offset(begin);
+        return _detail::cpt_node::make_token(kind, offset, _offset(end) - offset);
+    }
+
+    compact_parse_tree _result;
+    marker             _cur;
+};
+
+template <typename Reader, typename TokenKind>
+class _cpt_node_kind
+{
+public:
+    bool is_token() const noexcept
+    {
+        return _get().type() == _detail::cpt_node::type_token;
+    }
+    bool is_production() const noexcept
+    {
+        return _get().type() == _detail::cpt_node::type_production;
+    }
+
+    bool is_root() const noexcept
+    {
+        // Root node has a next node (the remaining input node) which has no next node.
+        return _header->nodes[_get().next].next == _detail::cpt_null;
+    }
+    bool is_token_production() const noexcept
+    {
+        return is_production() && _get().is_token_production();
+    }
+
+    const char* name() const noexcept
+    {
+        if (is_production())
+            return _header->production_name(_get().payload());
+        else
+            return token_kind<TokenKind>::from_raw(_raw_kind()).name();
+    }
+
+    friend bool operator==(_cpt_node_kind lhs, _cpt_node_kind rhs)
+    {
+        if (lhs.is_token() && rhs.is_token())
+            return lhs._raw_kind() == rhs._raw_kind();
+        else if (!lhs.is_production() || !rhs.is_production())
+            return false;
+        else if (lhs._header == rhs._header)
+            // The ids are interned, so it's the same production if it has the same index.
+            return lhs._get().payload() == rhs._get().payload();
+        else if (lhs._header->ids != nullptr && rhs._header->ids != nullptr)
+            return lhs._id() == rhs._id();
+        else
+            // A loaded tree only has the names.
+            return std::strcmp(lhs.name(), rhs.name()) == 0;
+    }
+    friend bool operator!=(_cpt_node_kind lhs, _cpt_node_kind rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator==(_cpt_node_kind nk, token_kind<TokenKind> tk)
+    {
+        if (nk.is_token())
+            return token_kind<TokenKind>::from_raw(nk._raw_kind()) == tk;
+        else
+            return false;
+    }
+    friend bool operator==(token_kind<TokenKind> tk, _cpt_node_kind nk)
+    {
+        return nk == tk;
+    }
+    friend bool operator!=(_cpt_node_kind nk, token_kind<TokenKind> tk)
+    {
+        return !(nk == tk);
+    }
+    friend bool operator!=(token_kind<TokenKind> tk, _cpt_node_kind nk)
+    {
+        return !(nk == tk);
+    }
+
+    friend bool operator==(_cpt_node_kind nk, production_info info)
+    {
+        if (!nk.is_production())
+            return false;
+        else if (nk._header->ids != nullptr)
+            return nk._id() == info.id;
+        else
+            return std::strcmp(nk.name(), info.name) == 0;
+    }
+    friend bool operator==(production_info info, _cpt_node_kind nk)
+    {
+        return nk == info;
+    }
+    friend bool operator!=(_cpt_node_kind nk, production_info info)
+    {
+        return !(nk == info);
+    }
+    friend bool operator!=(production_info info, _cpt_node_kind nk)
+    {
+        return !(nk == info);
+    }
+
+private:
+    using _header_t = _detail::cpt_header<typename Reader::iterator>;
+
+    explicit _cpt_node_kind(const _header_t* header, _detail::cpt_index idx)
+    : _header(header), _idx(idx)
+    {}
+
+    const _detail::cpt_node& _get() const noexcept
+    {
+        return _header->nodes[_idx];
+    }
+    std::uint_least16_t _raw_kind() const noexcept
+    {
+        return std::uint_least16_t(_get().payload());
+    }
+    const char* const* _id() const noexcept
+    {
+        return _header->ids[_get().payload()];
+    }
+
+    const _header_t*   _header;
+    _detail::cpt_index _idx;
+
+    friend _cpt_node<Reader, TokenKind>;
+};
+
+template <typename Reader, typename TokenKind>
+class _cpt_node
+{
+    using _header_t = _detail::cpt_header<typename Reader::iterator>;
+
+public:
+    void* address() const noexcept
+    {
+        return const_cast<_detail::cpt_node*>(&_get()); // NOLINT
+    }
+
+    auto kind() const noexcept
+    {
+        return _cpt_node_kind<Reader, TokenKind>(_header, _idx);
+    }
+
+    auto parent() const noexcept
+    {
+        if (kind().is_root())
+            // The root has itself as parent.
+            return *this;
+
+        // If we follow the sibling index, we reach a parent index.
+        auto cur = _idx;
+        while (_node(cur).next_role() == _detail::cpt_node::role_sibling)
+            cur = _node(cur).next;
+        return _cpt_node(_header, _node(cur).next);
+    }
+
+    class children_range
+    {
+    public:
+        class iterator : public _detail::forward_iterator_base<iterator, _cpt_node, _cpt_node, void>
+        {
+        public:
+            iterator() noexcept : _header(nullptr), _cur(_detail::cpt_null) {}
+
+            auto deref() const noexcept
+            {
+                return _cpt_node(_header, _cur);
+            }
+
+            void increment() noexcept
+            {
+                _cur = _header->nodes[_cur].next;
+            }
+
+            bool equal(iterator rhs) const noexcept
+            {
+                return _cur == rhs._cur;
+            }
+
+        private:
+            explicit iterator(const _header_t* header, _detail::cpt_index idx) noexcept
+            : _header(header), _cur(idx)
+            {}
+
+            const _header_t*   _header;
+            _detail::cpt_index _cur;
+
+            friend children_range;
+        };
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        std::size_t size() const noexcept
+        {
+            if (_node.kind().is_production())
+                return _node._get().second;
+            else
+                return 0;
+        }
+
+        iterator begin() const noexcept
+        {
+            if (!empty())
+                return iterator(_node._header, _node._get().first);
+            else
+                return end();
+        }
+        iterator end() const noexcept
+        {
+            // The last child has a next index back to the parent,
+            // so if we keep following it, we'll end up here.
+            return iterator(_node._header, _node._idx);
+        }
+
+    private:
+        explicit children_range(_cpt_node node) : _node(node) {}
+
+        _cpt_node _node;
+
+        friend _cpt_node;
+    };
+
+    auto children() const noexcept
+    {
+        return children_range(*this);
+    }
+
+    class sibling_range
+    {
+    public:
+        class iterator : public _detail::forward_iterator_base<iterator, _cpt_node, _cpt_node, void>
+        {
+        public:
+            iterator() noexcept : _header(nullptr), _cur(_detail::cpt_null) {}
+
+            auto deref() const noexcept
+            {
+                return _cpt_node(_header, _cur);
+            }
+
+            void increment() noexcept
+            {
+                auto& node = _header->nodes[_cur];
+                if (node.next_role() == _detail::cpt_node::role_parent)
+                    // We're pointing to the parent, go to first child instead.
+                    _cur = _header->nodes[node.next].first;
+                else
+                    // We're pointing to a sibling, go there.
+                    _cur = node.next;
+            }
+
+            bool equal(iterator rhs) const noexcept
+            {
+                return _cur == rhs._cur;
+            }
+
+        private:
+            explicit iterator(const _header_t* header, _detail::cpt_index idx) noexcept
+            : _header(header), _cur(idx)
+            {}
+
+            const _header_t*   _header;
+            _detail::cpt_index _cur;
+
+            friend sibling_range;
+        };
+
+        bool empty() const noexcept
+        {
+            return begin() == end();
+        }
+
+        iterator begin() const noexcept
+        {
+            // We begin with the next node after ours.
+            // If we don't have siblings, this is our node itself.
+            return ++iterator(_node._header, _node._idx);
+        }
+        iterator end() const noexcept
+        {
+            // We end when we're back at the node.
+            return iterator(_node._header, _node._idx);
+        }
+
+    private:
+        explicit sibling_range(_cpt_node node) noexcept : _node(node) {}
+
+        _cpt_node _node;
+
+        friend _cpt_node;
+    };
+
+    auto siblings() const noexcept
+    {
+        return sibling_range(*this);
+    }
+
+    bool is_last_child() const noexcept
+    {
+        // We're the last child if our index points to the parent.
+        return _get().next_role() == _detail::cpt_node::role_parent;
+    }
+
+    auto position() const noexcept -> typename Reader::iterator
+    {
+        // Find the first descendant that is a token.
+        auto cur = _idx;
+        while (_node(cur).type() == _detail::cpt_node::type_production)
+        {
+            LEXY_PRECONDITION(_node(cur).second > 0);
+            cur = _node(cur).first;
+        }
+
+        return _header->base + _node(cur).first;
+    }
+
+    auto lexeme() const noexcept
+    {
+        if (kind().is_token())
+            return _token_lexeme(_header, _idx);
+        else
+            return lexy::lexeme<Reader>();
+    }
+
+    auto covering_lexeme() const noexcept
+    {
+        if (kind().is_token())
+            return _token_lexeme(_header, _idx);
+
+        auto begin = position();
+
+        auto sibling = _idx;
+        while (true)
+        {
+            auto next_role = _node(sibling).next_role();
+            sibling        = _node(sibling).next;
+            // If we went to parent, we need to continue finding siblings.
+            if (next_role == _detail::cpt_node::role_sibling)
+                break;
+        }
+        auto end = _cpt_node(_header, sibling).position();
+
+        return lexy::lexeme<Reader>(begin, end);
+    }
+
+    auto token() const noexcept
+    {
+        LEXY_PRECONDITION(kind().is_token());
+
+        auto token_kind = lexy::token_kind<TokenKind>::from_raw(kind()._raw_kind());
+        return lexy::token<Reader, TokenKind>(token_kind, _token_lexeme(_header, _idx));
+    }
+
+    friend bool operator==(_cpt_node lhs, _cpt_node rhs) noexcept
+    {
+        return lhs._header == rhs._header && lhs._idx == rhs._idx;
+    }
+    friend bool operator!=(_cpt_node lhs, _cpt_node rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    explicit _cpt_node(const _header_t* header, _detail::cpt_index idx) noexcept
+    : _header(header), _idx(idx)
+    {}
+
+    const _detail::cpt_node& _node(_detail::cpt_index idx) const noexcept
+    {
+        return _header->nodes[idx];
+    }
+    const _detail::cpt_node& _get() const noexcept
+    {
+        return _node(_idx);
+    }
+
+    static lexy::lexeme<Reader> _token_lexeme(const _header_t*   header,
+                                              _detail::cpt_index idx) noexcept
+    {
+        auto& node  = header->nodes[idx];
+        auto  begin = header->base + node.first;
+        return lexy::lexeme<Reader>(begin, begin + node.second);
+    }
+
+    const _header_t*   _header;
+    _detail::cpt_index _idx;
+
+    template <typename, typename, typename>
+    friend class compact_parse_tree;
+    friend mapped_parse_tree<Reader, TokenKind>;
+    friend _cpt_traverse_range<Reader, TokenKind>;
+};
+
+template <typename Reader, typename TokenKind>
+class _cpt_traverse_range
+{
+public:
+    using event = traverse_event;
+
+    struct _value_type
+    {
+        traverse_event               event;
+        _cpt_node<Reader, TokenKind> node;
+    };
+
+    class iterator : public _detail::forward_iterator_base<iterator, _value_type, _value_type, void>
+    {
+    public:
+        iterator() noexcept = default;
+
+        _value_type deref() const noexcept
+        {
+            return {_ev, _cpt_node<Reader, TokenKind>(_header, _cur)};
+        }
+
+        void increment() noexcept
+        {
+            auto& cur = _header->nodes[_cur];
+            if (_ev == traverse_event::enter)
+            {
+                if (cur.second > 0)
+                {
+                    // We go to the first child next.
+                    _cur = cur.first;
+                    if (_header->nodes[_cur].type() == _detail::cpt_node::type_token)
+                        _ev = traverse_event::leaf;
+                    else
+                        _ev = traverse_event::enter;
+                }
+                else
+                {
+                    // Don't have children, exit.
+                    _ev = traverse_event::exit;
+                }
+            }
+            else
+            {
+                // We follow the next index.
+
+                if (cur.next_role() == _detail::cpt_node::role_parent)
+                    // We go back to a production for the second time.
+                    _ev = traverse_event::exit;
+                else if (_header->nodes[cur.next].type() == _detail::cpt_node::type_production)
+                    // We're having a production as sibling.
+                    _ev = traverse_event::enter;
+                else
+                    // Token as sibling.
+                    _ev = traverse_event::leaf;
+
+                _cur = cur.next;
+            }
+        }
+
+        bool equal(iterator rhs) const noexcept
+        {
+            return _ev == rhs._ev && _cur == rhs._cur;
+        }
+
+    private:
+        const _detail::cpt_header<typename Reader::iterator>* _header = nullptr;
+        _detail::cpt_index                                    _cur    = _detail::cpt_null;
+        traverse_event                                        _ev     = traverse_event::exit;
+
+        friend _cpt_traverse_range;
+    };
+
+    bool empty() const noexcept
+    {
+        return _begin == _end;
+    }
+
+    iterator begin() const noexcept
+    {
+        return _begin;
+    }
+
+    iterator end() const noexcept
+    {
+        return _end;
+    }
+
+private:
+    _cpt_traverse_range() noexcept = default;
+    _cpt_traverse_range(_cpt_node<Reader, TokenKind> n) noexcept
+    {
+        _begin._header = _end._header = n._header;
+        _begin._cur = _end._cur = n._idx;
+
+        if (n.kind().is_token())
+        {
+            _begin._ev = traverse_event::leaf;
+
+            _end = _detail::next(_begin);
+        }
+        else
+        {
+            _begin._ev = traverse_event::enter;
+
+            _end._ev = traverse_event::exit;
+            ++_end; // half-open range
+        }
+    }
+
+    iterator _begin, _end;
+
+    template <typename, typename, typename>
+    friend class compact_parse_tree;
+    friend mapped_parse_tree<Reader, TokenKind>;
+};
+} // namespace lexy
+
+#endif // LEXY_COMPACT_PARSE_TREE_HPP_INCLUDED
+
@@ -7,6 +7,7 @@
 #include <lexy/dsl/any.hpp>
 #include <lexy/dsl/ascii.hpp>
 #include <lexy/dsl/bits.hpp>
+#include <lexy/dsl/blob.hpp>
 #include <lexy/dsl/bom.hpp>
 #include <lexy/dsl/brackets.hpp>
 #include <lexy/dsl/branch.hpp>
@@ -20,6 +21,7 @@
 #include <lexy/dsl/context_counter.hpp>
 #include <lexy/dsl/context_flag.hpp>
 #include <lexy/dsl/context_identifier.hpp>
+#include <lexy/dsl/datetime.hpp>
 #include <lexy/dsl/delimited.hpp>
 #include <lexy/dsl/digit.hpp>
 #include <lexy/dsl/effect.hpp>
@@ -27,6 +29,7 @@
 #include <lexy/dsl/error.hpp>
 #include <lexy/dsl/expression.hpp>
 #include <lexy/dsl/flags.hpp>
+#include <lexy/dsl/floating.hpp>
 #include <lexy/dsl/follow.hpp>
 #include <lexy/dsl/identifier.hpp>
 #include <lexy/dsl/if.hpp>
@@ -24,6 +24,10 @@ struct _any : token_base<_any, unconditional_branch_base>
             using encoding = typename Reader::encoding;
             if constexpr (lexy::_detail::is_swar_reader<Reader>)
             {
+                using char_type = typename encoding::char_type;
+                reader.bump_simd_until(
+                    lexy::_detail::simd_stop_chars<char_type, 0, encoding::eof()>{});
+
                 while (!lexy::_detail::swar_has_char<typename encoding::char_type, encoding::eof()>(
                     reader.peek_swar()))
                     reader.bump_swar();
@@ -63,6 +63,19 @@ struct token
 struct backtracked
 {};
 
+/// The input was looked at until (and including) position without consuming it,
+/// e.g. by a branch condition that didn't match.
+/// Arguments: position
+struct lookahead
+{};
+
+/// The production could be reused from a previous parse instead of parsing it again.
+/// Only sent after production_start if the handler has `reuses_productions`.
+/// Arguments: reader
+/// Returns: whether the production was reused; the reader is then at its end.
+struct production_reuse
+{};
+
 /// A parse error occurrs.
 /// Arguments: error object
 struct error
@@ -0,0 +1,217 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DSL_BLOB_HPP_INCLUDED
+#define LEXY_DSL_BLOB_HPP_INCLUDED
+
+#include <lexy/_detail/blob_decode.hpp>
+#include <lexy/dsl/base.hpp>
+#include <lexy/dsl/whitespace.hpp>
+#include <lexy/error.hpp>
+
+namespace lexyd
+{
+// Collects the decoded bytes and passes them to the sink in chunks.
+template <typename Sink>
+struct _blob_buffer
+{
+    static constexpr std::size_t capacity = 256;
+
+    Sink&         sink;
+    unsigned char data[capacity];
+    std::size_t   size;
+
+    constexpr explicit _blob_buffer(Sink& sink) : sink(sink), data{}, size(0) {}
+
+    constexpr void push(unsigned char byte)
+    {
+        if (size == capacity)
+            flush();
+        data[size++] = byte;
+    }
+
+    constexpr void flush()
+    {
+        if (size > 0)
+        {
+            const unsigned char* begin = data;
+            sink(begin, begin + size);
+        }
+        size = 0;
+    }
+};
+
+template <typename Reader>
+constexpr auto _blob_use_simd = lexy::_detail::is_swar_reader<Reader>
+                                && sizeof(typename Reader::encoding::char_type) == 1;
+
+// Decodes as much as possible using SIMD, only stopping close to the end of the blob.
+template <typename Reader, typename Sink, typename Decode>
+void _blob_decode_simd(Reader& reader, _blob_buffer<Sink>& buffer, Decode decode)
+{
+    while (true)
+    {
+        auto pos = reader.position();
+        auto out = buffer.data + buffer.size;
+        auto end = decode(pos, reader.swar_end(), out, buffer.data + buffer.capacity);
+        reader.bump_swar(static_cast<std::size_t>(end - pos));
+        buffer.size = static_cast<std::size_t>(out - buffer.data);
+
+        if (buffer.capacity - buffer.size >= lexy::_detail::simd_decode_block_size)
+            // We've stopped because of the input.
+            break;
+        buffer.flush();
+    }
+}
+
+template <typename NextParser, typename Context, typename Reader, typename Sink, typename... Args>
+constexpr bool _blob_finish(Context& context, Reader& reader, Sink& sink, Args&&... args)
+{
+    if constexpr (std::is_same_v<typename Sink::return_type, void>)
+    {
+        LEXY_MOV(sink).finish();
+        return lexy::whitespace_parser<Context, NextParser>::parse(context, reader,
+                                                                   LEXY_FWD(args)...);
+    }
+    else
+    {
+        return lexy::whitespace_parser<Context, NextParser>::parse(context, reader,
+                                                                   LEXY_FWD(args)...,
+                                                                   LEXY_MOV(sink).finish());
+    }
+}
+
+template <typename Context, typename Reader>
+constexpr void _blob_error(Context& context, typename Reader::iterator begin, const Reader& reader,
+                           const char* name)
+{
+    context.on(_ev::token{}, lexy::error_token_kind, begin, reader.position());
+    auto err = lexy::error<Reader, lexy::expected_char_class>(reader.position(), name);
+    context.on(_ev::error{}, err);
+}
+
+struct _hex_blob : rule_base
+{
+    template <typename NextParser>
+    struct p
+    {
+        template <typename Context, typename Reader, typename... Args>
+        LEXY_PARSER_FUNC static bool parse(Context& context, Reader& reader, Args&&... args)
+        {
+            auto                         sink = context.value_callback().sink();
+            _blob_buffer<decltype(sink)> buffer(sink);
+            auto                         begin = reader.position();
+
+            if constexpr (_blob_use_simd<Reader>)
+            {
+                if (!LEXY_IS_CONSTANT_EVALUATED())
+                    _blob_decode_simd(reader, buffer,
+                                      [](auto ptr, auto end, auto& out, auto out_end) {
+                                          return lexy::_detail::simd_decode_hex(ptr, end, out,
+                                                                              out_end);
+                                      });
+            }
+
+            while (true)
+            {
+                auto high = lexy::_detail::hex_digit_value(reader.peek());
+                if (high < 0)
+                    break;
+                reader.bump();
+
+                auto low = lexy::_detail::hex_digit_value(reader.peek());
+                if (low < 0)
+                {
+                    // We need an even number of digits.
+                    _blob_error(context, begin, reader, "digit.hex");
+                    return false;
+                }
+                reader.bump();
+
+                buffer.push(static_cast<unsigned char>(high * 16 + low));
+            }
+            buffer.flush();
+
+            context.on(_ev::token{}, lexy::digits_token_kind, begin, reader.position());
+            return _blob_finish<NextParser>(context, reader, sink, LEXY_FWD(args)...);
+        }
+    };
+};
+
+struct _base64 : rule_base
+{
+    template <typename NextParser>
+    struct p
+    {
+        template <typename Context, typename Reader, typename... Args>
+        LEXY_PARSER_FUNC static bool parse(Context& context, Reader& reader, Args&&... args)
+        {
+            auto                         sink = context.value_callback().sink();
+            _blob_buffer<decltype(sink)> buffer(sink);
+            auto                         begin = reader.position();
+
+            if constexpr (_blob_use_simd<Reader>)
+            {
+                if (!LEXY_IS_CONSTANT_EVALUATED())
+                    _blob_decode_simd(reader, buffer,
+                                      [](auto ptr, auto end, auto& out, auto out_end) {
+                                          return lexy::_detail::simd_decode_base64(ptr, end, out,
+                                                                              out_end);
+                                      });
+            }
+
+            // Decode groups of four chars into three bytes.
+            int values[4] = {};
+            int count     = 0;
+            while (true)
+            {
+                for (count = 0; count != 4; ++count)
+                {
+                    values[count] = lexy::_detail::base64_digit_value(reader.peek());
+                    if (values[count] < 0)
+                        break;
+                    reader.bump();
+                }
+                if (count != 4)
+                    break;
+
+                buffer.push(static_cast<unsigned char>(values[0] << 2 | values[1] >> 4));
+                buffer.push(static_cast<unsigned char>((values[1] & 0xF) << 4 | values[2] >> 2));
+                buffer.push(static_cast<unsigned char>((values[2] & 0x3) << 6 | values[3]));
+            }
+
+            // The last group may be incomplete and padded.
+            if (count > 0)
+            {
+                using encoding = typename Reader::encoding;
+                for (auto i = count == 1 ? 1 : count; i != 4; ++i)
+                {
+                    if (count == 1 || reader.peek() != lexy::_detail::transcode_int<encoding>('='))
+                    {
+                        _blob_error(context, begin, reader, "base64");
+                        return false;
+                    }
+                    reader.bump();
+                }
+
+                buffer.push(static_cast<unsigned char>(values[0] << 2 | values[1] >> 4));
+                if (count == 3)
+                    buffer.push(
+                        static_cast<unsigned char>((values[1] & 0xF) << 4 | values[2] >> 2));
+            }
+            buffer.flush();
+
+            context.on(_ev::token{}, lexy::any_token_kind, begin, reader.position());
+            return _blob_finish<NextParser>(context, reader, sink, LEXY_FWD(args)...);
+        }
+    };
+};
+
+/// Matches pairs of hex digits and passes the bytes they encode to the sink.
+constexpr auto hex_blob = _hex_blob{};
+
+/// Matches base64 encoded data with padding and passes the decoded bytes to the sink.
+constexpr auto base64 = _base64{};
+} // namespace lexyd
+
+#endif // LEXY_DSL_BLOB_HPP_INCLUDED
@@ -129,6 +129,16 @@ constexpr auto compress_ascii_set()
 
     return result;
 }
+
+// Builds the table for classifying the characters of the set using SIMD.
+constexpr simd_nibble_table make_nibble_table(const ascii_set& set)
+{
+    simd_nibble_table result{};
+    for (auto hi = 0; hi != 8; ++hi)
+        result.hi[hi] = static_cast<unsigned char>(1 << hi);
+    set.visit([&](int c) { result.lo[c & 0xF] |= static_cast<unsigned char>(1 << (c >> 4)); });
+    return result;
+}
 } // namespace lexy::_detail
 
 namespace lexy::_detail
@@ -165,6 +175,8 @@ namespace lexyd
 {
 template <typename CharSet>
 constexpr auto _cas = lexy::_detail::compress_ascii_set<CharSet>();
+template <typename CharSet>
+constexpr auto _cas_table = lexy::_detail::make_nibble_table(CharSet::char_class_ascii());
 
 template <typename Derived>
 struct char_class_base : token_base<Derived>, _char_class_base
@@ -4,8 +4,15 @@
 #ifndef LEXY_DSL_CHOICE_HPP_INCLUDED
 #define LEXY_DSL_CHOICE_HPP_INCLUDED
 
+#include <cstdint>
+#include <lexy/_detail/integer_sequence.hpp>
+#include <lexy/_detail/swar.hpp>
 #include <lexy/_detail/tuple.hpp>
+#include <lexy/action/base.hpp>
 #include <lexy/dsl/base.hpp>
+#include <lexy/dsl/branch.hpp>
+#include <lexy/dsl/char_class.hpp>
+#include <lexy/dsl/literal.hpp>
 #include <lexy/error.hpp>
 
 namespace lexy
@@ -19,6 +26,305 @@ struct exhausted_choice
 };
 } // namespace lexy
 
+//=== first code unit ===//
+namespace lexy::_detail
+{
+// A set of code units of an encoding whose code units are single bytes, and EOF.
+struct code_unit_set
+{
+    static constexpr std::size_t eof_index = 256;
+
+    bool contains[257];
+
+    constexpr code_unit_set() : contains{} {}
+
+    constexpr bool is_full() const
+    {
+        for (auto c : contains)
+            if (!c)
+                return false;
+        return true;
+    }
+
+    constexpr void insert(std::size_t idx)
+    {
+        contains[idx] = true;
+    }
+    constexpr void insert(std::size_t lower, std::size_t upper)
+    {
+        for (auto i = lower; i <= upper; ++i)
+            contains[i] = true;
+    }
+    constexpr void insert_all()
+    {
+        insert(0, eof_index);
+    }
+};
+
+template <typename Encoding>
+constexpr std::size_t code_unit_index(typename Encoding::int_type c)
+{
+    if (c == Encoding::eof())
+        return code_unit_set::eof_index;
+    else
+        return static_cast<unsigned char>(c);
+}
+} // namespace lexy::_detail
+
+namespace lexy
+{
+template <typename Reader>
+struct _acfr;
+} // namespace lexy
+
+namespace lexyd
+{
+template <template <typename> typename CaseFolding>
+struct _cfl_folding;
+template <typename Production>
+struct _prd;
+template <typename Leading, typename Trailing, typename... ReservedPredicate>
+struct _id;
+struct _eof;
+template <typename... R>
+struct _chc;
+
+// Inserts all code units the branch condition of Rule can start with.
+// If we don't know them, we insert everything, so the branch is always tried.
+template <typename Rule>
+struct _chc_first
+{
+    template <typename Encoding>
+    static LEXY_CONSTEVAL void insert(lexy::_detail::code_unit_set& set)
+    {
+        if constexpr (lexy::is_unconditional_branch_rule<Rule>)
+        {
+            set.insert_all();
+        }
+        else if constexpr (lexy::is_char_class_rule<Rule>)
+        {
+            Rule::char_class_ascii().visit([&](int c) { set.insert(std::size_t(c)); });
+            // Everything else can start a non-ASCII character.
+            if constexpr (!std::is_same_v<decltype(Rule::char_class_match_cp(char32_t())),
+                                          std::false_type>)
+                set.insert(0x80, 0xFF);
+        }
+        else if constexpr (lexy::is_literal_rule<Rule>)
+        {
+            using case_folding = typename Rule::lit_case_folding;
+            constexpr auto ascii_case_folding
+                = std::is_same_v<case_folding, _cfl_folding<lexy::_acfr>>;
+            if constexpr (!std::is_void_v<case_folding> && !ascii_case_folding)
+            {
+                // Other case foldings can map non-ASCII characters to ASCII.
+                set.insert_all();
+            }
+            else
+            {
+                auto trie = lexy::_detail::make_empty_trie<Encoding, Rule>();
+                trie.node_value[Rule::lit_insert(trie, 0, 0)] = 0;
+                if (trie.node_value[0] != trie.node_no_match)
+                    set.insert_all();
+
+                auto transitions = trie.node_transitions(0);
+                for (auto i = 0u; i != transitions.length; ++i)
+                {
+                    auto c = lexy::_detail::make_uchar(trie.transition_char[transitions.index[i]]);
+                    set.insert(c);
+
+                    if constexpr (ascii_case_folding)
+                    {
+                        if ('a' <= c && c <= 'z')
+                            set.insert(std::size_t(c - 'a' + 'A'));
+                        else if ('A' <= c && c <= 'Z')
+                            set.insert(std::size_t(c - 'A' + 'a'));
+                    }
+                }
+            }
+        }
+        else if constexpr (lexy::is_literal_set_rule<Rule>)
+        {
+            _chc_first<typename Rule::as_lset>::template insert<Encoding>(set);
+        }
+        else
+        {
+            set.insert_all();
+        }
+    }
+};
+template <typename Condition, typename... R>
+struct _chc_first<_br<Condition, R...>> : _chc_first<Condition>
+{};
+template <typename Production>
+struct _chc_first<_prd<Production>> : _chc_first<lexy::production_rule<Production>>
+{};
+template <typename Leading, typename Trailing, typename... ReservedPredicate>
+struct _chc_first<_id<Leading, Trailing, ReservedPredicate...>> : _chc_first<Leading>
+{};
+template <>
+struct _chc_first<_eof>
+{
+    template <typename Encoding>
+    static LEXY_CONSTEVAL void insert(lexy::_detail::code_unit_set& set)
+    {
+        set.insert(set.eof_index);
+    }
+};
+template <typename... Literals>
+struct _chc_first<_lset<Literals...>>
+{
+    template <typename Encoding>
+    static LEXY_CONSTEVAL void insert(lexy::_detail::code_unit_set& set)
+    {
+        (_chc_first<Literals>::template insert<Encoding>(set), ...);
+    }
+};
+template <typename... R>
+struct _chc_first<_chc<R...>>
+{
+    template <typename Encoding>
+    static LEXY_CONSTEVAL void insert(lexy::_detail::code_unit_set& set)
+    {
+        (_chc_first<R>::template insert<Encoding>(set), ...);
+    }
+};
+
+template <typename Encoding, typename Rule>
+LEXY_CONSTEVAL auto _chc_first_set()
+{
+    lexy::_detail::code_unit_set result;
+    _chc_first<Rule>::template insert<Encoding>(result);
+
+    // If EOF is also a valid code unit, we can't distinguish them.
+    if constexpr (sizeof(typename Encoding::int_type) == 1)
+    {
+        if (result.contains[lexy::_detail::make_uchar(Encoding::eof())])
+            result.insert(result.eof_index);
+    }
+
+    return result;
+}
+
+// The branches of a choice whose condition can start with a given code unit.
+template <std::size_t BranchCount>
+struct _chc_candidates
+{
+    std::uint_least64_t bits[(BranchCount + 63) / 64];
+
+    template <std::size_t Idx>
+    constexpr bool contains() const
+    {
+        return (bits[Idx / 64] >> (Idx % 64)) & 1u;
+    }
+
+    constexpr bool operator==(const _chc_candidates& other) const
+    {
+        for (auto i = 0u; i != (BranchCount + 63) / 64; ++i)
+            if (bits[i] != other.bits[i])
+                return false;
+        return true;
+    }
+};
+
+template <std::size_t BranchCount>
+constexpr auto _chc_all_candidates = [] {
+    _chc_candidates<BranchCount> result{};
+    for (auto idx = 0u; idx != BranchCount; ++idx)
+        result.bits[idx / 64] |= std::uint_least64_t(1) << (idx % 64);
+    return result;
+}();
+
+template <std::size_t BranchCount, std::size_t CandidatesCount>
+struct _chc_table
+{
+    // For each code unit and EOF, the index of its candidates.
+    std::uint_least16_t          index[257];
+    _chc_candidates<BranchCount> candidates[CandidatesCount];
+
+    constexpr std::size_t candidates_count() const
+    {
+        auto result = std::size_t(0);
+        for (auto idx : index)
+            if (idx >= result)
+                result = idx + 1u;
+        return result;
+    }
+
+    template <typename Encoding>
+    constexpr const auto& lookup(typename Encoding::int_type c) const
+    {
+        return candidates[index[lexy::_detail::code_unit_index<Encoding>(c)]];
+    }
+};
+
+template <typename Encoding, typename... R>
+LEXY_CONSTEVAL auto _chc_build_table()
+{
+    lexy::_detail::code_unit_set first_sets[] = {_chc_first_set<Encoding, R>()...};
+
+    // Many code units share the same candidates, so we only store them once.
+    _chc_table<sizeof...(R), 257> result{};
+    auto                          count = std::size_t(0);
+    for (auto c = 0u; c != 257; ++c)
+    {
+        _chc_candidates<sizeof...(R)> candidates{};
+        for (auto idx = 0u; idx != sizeof...(R); ++idx)
+            if (first_sets[idx].contains[c])
+                candidates.bits[idx / 64] |= std::uint_least64_t(1) << (idx % 64);
+
+        auto existing = std::size_t(0);
+        while (existing != count && !(result.candidates[existing] == candidates))
+            ++existing;
+        if (existing == count)
+        {
+            result.candidates[count] = candidates;
+            ++count;
+        }
+
+        result.index[c] = std::uint_least16_t(existing);
+    }
+
+    return result;
+}
+template <typename Encoding, typename... R>
+constexpr auto _chc_full_table = _chc_build_table<Encoding, R...>();
+
+template <typename Encoding, typename... R>
+LEXY_CONSTEVAL auto _chc_make_table()
+{
+    constexpr auto& full  = _chc_full_table<Encoding, R...>;
+    constexpr auto  count = full.candidates_count();
+
+    _chc_table<sizeof...(R), count> result{};
+    for (auto c = 0u; c != 257; ++c)
+        result.index[c] = full.index[c];
+    for (auto idx = 0u; idx != count; ++idx)
+        result.candidates[idx] = full.candidates[idx];
+    return result;
+}
+
+// Dispatching on the next code unit is only worth it if it lets us skip enough branches;
+// trying a few branches directly is just as fast.
+template <typename Encoding, typename... R>
+LEXY_CONSTEVAL bool _chc_can_dispatch()
+{
+    if constexpr (!lexy::is_char_encoding<Encoding> || sizeof(typename Encoding::char_type) != 1)
+        return false;
+    else
+        return (0 + ... + (_chc_first_set<Encoding, R>().is_full() ? 0 : 1)) >= 3;
+}
+
+// The branches a branch parser has tried, so it can cancel them.
+template <typename Candidates, typename Iterator>
+struct _chc_tried
+{
+    const Candidates* candidates;
+    Iterator          position;
+};
+struct _chc_tried_all
+{};
+} // namespace lexyd
+
 namespace lexyd
 {
 template <typename... R>
@@ -30,6 +336,15 @@ struct _chc
 {
     static constexpr auto _any_unconditional = (lexy::is_unconditional_branch_rule<R> || ...);
 
+    // If possible, we only try the branches whose condition can start with the next code unit.
+    template <typename Encoding>
+    static constexpr bool _dispatch = _chc_can_dispatch<Encoding, R...>();
+    template <typename Encoding>
+    static constexpr auto _table = _chc_make_table<Encoding, R...>();
+    // Unless the handler wants to see all branches.
+    template <typename Handler>
+    static constexpr bool _tries_all = lexy::_handler_tries_all_branches<Handler>;
+
     template <typename Reader, typename Indices = lexy::_detail::make_index_sequence<sizeof...(R)>>
     struct bp;
     template <typename Reader, std::size_t... Idx>
@@ -38,8 +353,23 @@ struct _chc
         template <typename Rule>
         using rp = lexy::branch_parser_for<Rule, Reader>;
 
+        static constexpr auto _use_table = _dispatch<typename Reader::encoding>;
+
         lexy::_detail::tuple<rp<R>...> r_parsers;
         std::size_t                    branch_idx;
+        LEXY_EMPTY_MEMBER std::conditional_t<
+            _use_table, _chc_tried<_chc_candidates<sizeof...(R)>, typename Reader::iterator>,
+            _chc_tried_all>
+            tried;
+
+        template <std::size_t I>
+        constexpr bool _was_tried() const
+        {
+            if constexpr (_use_table)
+                return tried.candidates->template contains<I>();
+            else
+                return true;
+        }
 
         template <typename ControlBlock>
         constexpr auto try_parse(const ControlBlock* cb, const Reader& reader)
@@ -53,8 +383,24 @@ struct _chc
                 return true;
             };
 
+            if constexpr (_use_table)
+            {
+                if constexpr (_tries_all<typename ControlBlock::handler_type>)
+                {
+                    tried.candidates = &_chc_all_candidates<sizeof...(R)>;
+                }
+                else
+                {
+                    constexpr auto& table = _table<typename Reader::encoding>;
+                    tried.candidates
+                        = &table.template lookup<typename Reader::encoding>(reader.peek());
+                    tried.position = reader.position();
+                }
+            }
+
             // Need to try each possible branch.
-            auto found_branch = (try_r(Idx, r_parsers.template get<Idx>()) || ...);
+            auto found_branch
+                = ((_was_tried<Idx>() && try_r(Idx, r_parsers.template get<Idx>())) || ...);
             if constexpr (_any_unconditional)
             {
                 LEXY_ASSERT(found_branch,
@@ -70,13 +416,20 @@ struct _chc
         template <typename Context>
         constexpr void cancel(Context& context)
         {
-            // Need to cancel all branches.
-            (r_parsers.template get<Idx>().cancel(context), ...);
+            // We've looked at the next code unit, even if we haven't tried any branch.
+            if constexpr (_use_table && !_tries_all<typename Context::handler_type>)
+                context.on(_ev::lookahead{}, tried.position);
+
+            // Need to cancel all branches we've tried.
+            ((_was_tried<Idx>() ? r_parsers.template get<Idx>().cancel(context) : void()), ...);
         }
 
         template <typename NextParser, typename Context, typename... Args>
         LEXY_PARSER_FUNC bool finish(Context& context, Reader& reader, Args&&... args)
         {
+            if constexpr (_use_table && !_tries_all<typename Context::handler_type>)
+                context.on(_ev::lookahead{}, tried.position);
+
             // Need to call finish on the selected branch, and cancel on all others before that.
             auto result = false;
             (void)((Idx == branch_idx
@@ -84,14 +437,19 @@ struct _chc
                            = r_parsers.template get<Idx>()
                                  .template finish<NextParser>(context, reader, LEXY_FWD(args)...),
                            true)
-                        : (r_parsers.template get<Idx>().cancel(context), false))
+                        : (_was_tried<Idx>() ? r_parsers.template get<Idx>().cancel(context)
+                                             : void(),
+                           false))
                    || ...);
             return result;
         }
     };
 
-    template <typename NextParser>
-    struct p
+    template <typename NextParser,
+              typename Indices = lexy::_detail::make_index_sequence<sizeof...(R)>>
+    struct p;
+    template <typename NextParser, std::size_t... Idx>
+    struct p<NextParser, lexy::_detail::index_sequence<Idx...>>
     {
         template <typename Context, typename Reader, typename... Args>
         LEXY_PARSER_FUNC static bool parse(Context& context, Reader& reader, Args&&... args)
@@ -110,8 +468,26 @@ struct _chc
                 return true;
             };
 
-            // Try to parse each branch in order.
-            auto found_branch = (try_r(lexy::branch_parser_for<R, Reader>{}) || ...);
+            auto found_branch = false;
+            if constexpr (_dispatch<typename Reader::encoding>
+                          && !_tries_all<typename Context::handler_type>)
+            {
+                // Try to parse each branch that can start with the next code unit in order.
+                constexpr auto& table      = _table<typename Reader::encoding>;
+                auto&           candidates = table.template lookup<typename Reader::encoding>(
+                    reader.peek());
+                context.on(_ev::lookahead{}, reader.position());
+
+                found_branch = ((candidates.template contains<Idx>()
+                                 && try_r(lexy::branch_parser_for<R, Reader>{}))
+                                || ...);
+            }
+            else
+            {
+                // Try to parse each branch in order.
+                found_branch = (try_r(lexy::branch_parser_for<R, Reader>{}) || ...);
+            }
+
             if constexpr (_any_unconditional)
             {
                 LEXY_ASSERT(found_branch,
@@ -0,0 +1,410 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DSL_DATETIME_HPP_INCLUDED
+#define LEXY_DSL_DATETIME_HPP_INCLUDED
+
+#include <cstdint>
+#include <lexy/_detail/nttp_string.hpp>
+#include <lexy/dsl/base.hpp>
+#include <lexy/dsl/integer.hpp>
+
+namespace lexy
+{
+/// A calendar date and time of day with an optional offset from UTC.
+struct datetime
+{
+    int year;   // 0 to 9999
+    int month;  // 1 to 12
+    int day;    // 1 to 31
+    int hour;   // 0 to 23
+    int minute; // 0 to 59
+    int second; // 0 to 60, which is a leap second
+
+    std::int_least32_t nanosecond;
+
+    bool has_utc_offset;
+    int  utc_offset; // in minutes
+
+    /// The number of seconds since 1970-01-01T00:00:00Z, ignoring leap seconds.
+    /// A datetime without offset is assumed to be in UTC.
+    constexpr std::int_least64_t unix_seconds() const noexcept
+    {
+        // Adapted from: https://howardhinnant.github.io/date_algorithms.html#days_from_civil
+        auto y   = month <= 2 ? year - 1 : year;
+        auto era = (y >= 0 ? y : y - 399) / 400;
+        auto yoe = y - era * 400;
+        auto doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        auto doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        auto days = std::int_least64_t(era) * 146097 + doe - 719468;
+
+        auto seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+        return has_utc_offset ? seconds - utc_offset * 60 : seconds;
+    }
+};
+
+struct invalid_datetime
+{
+    static LEXY_CONSTEVAL auto name()
+    {
+        return "invalid date or time";
+    }
+};
+} // namespace lexy
+
+namespace lexyd
+{
+constexpr int _days_in_month(int year, int month)
+{
+    if (month == 2)
+        return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0) ? 29 : 28;
+    else if (month == 4 || month == 6 || month == 9 || month == 11)
+        return 30;
+    else
+        return 31;
+}
+
+// The layout of eight chars, where 'D' is a decimal digit and everything else a literal char.
+struct _datetime_swar_layout
+{
+    lexy::_detail::swar_int digits; // 0x01 for every digit
+    lexy::_detail::swar_int mask;   // the literal chars and the high nibble of the digits
+    lexy::_detail::swar_int value;
+
+    constexpr explicit _datetime_swar_layout(const char* layout) : digits(0), mask(0), value(0)
+    {
+        using lexy::_detail::swar_int;
+        for (auto i = 0u; i != 8u; ++i)
+        {
+            if (layout[i] == 'D')
+            {
+                digits |= swar_int(0x01) << (i * 8);
+                mask |= swar_int(0xF0) << (i * 8);
+                value |= swar_int(0x30) << (i * 8);
+            }
+            else
+            {
+                mask |= swar_int(0xFF) << (i * 8);
+                value |= swar_int(layout[i]) << (i * 8);
+            }
+        }
+    }
+
+    constexpr bool matches(lexy::_detail::swar_int chars) const
+    {
+        // If the high nibble of a digit is 3, adding 6 only keeps it unchanged if it is '0' to '9'.
+        return (chars & mask) == value
+               && ((chars + digits * 0x06) & digits * 0xF0) == digits * 0x30;
+    }
+
+    // Returns the value of the two digits starting at the specified index.
+    static constexpr int pair(lexy::_detail::swar_int chars, unsigned index)
+    {
+        auto d = (chars >> (index * 8)) & 0x0F0F;
+        return int((d & 0x0F) * 10 + (d >> 8));
+    }
+};
+
+template <typename Reader>
+constexpr bool _datetime_use_swar = [] {
+    if constexpr (lexy::_detail::is_swar_reader<Reader>)
+        return sizeof(typename Reader::encoding::char_type) == 1
+               && sizeof(lexy::_detail::swar_int) == 8;
+    else
+        return false;
+}();
+
+// Matches YYYY-MM-DDTHH:MM:SS[.fraction][offset], where offset is Z or +HH:MM or -HH:MM.
+// RFC 3339 requires the offset, and allows lower case T and Z but not a comma for the fraction.
+template <bool Rfc3339, typename Reader>
+struct _datetime_matcher
+{
+    using char_type = typename Reader::encoding::char_type;
+
+    typename Reader::marker end;
+    lexy::datetime          value;
+    const char_type*        expected; // the literal expected at end, or nullptr for a digit
+    bool                    in_range;
+
+    constexpr explicit _datetime_matcher(const Reader& reader)
+    : end(reader.current()), value{}, expected(nullptr), in_range(true)
+    {}
+
+    constexpr bool try_parse(Reader reader)
+    {
+        auto result = _match(reader);
+        end         = reader.current();
+        return result;
+    }
+
+    constexpr bool _digits(Reader& reader, int& result, int count)
+    {
+        using encoding = typename Reader::encoding;
+
+        result = 0;
+        for (auto i = 0; i != count; ++i)
+        {
+            auto c = reader.peek();
+            if (c < lexy::_detail::transcode_int<encoding>('0')
+                || c > lexy::_detail::transcode_int<encoding>('9'))
+            {
+                expected = nullptr;
+                return false;
+            }
+
+            result = result * 10 + int(c - lexy::_detail::transcode_int<encoding>('0'));
+            reader.bump();
+        }
+        return true;
+    }
+
+    template <char C, char Alt = C>
+    constexpr bool _literal(Reader& reader)
+    {
+        using encoding = typename Reader::encoding;
+
+        auto c = reader.peek();
+        if (c == lexy::_detail::transcode_int<encoding>(C)
+            || c == lexy::_detail::transcode_int<encoding>(Alt))
+        {
+            reader.bump();
+            return true;
+        }
+        else
+        {
+            expected = lexy::_detail::type_string<char, C>::template c_str<char_type>;
+            return false;
+        }
+    }
+
+    // Matches YYYY-MM-DDTHH:MM:SS with three overlapping eight byte loads.
+    constexpr bool _match_fixed_swar(Reader& reader)
+    {
+        auto ptr = reader.position();
+        if (auto end = reader.swar_end(); end != nullptr && end - ptr < 19)
+            return false;
+
+        constexpr auto date_layout = _datetime_swar_layout("DDDD-DD-");
+        constexpr auto time_layout = _datetime_swar_layout("DDTDD:DD");
+        constexpr auto sec_layout  = _datetime_swar_layout("DD:DD:DD");
+
+        auto date = _swar_integer_load(ptr);
+        auto time = _swar_integer_load(ptr + 8);
+        auto sec  = _swar_integer_load(ptr + 11);
+        if constexpr (Rfc3339)
+            // Turn a lower case t into an upper case T.
+            time &= ~(lexy::_detail::swar_int(0x20) << 16);
+        if (!date_layout.matches(date) || !time_layout.matches(time) || !sec_layout.matches(sec))
+            return false;
+
+        value.year   = _datetime_swar_layout::pair(date, 0) * 100
+                     + _datetime_swar_layout::pair(date, 2);
+        value.month  = _datetime_swar_layout::pair(date, 5);
+        value.day    = _datetime_swar_layout::pair(time, 0);
+        value.hour   = _datetime_swar_layout::pair(time, 3);
+        value.minute = _datetime_swar_layout::pair(time, 6);
+        value.second = _datetime_swar_layout::pair(sec, 6);
+
+        reader.bump_swar(19);
+        return true;
+    }
+
+    constexpr bool _match_fixed(Reader& reader)
+    {
+        if constexpr (_datetime_use_swar<Reader>)
+        {
+            if (_match_fixed_swar(reader))
+                return true;
+            // Fall through to report the exact error position.
+        }
+
+        return _digits(reader, value.year, 4) && _literal<'-'>(reader)
+               && _digits(reader, value.month, 2) && _literal<'-'>(reader)
+               && _digits(reader, value.day, 2) && _literal<'T', Rfc3339 ? 't' : 'T'>(reader)
+               && _digits(reader, value.hour, 2) && _literal<':'>(reader)
+               && _digits(reader, value.minute, 2) && _literal<':'>(reader)
+               && _digits(reader, value.second, 2);
+    }
+
+    constexpr bool _match_fraction(Reader& reader)
+    {
+        using encoding = typename Reader::encoding;
+
+        // Digits after the ninth are ignored.
+        auto count = 0;
+        for (auto c = reader.peek(); c >= lexy::_detail::transcode_int<encoding>('0')
+                                     && c <= lexy::_detail::transcode_int<encoding>('9');
+             c = reader.peek())
+        {
+            if (count < 9)
+            {
+                auto digit       = c - lexy::_detail::transcode_int<encoding>('0');
+                value.nanosecond = value.nanosecond * 10 + std::int_least32_t(digit);
+                ++count;
+            }
+            reader.bump();
+        }
+        if (count == 0)
+        {
+            expected = nullptr;
+            return false;
+        }
+
+        for (; count != 9; ++count)
+            value.nanosecond *= 10;
+        return true;
+    }
+
+    constexpr bool _match_offset(Reader& reader)
+    {
+        using encoding = typename Reader::encoding;
+
+        if (_literal<'Z', Rfc3339 ? 'z' : 'Z'>(reader))
+        {
+            value.has_utc_offset = true;
+            return true;
+        }
+
+        auto sign = reader.peek();
+        if (sign != lexy::_detail::transcode_int<encoding>('+')
+            && sign != lexy::_detail::transcode_int<encoding>('-'))
+            // expected has been set to Z.
+            return !Rfc3339;
+        reader.bump();
+
+        auto hours = 0, minutes = 0;
+        if (!_digits(reader, hours, 2) || !_literal<':'>(reader) || !_digits(reader, minutes, 2))
+            return false;
+
+        in_range             = hours <= 23 && minutes <= 59;
+        value.has_utc_offset = true;
+        value.utc_offset     = hours * 60 + minutes;
+        if (sign == lexy::_detail::transcode_int<encoding>('-'))
+            value.utc_offset = -value.utc_offset;
+        return true;
+    }
+
+    constexpr bool _match(Reader& reader)
+    {
+        if (!_match_fixed(reader))
+            return false;
+
+        if (_literal<'.', Rfc3339 ? '.' : ','>(reader) && !_match_fraction(reader))
+            return false;
+
+        if (!_match_offset(reader))
+            return false;
+
+        in_range = in_range && value.month >= 1 && value.month <= 12 && value.day >= 1
+                   && value.day <= _days_in_month(value.year, value.month) && value.hour <= 23
+                   && value.minute <= 59 && value.second <= 60;
+        return true;
+    }
+
+    template <typename Context>
+    constexpr void report_error(Context& context, const Reader&)
+    {
+        if (expected == nullptr)
+        {
+            auto err = lexy::error<Reader, lexy::expected_char_class>(end.position(),
+                                                                      "digit.decimal");
+            context.on(_ev::error{}, err);
+        }
+        else
+        {
+            auto err
+                = lexy::error<Reader, lexy::expected_literal>(end.position(), expected, 0, 1);
+            context.on(_ev::error{}, err);
+        }
+    }
+};
+
+template <bool Rfc3339>
+struct _datetime : branch_base
+{
+    template <typename NextParser>
+    struct _pc
+    {
+        template <typename Context, typename Reader, typename... Args>
+        LEXY_PARSER_FUNC static bool parse(Context& context, Reader& reader,
+                                           typename Reader::iterator begin,
+                                           const lexy::datetime& value, bool in_range,
+                                           Args&&... args)
+        {
+            context.on(_ev::token{}, lexy::digits_token_kind, begin, reader.position());
+            if (!in_range)
+            {
+                // Raise error but recover.
+                auto err = lexy::error<Reader, lexy::invalid_datetime>(begin, reader.position());
+                context.on(_ev::error{}, err);
+            }
+
+            return lexy::whitespace_parser<Context, NextParser>::parse(context, reader,
+                                                                       LEXY_FWD(args)..., value);
+        }
+    };
+
+    template <typename Reader>
+    struct bp
+    {
+        typename Reader::marker end;
+        lexy::datetime          value{};
+        bool                    in_range = false;
+
+        constexpr bool try_parse(const void*, const Reader& reader)
+        {
+            _datetime_matcher<Rfc3339, Reader> matcher(reader);
+            auto                               result = matcher.try_parse(reader);
+            end                                       = matcher.end;
+            value                                     = matcher.value;
+            in_range                                  = matcher.in_range;
+            return result;
+        }
+
+        template <typename Context>
+        constexpr void cancel(Context& context)
+        {
+            context.on(_ev::lookahead{}, end.position());
+        }
+
+        template <typename NextParser, typename Context, typename... Args>
+        LEXY_PARSER_FUNC bool finish(Context& context, Reader& reader, Args&&... args)
+        {
+            auto begin = reader.position();
+            reader.reset(end);
+            return _pc<NextParser>::parse(context, reader, begin, value, in_range,
+                                          LEXY_FWD(args)...);
+        }
+    };
+
+    template <typename NextParser>
+    struct p
+    {
+        template <typename Context, typename Reader, typename... Args>
+        LEXY_PARSER_FUNC static bool parse(Context& context, Reader& reader, Args&&... args)
+        {
+            auto                               begin = reader.position();
+            _datetime_matcher<Rfc3339, Reader> matcher(reader);
+            if (!matcher.try_parse(reader))
+            {
+                context.on(_ev::token{}, lexy::error_token_kind, begin, matcher.end.position());
+                matcher.report_error(context, reader);
+                reader.reset(matcher.end);
+                return false;
+            }
+
+            reader.reset(matcher.end);
+            return _pc<NextParser>::parse(context, reader, begin, matcher.value, matcher.in_range,
+                                          LEXY_FWD(args)...);
+        }
+    };
+};
+
+/// Parses an ISO 8601 date and time, YYYY-MM-DDTHH:MM:SS[.fraction][Z|+HH:MM|-HH:MM].
+constexpr auto iso8601_datetime = _datetime<false>{};
+
+/// Parses an RFC 3339 timestamp, which is an ISO 8601 date and time with offset.
+constexpr auto rfc3339_datetime = _datetime<true>{};
+} // namespace lexyd
+
+#endif // LEXY_DSL_DATETIME_HPP_INCLUDED
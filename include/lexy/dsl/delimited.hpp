@@ -26,6 +26,20 @@ struct missing_delimiter
 
 namespace lexyd
 {
+// The ASCII characters of CharClass that can't start the closing delimiter or an escape sequence.
+template <typename CharClass, typename Encoding, typename Close, typename... Escs>
+constexpr auto _del_content_table = [] {
+    auto set    = CharClass::char_class_ascii();
+    auto remove = [&](auto c) {
+        auto uc = lexy::_detail::make_uchar(c);
+        if (uc <= 0x7F)
+            set.contains[uc] = false;
+    };
+    remove(Close::template lit_first_char<Encoding>());
+    (remove(Escs::template esc_first_char<Encoding>()), ...);
+    return lexy::_detail::make_nibble_table(set);
+}();
+
 template <typename CharClass, typename Reader>
 struct _del_chars
 {
@@ -56,41 +70,49 @@ struct _del_chars
 
         // If we have a SWAR reader and the Close and Escape chars are literal rules,
         // we can munch as much content as possible in a fast loop.
-        // We also need to efficiently check for the CharClass for it to make sense.
         if constexpr (lexy::_detail::is_swar_reader<Reader> //
-                      && (lexy::is_literal_rule<Close> && ... && Escs::esc_is_literal)
-                      && !std::is_same_v<
-                          decltype(CharClass::template char_class_match_swar<encoding>({})),
-                          std::false_type>)
+                      && (lexy::is_literal_rule<Close> && ... && Escs::esc_is_literal))
         {
-            using char_type = typename encoding::char_type;
-            using lexy::_detail::swar_has_char;
-
-            while (true)
+            // Skip all ASCII content characters using SIMD.
+            reader.bump_simd_set(_del_content_table<CharClass, encoding, Close, Escs...>);
+
+            // For the rest, we also need to efficiently check for the CharClass for it to make
+            // sense.
+            if constexpr (!std::is_same_v<
+                              decltype(CharClass::template char_class_match_swar<encoding>({})),
+                              std::false_type>)
             {
-                auto cur = reader.peek_swar();
-
-                // If we have an EOF or the initial character of the closing delimiter, we exit as
-                // we have no more content.
-                if (swar_has_char<char_type, encoding::eof()>(cur)
-                    || swar_has_char<char_type, Close::template lit_first_char<encoding>()>(cur))
-                    break;
+                using char_type = typename encoding::char_type;
+                using lexy::_detail::swar_has_char;
 
-                // The same is true if we have the escape character.
-                if constexpr (sizeof...(Escs) > 0)
+                while (true)
                 {
-                    if ((swar_has_char<char_type, Escs::template esc_first_char<encoding>()>(cur)
-                         || ...))
+                    auto cur = reader.peek_swar();
+
+                    // If we have an EOF or the initial character of the closing delimiter, we
+                    // exit as we have no more content.
+                    if (swar_has_char<char_type, encoding::eof()>(cur)
+                        || swar_has_char<char_type, Close::template lit_first_char<encoding>()>(
+                            cur))
                         break;
-                }
 
-                // We definitely don't have the end of the delimited content in the current SWAR,
-                // check if they all follow the char class.
-                if (!CharClass::template char_class_match_swar<encoding>(cur))
-                    // They don't or we need to look closer, exit the loop.
-                    break;
+                    // The same is true if we have the escape character.
+                    if constexpr (sizeof...(Escs) > 0)
+                    {
+                        if ((swar_has_char<char_type,
+                                           Escs::template esc_first_char<encoding>()>(cur)
+                             || ...))
+                            break;
+                    }
+
+                    // We definitely don't have the end of the delimited content in the current
+                    // SWAR, check if they all follow the char class.
+                    if (!CharClass::template char_class_match_swar<encoding>(cur))
+                        // They don't or we need to look closer, exit the loop.
+                        break;
 
-                reader.bump_swar();
+                    reader.bump_swar();
+                }
             }
         }
     }
@@ -25,14 +25,20 @@ struct _eof : branch_base
     template <typename Reader>
     struct bp
     {
+        typename Reader::iterator pos;
+
         constexpr bool try_parse(const void*, const Reader& reader)
         {
+            pos = reader.position();
             return reader.peek() == Reader::encoding::eof();
         }
 
         template <typename Context>
-        constexpr void cancel(Context&)
-        {}
+        constexpr void cancel(Context& context)
+        {
+            // We've looked at the code unit to see that it isn't EOF.
+            context.on(_ev::lookahead{}, pos);
+        }
 
         template <typename NextParser, typename Context, typename... Args>
         LEXY_PARSER_FUNC bool finish(Context& context, Reader& reader, Args&&... args)
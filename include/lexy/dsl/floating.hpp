@@ -0,0 +1,156 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DSL_FLOATING_HPP_INCLUDED
+#define LEXY_DSL_FLOATING_HPP_INCLUDED
+
+#include <lexy/_detail/decimal_float.hpp>
+#include <lexy/dsl/base.hpp>
+#include <lexy/dsl/digit.hpp>
+#include <lexy/dsl/integer.hpp>
+
+namespace lexy
+{
+struct floating_overflow
+{
+    static LEXY_CONSTEVAL auto name()
+    {
+        return "floating-point overflow";
+    }
+};
+} // namespace lexy
+
+namespace lexyd
+{
+// Matches digits [. digits] [(e|E) [+|-] digits].
+template <bool NoLeadingZero>
+struct _float_token : token_base<_float_token<NoLeadingZero>>
+{
+    template <typename Reader>
+    struct tp
+    {
+        typename Reader::marker end;
+        bool                    forbidden_leading_zero;
+
+        constexpr explicit tp(const Reader& reader)
+        : end(reader.current()), forbidden_leading_zero(false)
+        {}
+
+        constexpr bool try_parse(Reader reader)
+        {
+            using encoding = typename Reader::encoding;
+
+            auto begin = reader.current();
+            if (!_match_digits<decimal>(reader))
+            {
+                end = reader.current();
+                return false;
+            }
+
+            if constexpr (NoLeadingZero)
+            {
+                using char_type = typename encoding::char_type;
+                if (lexy::_detail::next(begin.position()) != reader.position()
+                    && *begin.position() == lexy::_detail::transcode_char<char_type>('0'))
+                {
+                    reader.reset(begin);
+                    reader.bump();
+                    end = reader.current();
+
+                    forbidden_leading_zero = true;
+                    return false;
+                }
+            }
+
+            if (reader.peek() == lexy::_detail::transcode_int<encoding>('.'))
+            {
+                reader.bump();
+                if (!_match_digits<decimal>(reader))
+                {
+                    end = reader.current();
+                    return false;
+                }
+            }
+
+            if (auto c = reader.peek(); c == lexy::_detail::transcode_int<encoding>('e')
+                                        || c == lexy::_detail::transcode_int<encoding>('E'))
+            {
+                reader.bump();
+                if (auto sign = reader.peek();
+                    sign == lexy::_detail::transcode_int<encoding>('+')
+                    || sign == lexy::_detail::transcode_int<encoding>('-'))
+                    reader.bump();
+
+                if (!_match_digits<decimal>(reader))
+                {
+                    end = reader.current();
+                    return false;
+                }
+            }
+
+            end = reader.current();
+            return true;
+        }
+
+        template <typename Context>
+        constexpr void report_error(Context& context, const Reader& reader)
+        {
+            if (forbidden_leading_zero)
+            {
+                auto err = lexy::error<Reader, lexy::forbidden_leading_zero>(reader.position(),
+                                                                             end.position());
+                context.on(_ev::error{}, err);
+            }
+            else
+            {
+                auto name = decimal::char_class_name();
+                auto err  = lexy::error<Reader, lexy::expected_char_class>(end.position(), name);
+                context.on(_ev::error{}, err);
+            }
+        }
+    };
+};
+
+template <typename T>
+struct _float_parser
+{
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "only float and double are supported");
+
+    using base = decimal;
+
+    struct result_type
+    {
+        T    value;
+        bool overflow;
+    };
+
+    template <typename Iterator>
+    static constexpr result_type parse(Iterator cur, Iterator end)
+    {
+        auto value = lexy::_detail::parse_decimal_float<T>(cur, end);
+        return {value, value == std::numeric_limits<T>::infinity()};
+    }
+};
+
+template <typename T>
+struct _float_dsl : _int<_float_token<false>, _float_parser<T>, lexy::floating_overflow>
+{
+    constexpr auto no_leading_zero() const
+    {
+        return _int<_float_token<true>, _float_parser<T>, lexy::floating_overflow>{};
+    }
+};
+
+/// Parses a decimal floating-point number and converts it to the nearest T.
+template <typename T>
+constexpr auto floating = _float_dsl<T>{};
+} // namespace lexyd
+
+namespace lexy
+{
+template <bool NoLeadingZero>
+constexpr auto token_kind_of<lexy::dsl::_float_token<NoLeadingZero>> = lexy::digits_token_kind;
+} // namespace lexy
+
+#endif // LEXY_DSL_FLOATING_HPP_INCLUDED
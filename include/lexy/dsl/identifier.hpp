@@ -54,6 +54,7 @@ struct _idp : token_base<_idp<Leading, Trailing>>
                 if constexpr (lexy::_detail::is_swar_reader<Reader>)
                 {
                     // If we have a swar reader, consume as much as possible at once.
+                    reader.bump_simd_set(_cas_table<Trailing>);
                     while (Trailing{}.template char_class_match_swar<typename Reader::encoding>(
                         reader.peek_swar()))
                         reader.bump_swar();
@@ -178,9 +179,10 @@ struct _id : branch_base
         {
             // Parse the pattern.
             lexy::token_parser_for<decltype(pattern()), Reader> parser(reader);
-            if (!parser.try_parse(reader))
+            auto                                                result = parser.try_parse(reader);
+            end                                                        = parser.end;
+            if (!result)
                 return false;
-            end = parser.end;
 
             // We only succeed if it's not a reserved identifier.
             [[maybe_unused]] auto input
@@ -189,8 +191,10 @@ struct _id : branch_base
         }
 
         template <typename Context>
-        constexpr void cancel(Context&)
-        {}
+        constexpr void cancel(Context& context)
+        {
+            context.on(_ev::lookahead{}, end.position());
+        }
 
         template <typename NextParser, typename Context, typename... Args>
         LEXY_PARSER_FUNC auto finish(Context& context, Reader& reader, Args&&... args)
@@ -5,6 +5,7 @@
 #define LEXY_DSL_INTEGER_HPP_INCLUDED
 
 #include <climits>
+#include <cstring>
 
 #include <lexy/_detail/assert.hpp>
 #include <lexy/code_point.hpp>
@@ -234,8 +235,83 @@ constexpr bool _ndigits_can_overflow()
     return N >= max_digit_count;
 }
 
+template <typename Base>
+constexpr bool _is_ascii_digit_base = false;
+template <int Radix>
+constexpr bool _is_ascii_digit_base<_d<Radix>> = true;
+template <>
+inline constexpr bool _is_ascii_digit_base<hex_lower> = true;
+template <>
+inline constexpr bool _is_ascii_digit_base<hex_upper> = true;
+
+// Whether we can convert eight digits at once using SWAR.
+template <typename T, typename Base, typename Iterator>
+constexpr bool _integer_use_swar = [] {
+    if constexpr (std::is_pointer_v<Iterator>)
+    {
+        using char_type    = std::remove_cv_t<std::remove_pointer_t<Iterator>>;
+        using integer_type = typename lexy::integer_traits<T>::type;
+        return sizeof(char_type) == 1 && sizeof(lexy::_detail::swar_int) == 8
+               && _is_ascii_digit_base<Base> && std::is_integral_v<integer_type>
+               && sizeof(integer_type) >= sizeof(int);
+    }
+    else
+        return false;
+}();
+
+// Loads the next eight chars.
+template <typename CharT>
+constexpr lexy::_detail::swar_int _swar_integer_load(const CharT* ptr)
+{
+    lexy::_detail::swar_int result = 0;
+    if (!LEXY_IS_CONSTANT_EVALUATED() && LEXY_IS_LITTLE_ENDIAN)
+        std::memcpy(&result, ptr, sizeof(result));
+    else
+        for (auto i = 0u; i != 8u; ++i)
+            result |= lexy::_detail::swar_int(lexy::_detail::make_uchar(ptr[i])) << (i * 8);
+    return result;
+}
+
+// Converts eight chars, which must be digits of the Radix, into their value.
+// Adapted from: https://lemire.me/blog/2022/01/21/swar-explained-parsing-eight-digits/
+template <unsigned Radix>
+constexpr std::uint_least64_t _swar_integer_value(lexy::_detail::swar_int chars)
+{
+    using lexy::_detail::swar_fill;
+
+    // Convert each char to its digit value: '0' to '9' are 0x30 to 0x39,
+    // 'a' to 'f' and 'A' to 'F' are 0x61/0x41 to 0x66/0x46.
+    auto digits = chars & swar_fill(char(0x0F));
+    if constexpr (Radix > 10)
+        digits += ((chars >> 6) & swar_fill(char(0x01))) * 9;
+
+    // The first char is in the lowest byte, so it's the most significant digit.
+    // We repeatedly combine two adjacent digit groups into one of twice the width.
+    constexpr std::uint_least64_t radix2 = Radix * Radix, radix4 = radix2 * radix2;
+    digits = (digits * Radix + (digits >> 8)) & 0x00FF'00FF'00FF'00FF;
+    digits = (digits * radix2 + (digits >> 16)) & 0x0000'FFFF'0000'FFFF;
+    digits = (digits * radix4 + (digits >> 32)) & 0x0000'0000'FFFF'FFFF;
+    return digits;
+}
+
+// Adds the eight digits converted by _swar_integer_value() without checking for overflow.
+template <typename Traits, unsigned Radix>
+constexpr void _swar_integer_add(typename Traits::type& result, std::uint_least64_t digits)
+{
+    constexpr std::uint_least64_t radix4 = Radix * Radix * Radix * Radix;
+    if constexpr (radix4 * radix4 <= INT_MAX)
+    {
+        Traits::template add_digit_unchecked<int(radix4 * radix4)>(result, unsigned(digits));
+    }
+    else
+    {
+        Traits::template add_digit_unchecked<int(radix4)>(result, unsigned(digits / radix4));
+        Traits::template add_digit_unchecked<int(radix4)>(result, unsigned(digits % radix4));
+    }
+}
+
 // Parses T in the Base without checking for overflow.
-template <typename T, typename Base>
+template <typename T, typename Base, bool AssumeOnlyDigits = false>
 struct _unbounded_integer_parser
 {
     using traits = lexy::integer_traits<T>;
@@ -254,6 +330,21 @@ struct _unbounded_integer_parser
     {
         typename traits::type value(0);
 
+        // Parse eight digits at a time while possible.
+        if constexpr (_integer_use_swar<T, Base, Iterator>)
+        {
+            using char_type = std::remove_cv_t<std::remove_pointer_t<Iterator>>;
+            while (end - cur >= 8)
+            {
+                auto chars = _swar_integer_load(cur);
+                if (!AssumeOnlyDigits && !Base::template swar_matches<char_type>(chars))
+                    break;
+
+                _swar_integer_add<traits, radix>(value, _swar_integer_value<radix>(chars));
+                cur += 8;
+            }
+        }
+
         // Just parse digits until we've run out of digits.
         while (cur != end)
         {
@@ -303,12 +394,49 @@ struct _bounded_integer_parser
                 break;
         }
 
+        if constexpr (_integer_use_swar<T, Base, Iterator> && max_digit_count > 9)
+        {
+            // Long numbers are parsed eight digits at a time, starting with the first digit.
+            if (end - cur >= 7)
+                return _parse_swar(cur - 1, end);
+        }
+
         // At this point, we've parsed exactly one non-zero digit, so we can assign.
         auto value = typename traits::type(first_digit);
+        return _parse_remaining(value, 1, cur, end);
+    }
+
+private:
+    template <typename Iterator>
+    static constexpr result_type _parse_swar(Iterator cur, Iterator end)
+    {
+        using char_type = std::remove_cv_t<std::remove_pointer_t<Iterator>>;
+
+        auto        value       = typename traits::type(0);
+        std::size_t digit_count = 0;
+        // As long as there are fewer digits than the maximum, the value can't overflow.
+        while (digit_count + 8 < max_digit_count && end - cur >= 8)
+        {
+            auto chars = _swar_integer_load(cur);
+            if (!AssumeOnlyDigits && !Base::template swar_matches<char_type>(chars))
+                break;
 
+            _swar_integer_add<traits, radix>(value, _swar_integer_value<radix>(chars));
+            cur += 8;
+            digit_count += 8;
+        }
+
+        return _parse_remaining(value, digit_count, cur, end);
+    }
+
+    template <typename Iterator>
+    LEXY_FORCE_INLINE static constexpr result_type _parse_remaining(typename traits::type value,
+                                                                    std::size_t digit_count,
+                                                                    Iterator cur, Iterator end)
+    {
         // Handle at most the number of remaining digits.
         // Due to the fixed loop count, it is most likely unrolled.
-        for (std::size_t digit_count = 1; digit_count < max_digit_count; ++digit_count)
+        for (; digit_count < max_digit_count; ++digit_count)
         {
             // Find the next digit.
             auto digit = 0u;
@@ -344,7 +472,7 @@ struct _bounded_integer_parser
 template <typename T, typename Base, bool AssumeOnlyDigits>
 using _integer_parser
     = std::conditional_t<_is_bounded<T>, _bounded_integer_parser<T, Base, AssumeOnlyDigits>,
-                         _unbounded_integer_parser<T, Base>>;
+                         _unbounded_integer_parser<T, Base, AssumeOnlyDigits>>;
 
 template <typename T, typename Digits>
 struct _integer_parser_digits;
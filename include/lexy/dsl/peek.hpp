@@ -39,10 +39,12 @@ struct _peek : branch_base
         typename Reader::iterator begin;
         typename Reader::marker   end;
 
-        constexpr bool try_parse(const void*, Reader reader)
+        template <typename ControlBlock>
+        constexpr bool try_parse(const ControlBlock* cb, Reader reader)
         {
             // We need to match the entire rule.
             lexy::token_parser_for<decltype(lexy::dsl::token(Rule{})), Reader> parser(reader);
+            _token_use_memo(parser, cb);
 
             begin       = reader.position();
             auto result = parser.try_parse(reader);
@@ -100,10 +102,12 @@ struct _peekn : branch_base
         typename Reader::iterator begin;
         typename Reader::marker   end;
 
-        constexpr bool try_parse(const void*, Reader reader)
+        template <typename ControlBlock>
+        constexpr bool try_parse(const ControlBlock* cb, Reader reader)
         {
             // We must not match the rule.
             lexy::token_parser_for<decltype(lexy::dsl::token(Rule{})), Reader> parser(reader);
+            _token_use_memo(parser, cb);
 
             begin       = reader.position();
             auto result = !parser.try_parse(reader);
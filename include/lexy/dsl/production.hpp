@@ -31,6 +31,10 @@ template <typename ProductionParser, typename Context, typename Reader>
     return parser.template finish<lexy::_detail::final_parser>(context, reader);
 }
 
+// The key of a memoized production parsed with the whitespace rule of WhitespaceProduction.
+template <typename Production, typename WhitespaceProduction>
+inline constexpr char _memo_key_holder = 0;
+
 template <typename Production>
 struct _prd
 // If the production defines whitespace, it can't be a branch production.
@@ -42,11 +46,111 @@ struct _prd
     {
         template <typename Context, typename Reader, typename... Args>
         LEXY_PARSER_FUNC static bool parse(Context& context, Reader& reader, Args&&... args)
+        {
+            if constexpr (lexy::is_memoized_production<Production>
+                          && lexy::_detail::is_random_access_iterator<typename Reader::iterator>)
+                return _memo_parse(context, reader, LEXY_FWD(args)...);
+            else
+                return _parse(context, reader, _no_memo{}, LEXY_FWD(args)...);
+        }
+
+        struct _no_memo
+        {
+            template <typename Reader>
+            constexpr void operator()(bool, const Reader&) const
+            {}
+        };
+
+        template <typename Context, typename Reader, typename... Args>
+        static bool _memo_parse(Context& context, Reader& reader, Args&&... args)
+        {
+            using memo_table   = lexy::_detail::memo_table<Reader>;
+            auto control_block = context.control_block;
+            if (control_block->memo == nullptr)
+            {
+                // We're the outermost memoized production.
+                // As parsing continues inside of us, the table is kept until the end of the parse.
+                memo_table table(reader.position());
+                control_block->memo = &table;
+                auto result         = _memo_parse(context, reader, LEXY_FWD(args)...);
+                control_block->memo = nullptr;
+                return result;
+            }
+
+            if constexpr (lexy::_handler_memoizes_productions<typename Context::handler_type>)
+            {
+                // Context variables and disabled whitespace skipping aren't part of the key.
+                if (!lexy::_can_reuse_production(context))
+                    return _parse(context, reader, _no_memo{}, LEXY_FWD(args)...);
+
+                auto& table = *static_cast<memo_table*>(control_block->memo);
+
+                // The result also depends on the whitespace rule.
+                using sub_context_t = decltype(context.sub_context(Production{}));
+                auto key            = static_cast<const void*>(
+                    &_memo_key_holder<Production, typename sub_context_t::whitespace_production>);
+
+                auto begin = reader.position();
+                if (auto entry = table.lookup(key, begin))
+                {
+                    auto sub_context = context.sub_context(Production{});
+                    sub_context.on(_ev::production_start{}, begin);
+                    if (!entry->success)
+                    {
+                        // We need to report an error, so the match fails even if it recovers.
+                        auto err = lexy::error<Reader, void>(begin, "memoized production failed");
+                        sub_context.on(_ev::error{}, err);
+                        sub_context.on(_ev::production_cancel{}, begin);
+                        return false;
+                    }
+
+                    reader.reset(entry->end);
+                    sub_context.on(_ev::production_finish{}, reader.position());
+
+                    using continuation = lexy::_detail::context_finish_parser<NextParser>;
+                    return continuation::parse(context, reader, sub_context, LEXY_FWD(args)...);
+                }
+
+                // If an error has been reported before, we can't tell whether the production
+                // has reported one, so we don't memoize it.
+                if (control_block->parse_handler._has_failed())
+                    return _parse(context, reader, _no_memo{}, LEXY_FWD(args)...);
+
+                // A production that has reported an error didn't match, even if it recovered.
+                auto memo = [&](bool success, const Reader& end) {
+                    success = success && !control_block->parse_handler._has_failed();
+                    table.insert(key, begin, success, end.current());
+                };
+                return _parse(context, reader, memo, LEXY_FWD(args)...);
+            }
+            else
+            {
+                return _parse(context, reader, _no_memo{}, LEXY_FWD(args)...);
+            }
+        }
+
+        // Memo is invoked with the result of the production before parsing continues.
+        template <typename Context, typename Reader, typename Memo, typename... Args>
+        LEXY_PARSER_FUNC static bool _parse(Context& context, Reader& reader, Memo memo,
+                                            Args&&... args)
         {
             // Create a context for the production and parse the context there.
             auto sub_context = context.sub_context(Production{});
             sub_context.on(_ev::production_start{}, reader.position());
 
+            // Skip the production entirely if the handler still has it from a previous parse.
+            if constexpr (lexy::_handler_reuses_productions<typename Context::handler_type>)
+            {
+                if (lexy::_can_reuse_production(sub_context)
+                    && sub_context.on(_ev::production_reuse{}, reader))
+                {
+                    sub_context.on(_ev::production_finish{}, reader.position());
+
+                    using continuation = lexy::_detail::context_finish_parser<NextParser>;
+                    return continuation::parse(context, reader, sub_context, LEXY_FWD(args)...);
+                }
+            }
+
             // Skip initial whitespace if the rule changed.
             if constexpr (lexy::_production_defines_whitespace<Production>)
             {
@@ -54,6 +158,7 @@ struct _prd
                                              lexy::pattern_parser<>>::parse(sub_context, reader))
                 {
                     sub_context.on(_ev::production_cancel{}, reader.position());
+                    memo(false, reader);
                     return false;
                 }
             }
@@ -61,6 +166,7 @@ struct _prd
             if (_parse_production<Production>(sub_context, reader))
             {
                 sub_context.on(_ev::production_finish{}, reader.position());
+                memo(true, reader);
 
                 using continuation = lexy::_detail::context_finish_parser<NextParser>;
                 return continuation::parse(context, reader, sub_context, LEXY_FWD(args)...);
@@ -69,6 +175,7 @@ struct _prd
             {
                 // Cancel.
                 sub_context.on(_ev::production_cancel{}, reader.position());
+                memo(false, reader);
                 return false;
             }
         }
@@ -105,6 +212,20 @@ struct _prd
             // Finish the production in a new context.
             auto sub_context = context.sub_context(Production{});
             sub_context.on(_ev::production_start{}, begin);
+            if constexpr (lexy::_handler_reuses_productions<typename Context::handler_type>)
+            {
+                // The branch condition has already been checked, but the rest can still be skipped.
+                if (lexy::_can_reuse_production(sub_context)
+                    && sub_context.on(_ev::production_reuse{}, reader))
+                {
+                    parser.cancel(sub_context);
+                    sub_context.on(_ev::production_finish{}, reader.position());
+
+                    using continuation = lexy::_detail::context_finish_parser<NextParser>;
+                    return continuation::parse(context, reader, sub_context, LEXY_FWD(args)...);
+                }
+            }
+
             if (_finish_production(parser, sub_context, reader))
             {
                 sub_context.on(_ev::production_finish{}, reader.position());
@@ -167,6 +288,17 @@ struct _recb : branch_base
             return true;
         }
 
+        // Runs the recursive parse, on a new stack segment if the current one is used up.
+        template <typename Context, typename Fn>
+        static constexpr bool call(Context& context, Fn fn)
+        {
+            auto segments = context.control_block->segments;
+            if (segments != nullptr && segments->exhausted())
+                return segments->call(fn);
+            else
+                return fn();
+        }
+
         template <typename Context, typename Reader, typename... Args>
         LEXY_PARSER_FUNC static bool parse(Context& context, Reader& reader, Args&&... args)
         {
@@ -202,7 +334,10 @@ struct _recb : branch_base
             using depth = _depth_handler<NextParser>;
             if (!depth::increment_depth(context, reader))
                 return false;
-            return _impl.template finish<depth>(context, reader, LEXY_FWD(args)...);
+
+            return depth::call(context, [&] {
+                return _impl.template finish<depth>(context, reader, LEXY_FWD(args)...);
+            });
         }
     };
 
@@ -216,8 +351,10 @@ struct _recb : branch_base
             if (!depth::increment_depth(context, reader))
                 return false;
 
-            return lexy::parser_for<_prd<Production>, depth>::parse(context, reader,
-                                                                    LEXY_FWD(args)...);
+            return depth::call(context, [&] {
+                return lexy::parser_for<_prd<Production>, depth>::parse(context, reader,
+                                                                        LEXY_FWD(args)...);
+            });
         }
     };
 
@@ -72,8 +72,10 @@ struct _subg : rule_base
             using handler_type       = typename control_block_type::handler_type;
             using state_type         = typename control_block_type::state_type;
 
-            auto vars                   = context.control_block->vars;
-            context.control_block->vars = nullptr;
+            auto vars                        = context.control_block->vars;
+            auto var_slots                   = context.control_block->var_slots;
+            context.control_block->vars      = nullptr;
+            context.control_block->var_slots = {};
 
             constexpr auto production_uses_void_callback = std::is_same_v<
                 typename handler_type::template value_callback<Production, state_type>,
@@ -87,7 +89,8 @@ struct _subg : rule_base
                 = subgrammar_traits::template parse<value_type>(value, context.control_block,
                                                                 reader);
 
-            context.control_block->vars = vars;
+            context.control_block->vars      = vars;
+            context.control_block->var_slots = var_slots;
 
             if (!rule_result)
                 return false;
@@ -282,9 +282,10 @@ struct _sym : branch_base
         {
             // Try and parse the token.
             lexy::token_parser_for<Token, Reader> parser(reader);
-            if (!parser.try_parse(reader))
+            auto                                  result = parser.try_parse(reader);
+            end                                          = parser.end;
+            if (!result)
                 return false;
-            end = parser.end;
 
             // Check whether this is a symbol.
             auto content = lexy::partial_input(reader, end.position());
@@ -295,8 +296,10 @@ struct _sym : branch_base
         }
 
         template <typename Context>
-        constexpr void cancel(Context&)
-        {}
+        constexpr void cancel(Context& context)
+        {
+            context.on(_ev::lookahead{}, end.position());
+        }
 
         template <typename NextParser, typename Context, typename... Args>
         LEXY_PARSER_FUNC bool finish(Context& context, Reader& reader, Args&&... args)
@@ -375,17 +378,19 @@ struct _sym<Table, _idp<L, T>, Tag> : branch_base
         {
             // Try to parse a symbol.
             symbol = Table.try_parse(reader);
+            end    = reader.current();
             if (!symbol)
                 return false;
-            end = reader.current();
 
             // We had a symbol, but it must not be the prefix of a valid identifier.
             return !lexy::try_match_token(T{}, reader);
         }
 
         template <typename Context>
-        constexpr void cancel(Context&)
-        {}
+        constexpr void cancel(Context& context)
+        {
+            context.on(_ev::lookahead{}, end.position());
+        }
 
         template <typename NextParser, typename Context, typename... Args>
         LEXY_PARSER_FUNC bool finish(Context& context, Reader& reader, Args&&... args)
@@ -473,8 +478,10 @@ struct _sym<Table, void, Tag> : branch_base
         }
 
         template <typename Context>
-        constexpr void cancel(Context&)
-        {}
+        constexpr void cancel(Context& context)
+        {
+            context.on(_ev::lookahead{}, end.position());
+        }
 
         template <typename NextParser, typename Context, typename... Args>
         LEXY_PARSER_FUNC bool finish(Context& context, Reader& reader, Args&&... args)
@@ -22,6 +22,20 @@ struct missing_token
 //=== token_base ===//
 namespace lexyd
 {
+template <typename TokenParser>
+using _detect_token_memo = decltype(TokenParser::memo);
+
+// Token parsers that parse productions can use the memo table of the current parse,
+// see `lexy::memoized_production`.
+template <typename TokenParser, typename ControlBlock>
+constexpr void _token_use_memo(TokenParser& parser, const ControlBlock* cb)
+{
+    if constexpr (lexy::_detail::is_detected<_detect_token_memo, TokenParser>)
+        parser.memo = cb->memo;
+    else
+        (void)cb;
+}
+
 template <typename Tag, typename Token>
 struct _toke;
 template <auto Kind, typename Token>
@@ -48,17 +62,22 @@ struct token_base : _token_inherit<ImplOrTag>
     {
         typename Reader::marker end;
 
-        constexpr auto try_parse(const void*, const Reader& reader)
+        template <typename ControlBlock>
+        constexpr auto try_parse(const ControlBlock* cb, const Reader& reader)
         {
             lexy::token_parser_for<Derived, Reader> parser(reader);
-            auto                                    result = parser.try_parse(reader);
-            end                                            = parser.end;
+            _token_use_memo(parser, cb);
+            auto result = parser.try_parse(reader);
+            end         = parser.end;
             return result;
         }
 
         template <typename Context>
-        constexpr void cancel(Context&)
-        {}
+        constexpr void cancel(Context& context)
+        {
+            // The token has looked at the input until the point it stopped matching.
+            context.on(_ev::lookahead{}, end.position());
+        }
 
         template <typename NextParser, typename Context, typename... Args>
         LEXY_PARSER_FUNC bool finish(Context& context, Reader& reader, Args&&... args)
@@ -75,6 +94,7 @@ struct token_base : _token_inherit<ImplOrTag>
     {
         auto                                    begin = reader.position();
         lexy::token_parser_for<Derived, Reader> parser(reader);
+        _token_use_memo(parser, context.control_block);
 
         using try_parse_result = decltype(parser.try_parse(reader));
         if constexpr (std::is_same_v<try_parse_result, std::true_type>)
@@ -186,8 +206,9 @@ struct _token : token_base<_token<Rule>>
     struct tp
     {
         typename Reader::marker end;
+        void*                   memo;
 
-        constexpr explicit tp(const Reader& reader) : end(reader.current()) {}
+        constexpr explicit tp(const Reader& reader) : end(reader.current()), memo(nullptr) {}
 
         constexpr bool try_parse(Reader reader)
         {
@@ -196,7 +217,7 @@ struct _token : token_base<_token<Rule>>
                 _production,
                 lexy::match_action<void, Reader>::template result_type>(lexy::_mh(),
                                                                         lexy::no_parse_state,
-                                                                        reader);
+                                                                        reader, memo);
             end = reader.current();
             return success;
         }
@@ -21,6 +21,8 @@ constexpr void _until_swar([[maybe_unused]] Reader& reader)
         // We use SWAR to skip characters until we have one that is <= 0xF or EOF.
         // Then we need to inspect it in more detail.
         using char_type = typename Reader::encoding::char_type;
+        reader.bump_simd_until(
+            lexy::_detail::simd_stop_chars<char_type, 0xF, Reader::encoding::eof()>{});
 
         while (true)
         {
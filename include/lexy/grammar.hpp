@@ -168,6 +168,15 @@ struct transparent_production
 template <typename Production>
 constexpr bool is_transparent_production = std::is_base_of_v<transparent_production, Production>;
 
+/// Base class to indicate that the result of matching this production should be memoized.
+/// If it is matched at the same position again, e.g. by multiple `dsl::peek()`, the previous
+/// result is used instead.
+struct memoized_production
+{};
+
+template <typename Production>
+constexpr bool is_memoized_production = std::is_base_of_v<memoized_production, Production>;
+
 template <typename Production>
 LEXY_CONSTEVAL const char* production_name()
 {
@@ -186,6 +195,18 @@ LEXY_CONSTEVAL std::size_t max_recursion_depth()
         return 1024; // Arbitrary power of two.
 }
 
+template <typename Production>
+using _detect_stack_segment_size = decltype(Production::stack_segment_size);
+
+template <typename EntryProduction>
+LEXY_CONSTEVAL std::size_t stack_segment_size()
+{
+    if constexpr (_detail::is_detected<_detect_stack_segment_size, EntryProduction>)
+        return EntryProduction::stack_segment_size;
+    else
+        return 0; // Recursion happens on the current stack.
+}
+
 template <typename T>
 using _enable_production_or_operation = std::enable_if_t<is_production<T> || is_operation<T>>;
 
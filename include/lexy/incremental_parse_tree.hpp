@@ -0,0 +1,509 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_INCREMENTAL_PARSE_TREE_HPP_INCLUDED
+#define LEXY_INCREMENTAL_PARSE_TREE_HPP_INCLUDED
+
+#include <cstring>
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/grammar.hpp>
+#include <lexy/parse_tree.hpp>
+#include <lexy/token.hpp>
+
+//=== internal: ipt_entries ===//
+namespace lexy::_detail
+{
+// Everything we need to know to decide whether a production can be reused.
+// All positions are offsets from the beginning of the input.
+template <typename Reader>
+struct ipt_entry
+{
+    pt_node_production<Reader>* node;
+    std::size_t                 begin, end;
+    // One past the last code unit the parser has looked at while parsing the production.
+    std::size_t lookahead;
+    // The entries of the nested productions immediately follow it.
+    std::size_t nested_count;
+    // The production (or a nested one) has reported an error, which needs to be reported again.
+    bool has_error;
+};
+
+// The entries of all productions of a tree in pre-order, i.e. sorted by their beginning.
+template <typename Reader, typename MemoryResource>
+class ipt_entries
+{
+    using resource_ptr = _detail::memory_resource_ptr<MemoryResource>;
+    using entry        = ipt_entry<Reader>;
+
+    static constexpr std::size_t initial_capacity = 4096 / sizeof(entry);
+
+public:
+    //=== constructors/destructors/assignment ===//
+    explicit constexpr ipt_entries(MemoryResource* resource) noexcept
+    : _resource(resource), _data(nullptr), _size(0), _capacity(0)
+    {}
+
+    ipt_entries(ipt_entries&& other) noexcept
+    : _resource(other._resource), _data(other._data), _size(other._size),
+      _capacity(other._capacity)
+    {
+        other._data     = nullptr;
+        other._size     = 0;
+        other._capacity = 0;
+    }
+
+    ~ipt_entries() noexcept
+    {
+        if (_data != nullptr)
+            _resource->deallocate(_data, _capacity * sizeof(entry), alignof(entry));
+    }
+
+    ipt_entries& operator=(ipt_entries&& other) noexcept
+    {
+        lexy::_detail::swap(_resource, other._resource);
+        lexy::_detail::swap(_data, other._data);
+        lexy::_detail::swap(_size, other._size);
+        lexy::_detail::swap(_capacity, other._capacity);
+        return *this;
+    }
+
+    //=== access ===//
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    entry& operator[](std::size_t idx) noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _data[idx];
+    }
+
+    // Returns the index of the first entry that doesn't begin before `pos`.
+    std::size_t lower_bound(std::size_t pos) const noexcept
+    {
+        auto first = std::size_t(0);
+        auto count = _size;
+        while (count > 0)
+        {
+            auto step = count / 2;
+            if (_data[first + step].begin < pos)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    //=== modifiers ===//
+    void push_back(const entry& e)
+    {
+        if (_size == _capacity)
+            _grow();
+
+        ::new (static_cast<void*>(_data + _size)) entry(e);
+        ++_size;
+    }
+
+    // Removes all entries starting at idx.
+    void truncate(std::size_t idx) noexcept
+    {
+        LEXY_PRECONDITION(idx <= _size);
+        _size = idx;
+    }
+
+    // Removes all entries, but keeps the memory.
+    void clear() noexcept
+    {
+        _size = 0;
+    }
+
+private:
+    void _grow()
+    {
+        auto new_capacity = _capacity == 0 ? initial_capacity : 2 * _capacity;
+        auto memory       = _resource->allocate(new_capacity * sizeof(entry), alignof(entry));
+        if (_data != nullptr)
+        {
+            std::memcpy(memory, static_cast<void*>(_data), _size * sizeof(entry));
+            _resource->deallocate(_data, _capacity * sizeof(entry), alignof(entry));
+        }
+
+        _data     = static_cast<entry*>(memory);
+        _capacity = new_capacity;
+    }
+
+    LEXY_EMPTY_MEMBER resource_ptr _resource;
+    entry*                         _data;
+    std::size_t                    _size, _capacity;
+};
+} // namespace lexy::_detail
+
+//=== incremental_parse_tree ===//
+namespace lexy
+{
+/// A parse tree that remembers which part of the input each production depends on.
+/// After an edit of the input, it can be updated by `lexy::parse_as_tree()`, which reuses every
+/// production that isn't affected by the edit instead of parsing it again.
+template <typename Reader, typename TokenKind = void, typename MemoryResource = void>
+class incremental_parse_tree
+{
+    static_assert(lexy::is_char_encoding<typename Reader::encoding>);
+    static_assert(_detail::is_random_access_iterator<typename Reader::iterator>,
+                  "incremental_parse_tree requires random access iterators");
+
+    using _entries_t = _detail::ipt_entries<Reader, MemoryResource>;
+
+public:
+    using tree_type = lexy::parse_tree<Reader, TokenKind, MemoryResource>;
+
+    //=== construction ===//
+    class builder;
+
+    constexpr incremental_parse_tree()
+    : incremental_parse_tree(_detail::get_memory_resource<MemoryResource>())
+    {}
+    constexpr explicit incremental_parse_tree(MemoryResource* resource)
+    : _tree(resource), _spare(resource), _entries(resource), _spare_entries(resource), _begin(),
+      _edit_offset(0), _edit_old_size(0), _edit_new_size(0), _edited(false), _reused(0)
+    {}
+
+    //=== container access ===//
+    bool empty() const noexcept
+    {
+        return _tree.empty();
+    }
+
+    const tree_type& tree() const noexcept
+    {
+        return _tree;
+    }
+
+    void clear() noexcept
+    {
+        _tree.clear();
+        _entries.clear();
+        _edited = false;
+        _reused = 0;
+    }
+
+    //=== incremental parsing ===//
+    /// Records that the `old_size` code units at `offset` have been replaced by `new_size` code
+    /// units. The next `lexy::parse_as_tree()` with the edited input reuses unaffected productions.
+    ///
+    /// Multiple edits are merged into a single edit that covers all of them.
+    void edit(std::size_t offset, std::size_t old_size, std::size_t new_size) noexcept
+    {
+        if (!_edited)
+        {
+            _edit_offset   = offset;
+            _edit_old_size = old_size;
+            _edit_new_size = new_size;
+            _edited        = true;
+            return;
+        }
+
+        // The previous edit replaced [b1, b1 + o1) by n1 code units.
+        // We're replacing [b2, b2 + o2) of the result by n2 code units.
+        auto b1 = _edit_offset;
+        auto o1 = _edit_old_size;
+        auto n1 = _edit_new_size;
+        auto b2 = offset;
+        auto o2 = old_size;
+        auto n2 = new_size;
+
+        // In between both edits, [begin, end) covers everything either edit has touched.
+        // end is after the first edit, so it corresponds to end - n1 + o1 in the original input,
+        // and after the second edit, so it corresponds to end - o2 + n2 in the final input.
+        auto begin = b1 < b2 ? b1 : b2;
+        auto end   = b1 + n1 > b2 + o2 ? b1 + n1 : b2 + o2;
+
+        _edit_offset   = begin;
+        _edit_old_size = end - n1 + o1 - begin;
+        _edit_new_size = end - o2 + n2 - begin;
+    }
+
+    /// The number of productions that have been reused by the last parse.
+    std::size_t reused_count() const noexcept
+    {
+        return _reused;
+    }
+
+private:
+    tree_type                 _tree, _spare;
+    _entries_t                _entries, _spare_entries;
+    typename Reader::iterator _begin;
+    std::size_t               _edit_offset, _edit_old_size, _edit_new_size;
+    bool                      _edited;
+    std::size_t               _reused;
+};
+
+template <typename Input, typename TokenKind = void, typename MemoryResource = void>
+using incremental_parse_tree_for
+    = lexy::incremental_parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>;
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+struct _parse_tree_traits<incremental_parse_tree<Reader, TokenKind, MemoryResource>>
+{
+    using reader          = Reader;
+    using token_kind      = TokenKind;
+    using memory_resource = MemoryResource;
+};
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+class incremental_parse_tree<Reader, TokenKind, MemoryResource>::builder
+{
+    using iterator = typename Reader::iterator;
+    using entry    = _detail::ipt_entry<Reader>;
+
+    static constexpr auto no_entry = std::size_t(-1);
+
+public:
+    // Asks `lexy::parse_as_tree()` to send the events required for incremental parsing.
+    static constexpr bool reuses_productions = true;
+
+    class marker
+    {
+    public:
+        marker() : _entry(no_entry), _lookahead(0), _has_error(false), _production(false) {}
+
+    private:
+        explicit marker(typename tree_type::builder::marker&& m, std::size_t entry,
+                        std::size_t lookahead, bool has_error, bool production)
+        : _marker(LEXY_MOV(m)), _entry(entry), _lookahead(lookahead), _has_error(has_error),
+          _production(production)
+        {}
+
+        typename tree_type::builder::marker _marker;
+        // For a production, the state of the parent production we have to restore.
+        // For a container, _entry is the number of entries when it was started.
+        std::size_t _entry, _lookahead;
+        bool        _has_error;
+        bool        _production;
+
+        friend builder;
+    };
+
+    //=== root node ===//
+    explicit builder(incremental_parse_tree&& tree, production_info production, iterator begin)
+    : _result(LEXY_MOV(tree)), _builder(LEXY_MOV(_result._spare), production),
+      _entries(LEXY_MOV(_result._spare_entries)), _begin(begin), _entry(no_entry),
+      _lookahead(0), _has_error(false), _reused(0)
+    {
+        _entries.clear();
+    }
+
+    incremental_parse_tree&& finish(lexy::lexeme<Reader> remaining_input) &&
+    {
+        // Keep the memory of the old tree around for the next parse.
+        _result._spare         = LEXY_MOV(_result._tree);
+        _result._spare_entries = LEXY_MOV(_result._entries);
+
+        _result._tree    = LEXY_MOV(_builder).finish(remaining_input);
+        _result._entries = LEXY_MOV(_entries);
+        _result._begin   = _begin;
+        _result._edited  = false;
+        _result._reused  = _reused;
+        return LEXY_MOV(_result);
+    }
+
+    //=== production nodes ===//
+    marker start_production(production_info production, iterator pos)
+    {
+        auto m = _builder.start_production(production);
+        if (production.is_transparent)
+            // Everything belongs to the parent production.
+            return marker(LEXY_MOV(m), 0, 0, false, false);
+
+        auto result = marker(LEXY_MOV(m), _entry, _lookahead, _has_error, true);
+
+        auto begin = _offset(pos);
+        _entry     = _entries.size();
+        _lookahead = begin;
+        _has_error = false;
+        _entries.push_back(entry{_builder._current_production(), begin, begin, begin, 0, false});
+        return result;
+    }
+
+    void finish_production(marker&& m, iterator pos)
+    {
+        _builder.finish_production(LEXY_MOV(m._marker));
+        if (!m._production)
+            return;
+
+        auto& e        = _entries[_entry];
+        e.end          = _offset(pos);
+        e.lookahead    = _lookahead;
+        e.nested_count = _entries.size() - _entry - 1;
+        e.has_error    = _has_error;
+        _restore(m);
+    }
+
+    void cancel_production(marker&& m)
+    {
+        _builder.cancel_production(LEXY_MOV(m._marker));
+        if (!m._production)
+            return;
+
+        _entries.truncate(_entry);
+        _restore(m);
+    }
+
+    //=== container nodes ===//
+    marker start_container()
+    {
+        return marker(_builder.start_container(), _entries.size(), 0, false, false);
+    }
+
+    void set_container_production(production_info production)
+    {
+        _builder.set_container_production(production);
+    }
+
+    void finish_container(marker&& m)
+    {
+        _builder.finish_container(LEXY_MOV(m._marker));
+    }
+
+    void cancel_container(marker&& m)
+    {
+        _builder.cancel_container(LEXY_MOV(m._marker));
+        _entries.truncate(m._entry);
+    }
+
+    //=== token nodes ===//
+    void token(token_kind<TokenKind> kind, iterator begin, iterator end)
+    {
+        _builder.token(kind, begin, end);
+        // The parser had to look at the next code unit to know that the token ends.
+        lookahead(end);
+    }
+
+    //=== accessors ===//
+    std::size_t current_child_count() const noexcept
+    {
+        return _builder.current_child_count();
+    }
+
+    //=== incremental parsing ===//
+    // The parser has looked at the code unit at pos.
+    void lookahead(iterator pos) noexcept
+    {
+        auto offset = _offset(pos) + 1;
+        if (_lookahead < offset)
+            _lookahead = offset;
+    }
+
+    // The parser has reported an error at pos.
+    void error(iterator pos) noexcept
+    {
+        lookahead(pos);
+        _has_error = true;
+    }
+
+    // Tries to reuse the production that has just been started from the previous tree.
+    // If successful, the reader is advanced to its end.
+    bool reuse(production_info production, Reader& reader)
+    {
+        if (!_result._edited || _result.empty() || production.is_transparent)
+            return false;
+
+        auto edit_begin = _result._edit_offset;
+        auto old_size   = _result._edit_old_size;
+        auto new_size   = _result._edit_new_size;
+
+        // Find the corresponding position in the previous input.
+        auto pos          = _offset(reader.position());
+        auto before_edit  = pos < edit_begin;
+        auto old_position = pos;
+        if (!before_edit)
+        {
+            if (pos < edit_begin + new_size)
+                // The production begins inside the edit.
+                return false;
+            old_position = pos - new_size + old_size;
+        }
+
+        auto& old_entries = _result._entries;
+        auto  idx         = old_entries.lower_bound(old_position);
+        while (idx != old_entries.size() && old_entries[idx].begin == old_position
+               && old_entries[idx].node->id != production.id)
+            ++idx;
+        if (idx == old_entries.size() || old_entries[idx].begin != old_position)
+            return false;
+
+        // It must not have looked at the edit.
+        // If it's after the edit, it can't have looked at it as we never go backwards.
+        auto old_entry = old_entries[idx];
+        if (old_entry.has_error || (before_edit && old_entry.lookahead > edit_begin))
+            return false;
+
+        // Positions after the edit have moved.
+        auto map_offset = [&](std::size_t offset) {
+            return before_edit ? offset : offset - old_size + new_size;
+        };
+        auto map = [&](iterator old) {
+            return _detail::next(_begin, map_offset(std::size_t(old - _result._begin)));
+        };
+
+        // Copy the nodes, and the entries of the nested productions alongside them.
+        auto next_nested   = idx + 1;
+        auto end_nested    = idx + 1 + old_entry.nested_count;
+        auto on_production = [&](_detail::pt_node_production<Reader>* original,
+                                 _detail::pt_node_production<Reader>* copy) {
+            if (next_nested == end_nested || old_entries[next_nested].node != original)
+                return;
+
+            auto nested      = old_entries[next_nested++];
+            nested.node      = copy;
+            nested.begin     = map_offset(nested.begin);
+            nested.end       = map_offset(nested.end);
+            nested.lookahead = map_offset(nested.lookahead);
+            _entries.push_back(nested);
+        };
+        _builder._copy_children(old_entry.node, map, on_production);
+
+        _lookahead = map_offset(old_entry.lookahead);
+        reader.reset({_detail::next(_begin, map_offset(old_entry.end))});
+        ++_reused;
+        return true;
+    }
+
+private:
+    std::size_t _offset(iterator pos) const noexcept
+    {
+        return std::size_t(pos - _begin);
+    }
+
+    void _restore(const marker& m) noexcept
+    {
+        // The parent has looked at everything its child has looked at.
+        if (_lookahead < m._lookahead)
+            _lookahead = m._lookahead;
+        _has_error = _has_error || m._has_error;
+        _entry     = m._entry;
+    }
+
+    // Contains the previous tree and its entries until we're done.
+    incremental_parse_tree      _result;
+    typename tree_type::builder _builder;
+    _entries_t                  _entries;
+    iterator                    _begin;
+
+    // The state of the current production.
+    std::size_t _entry, _lookahead;
+    bool        _has_error;
+
+    std::size_t _reused;
+};
+} // namespace lexy
+
+#endif // LEXY_INCREMENTAL_PARSE_TREE_HPP_INCLUDED
@@ -6,13 +6,35 @@
 
 #include <lexy/_detail/config.hpp>
 #include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/swar.hpp>
 #include <lexy/encoding.hpp>
 
 namespace lexy
 {
+template <typename Encoding, typename Iterator, typename Sentinel>
+class _rr;
+
+// We can use SWAR for a pointer range if EOF fits into a char, as we then can pretend the input
+// was padded.
+// SWAR code isn't constexpr, so we also need to detect whether we're constant evaluated.
+template <typename Encoding, typename Iterator, typename Sentinel>
+constexpr bool _rr_use_swar
+    = LEXY_HAS_IS_CONSTANT_EVALUATED
+      && std::is_same_v<Iterator, const typename Encoding::char_type*>
+      && std::is_same_v<Iterator, Sentinel>
+      && std::is_same_v<typename Encoding::char_type, typename Encoding::int_type>;
+
+struct _rr_no_swar
+{};
+
+template <typename Encoding, typename Iterator, typename Sentinel>
+using _rr_base = std::conditional_t<_rr_use_swar<Encoding, Iterator, Sentinel>,
+                                    _detail::swar_reader_base<_rr<Encoding, Iterator, Sentinel>>,
+                                    _rr_no_swar>;
+
 // A generic reader from an iterator range.
 template <typename Encoding, typename Iterator, typename Sentinel = Iterator>
-class _rr
+class _rr : public _rr_base<Encoding, Iterator, Sentinel>
 {
 public:
     using encoding = Encoding;
@@ -62,6 +84,11 @@ public:
         _cur = m._it;
     }
 
+    constexpr Sentinel swar_end() const noexcept
+    {
+        return _end;
+    }
+
 private:
     Iterator                   _cur;
     LEXY_EMPTY_MEMBER Sentinel _end;
@@ -58,6 +58,12 @@ public:
         _cur = m._it;
     }
 
+    iterator swar_end() const noexcept
+    {
+        // The buffer is padded with EOF.
+        return nullptr;
+    }
+
 private:
     iterator _cur;
 };
@@ -41,6 +41,20 @@ file_error read_file(const char* path, file_callback cb, void* user_data);
 
 // Same as above, but reads from stdin.
 file_error read_stdin(file_callback cb, void* user_data);
+
+struct file_mapping
+{
+    char*       memory;
+    std::size_t size;
+    std::size_t mapping_size;
+};
+
+// Maps the entire contents of the specified file into memory.
+// The mapping is followed by at least `padding` zero bytes that may be written to.
+//
+// Do not change ABI, especially with different build configurations!
+file_error map_file(const char* path, std::size_t padding, file_mapping* mapping);
+void       unmap_file(const file_mapping& mapping) noexcept;
 } // namespace lexy::_detail
 
 namespace lexy
@@ -134,5 +148,160 @@ auto read_stdin(MemoryResource* resource = _detail::get_memory_resource<MemoryRe
 }
 } // namespace lexy
 
+namespace lexy
+{
+/// A buffer whose memory is a mapping of a file.
+/// Like `lexy::buffer`, it has an EOF sentinel and padding for SWAR after the contents.
+template <typename Encoding = default_encoding>
+class mapped_buffer
+{
+    static_assert(lexy::is_char_encoding<Encoding>);
+    static constexpr auto _has_sentinel
+        = std::is_same_v<typename Encoding::char_type, typename Encoding::int_type>;
+
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+    static_assert(sizeof(char_type) == 1, "mapping requires an encoding without byte order");
+
+    //=== constructors ===//
+    constexpr mapped_buffer() noexcept : _mapping{nullptr, 0, 0}, _data(nullptr), _size(0) {}
+
+    mapped_buffer(const mapped_buffer&)            = delete;
+    mapped_buffer& operator=(const mapped_buffer&) = delete;
+
+    mapped_buffer(mapped_buffer&& other) noexcept
+    : _mapping(other._mapping), _data(other._data), _size(other._size)
+    {
+        other._mapping = {nullptr, 0, 0};
+        other._data    = nullptr;
+        other._size    = 0;
+    }
+
+    ~mapped_buffer() noexcept
+    {
+        if (_mapping.memory)
+            _detail::unmap_file(_mapping);
+    }
+
+    mapped_buffer& operator=(mapped_buffer&& other) noexcept
+    {
+        _detail::swap(_mapping, other._mapping);
+        _detail::swap(_data, other._data);
+        _detail::swap(_size, other._size);
+        return *this;
+    }
+
+    //=== access ===//
+    const char_type* data() const noexcept
+    {
+        return _data;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    //=== input ===//
+    auto reader() const& noexcept
+    {
+        if constexpr (_has_sentinel)
+            return _buffer_reader<encoding>(_data);
+        else
+            return _range_reader<encoding>(_data, _data + _size);
+    }
+
+public:
+    // Pretend this doesn't exist.
+    // The mapping needs at least `_padding` bytes of padding.
+    static constexpr auto _padding = sizeof(_detail::swar_int) + _detail::simd_block_size;
+
+    explicit mapped_buffer(const _detail::file_mapping& mapping, std::size_t offset) noexcept
+    : _mapping(mapping), _data(reinterpret_cast<char_type*>(mapping.memory + offset)),
+      _size(mapping.size - offset)
+    {
+        if constexpr (_has_sentinel)
+        {
+            auto end = reinterpret_cast<char_type*>(mapping.memory)
+                       + _detail::round_size_for_swar(mapping.size + 1);
+            for (auto ptr = _data + _size; ptr != end; ++ptr)
+                *ptr = encoding::eof();
+        }
+    }
+
+private:
+    _detail::file_mapping _mapping;
+    char_type*            _data;
+    std::size_t           _size;
+};
+
+template <typename Encoding = default_encoding>
+class map_file_result
+{
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+
+    explicit operator bool() const noexcept
+    {
+        return _ec == file_error::_success;
+    }
+
+    const lexy::mapped_buffer<Encoding>& buffer() const& noexcept
+    {
+        LEXY_PRECONDITION(*this);
+        return _buffer;
+    }
+    lexy::mapped_buffer<Encoding>&& buffer() && noexcept
+    {
+        LEXY_PRECONDITION(*this);
+        return LEXY_MOV(_buffer);
+    }
+
+    file_error error() const noexcept
+    {
+        LEXY_PRECONDITION(!*this);
+        return _ec;
+    }
+
+public:
+    // Pretend this doesn't exist.
+    explicit map_file_result(file_error ec, lexy::mapped_buffer<Encoding>&& buffer) noexcept
+    : _buffer(LEXY_MOV(buffer)), _ec(ec)
+    {}
+
+private:
+    lexy::mapped_buffer<Encoding> _buffer;
+    file_error                    _ec;
+};
+
+/// Maps the file at the specified path into memory without copying it.
+template <typename Encoding          = default_encoding,
+          encoding_endianness Endian = encoding_endianness::bom>
+auto map_file(const char* path) -> map_file_result<Encoding>
+{
+    using buffer_type = lexy::mapped_buffer<Encoding>;
+
+    _detail::file_mapping mapping{nullptr, 0, 0};
+    auto                  error = _detail::map_file(path, buffer_type::_padding, &mapping);
+    if (error != file_error::_success)
+        return map_file_result<Encoding>(error, buffer_type());
+
+    // We just skip over the BOM if there is one, like `lexy::make_buffer_from_raw()`.
+    auto offset = std::size_t(0);
+    if constexpr (Endian == encoding_endianness::bom
+                  && (std::is_same_v<Encoding, utf8_encoding>
+                      || std::is_same_v<Encoding, utf8_char_encoding>))
+    {
+        auto memory = reinterpret_cast<const unsigned char*>(mapping.memory);
+        if (mapping.size >= 3 && memory[0] == 0xEF && memory[1] == 0xBB && memory[2] == 0xBF)
+            offset = 3;
+    }
+
+    return map_file_result<Encoding>(error, buffer_type(mapping, offset));
+}
+} // namespace lexy
+
 #endif // LEXY_INPUT_FILE_HPP_INCLUDED
 
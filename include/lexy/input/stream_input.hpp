@@ -0,0 +1,297 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_INPUT_STREAM_INPUT_HPP_INCLUDED
+#define LEXY_INPUT_STREAM_INPUT_HPP_INCLUDED
+
+#include <cstdio>
+#include <cstring>
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/error.hpp>
+#include <lexy/input/base.hpp>
+#include <lexy/lexeme.hpp>
+#include <new>
+
+namespace lexy
+{
+template <typename Encoding>
+class stream_input;
+
+// The reader of a stream input.
+template <typename Encoding>
+class _sr
+{
+public:
+    using encoding = Encoding;
+    using iterator = typename stream_input<Encoding>::iterator;
+
+    struct marker
+    {
+        iterator _it;
+
+        constexpr iterator position() const noexcept
+        {
+            return _it;
+        }
+    };
+
+    explicit _sr(iterator begin) noexcept : _cur(begin) {}
+
+    // Refilling the window can throw `std::bad_alloc`.
+    auto peek() const
+    {
+        auto input = _cur._input;
+        if (_cur._pos >= input->_end_pos() && !input->_fill(_cur._pos))
+            return encoding::eof();
+        return encoding::to_int_type(*_cur);
+    }
+
+    void bump() noexcept
+    {
+        LEXY_PRECONDITION(peek() != encoding::eof());
+        ++_cur._pos;
+    }
+
+    iterator position() const noexcept
+    {
+        return _cur;
+    }
+
+    marker current() const noexcept
+    {
+        return {_cur};
+    }
+    void reset(marker m) noexcept
+    {
+        LEXY_PRECONDITION(m._it._input == _cur._input);
+        _cur = m._it;
+    }
+
+private:
+    iterator _cur;
+};
+
+/// An input that incrementally reads from a `std::FILE*`, e.g. a pipe or stdin.
+/// Only a window of the input, starting at the last discarded position, is kept in memory.
+template <typename Encoding = default_encoding>
+class stream_input
+{
+    static_assert(lexy::is_char_encoding<Encoding>);
+
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+    static_assert(std::is_trivially_copyable_v<char_type>);
+
+    /// The default number of code units read at once.
+    static constexpr std::size_t default_refill_size = 64 * 1024 / sizeof(char_type);
+
+    /// A stable iterator into the stream.
+    /// It remains valid until the position it points to is discarded.
+    class iterator : public _detail::forward_iterator_base<iterator, const char_type>
+    {
+    public:
+        constexpr iterator() noexcept : _input(nullptr), _pos(0) {}
+
+        const char_type& deref() const noexcept
+        {
+            LEXY_PRECONDITION(_input->_begin_pos() <= _pos && _pos < _input->_end_pos());
+            return _input->_data[_pos - _input->_offset];
+        }
+
+        constexpr void increment() noexcept
+        {
+            ++_pos;
+        }
+
+        constexpr bool equal(iterator rhs) const noexcept
+        {
+            LEXY_PRECONDITION(_input == rhs._input);
+            return _pos == rhs._pos;
+        }
+
+        /// The offset from the beginning of the stream.
+        constexpr std::size_t offset() const noexcept
+        {
+            return _pos;
+        }
+
+        // Random access operations so that lexemes know their size in constant time.
+        friend constexpr std::ptrdiff_t operator-(iterator lhs, iterator rhs) noexcept
+        {
+            return std::ptrdiff_t(lhs._pos) - std::ptrdiff_t(rhs._pos);
+        }
+        friend constexpr iterator operator+(iterator iter, std::size_t n) noexcept
+        {
+            iter._pos += n;
+            return iter;
+        }
+
+        friend constexpr bool operator<(iterator lhs, iterator rhs) noexcept
+        {
+            return lhs._pos < rhs._pos;
+        }
+        friend constexpr bool operator<=(iterator lhs, iterator rhs) noexcept
+        {
+            return lhs._pos <= rhs._pos;
+        }
+        friend constexpr bool operator>(iterator lhs, iterator rhs) noexcept
+        {
+            return lhs._pos > rhs._pos;
+        }
+        friend constexpr bool operator>=(iterator lhs, iterator rhs) noexcept
+        {
+            return lhs._pos >= rhs._pos;
+        }
+
+    private:
+        constexpr explicit iterator(const stream_input* input, std::size_t pos) noexcept
+        : _input(input), _pos(pos)
+        {}
+
+        const stream_input* _input;
+        std::size_t         _pos;
+
+        friend stream_input;
+        friend _sr<Encoding>;
+    };
+
+    //=== constructors ===//
+    /// Reads from `file`, `refill_size` code units at a time.
+    /// `file` is not closed by the input.
+    explicit stream_input(std::FILE* file, std::size_t refill_size = default_refill_size) noexcept
+    : _file(file), _refill_size(refill_size > 0 ? refill_size : 1), _data(nullptr), _capacity(0),
+      _size(0), _offset(0), _discarded(0), _eof(false)
+    {}
+
+    stream_input(const stream_input&)            = delete;
+    stream_input& operator=(const stream_input&) = delete;
+
+    ~stream_input() noexcept
+    {
+        ::operator delete(_data);
+    }
+
+    //=== access ===//
+    /// Releases the input before `pos`; it must not be accessed anymore.
+    /// The memory is re-used for the input read afterwards.
+    void discard(iterator pos) noexcept
+    {
+        LEXY_PRECONDITION(pos._input == this);
+        LEXY_PRECONDITION(_begin_pos() <= pos._pos && pos._pos <= _end_pos());
+        _discarded = pos._pos;
+    }
+
+    /// The number of code units that are currently kept in memory.
+    std::size_t window_size() const noexcept
+    {
+        return _end_pos() - _begin_pos();
+    }
+
+    /// Whether reading from the stream has failed.
+    bool has_error() const noexcept
+    {
+        return std::ferror(_file) != 0;
+    }
+
+    //=== reader ===//
+    /// Returns a reader that starts at the first position that hasn't been discarded.
+    auto reader() const& noexcept
+    {
+        return _sr<Encoding>(iterator(this, _begin_pos()));
+    }
+
+private:
+    std::size_t _begin_pos() const noexcept
+    {
+        return _discarded;
+    }
+    std::size_t _end_pos() const noexcept
+    {
+        return _offset + _size;
+    }
+
+    // Reads more input until `pos` is available.
+    // Returns false if the stream is exhausted before that.
+    bool _fill(std::size_t pos) const
+    {
+        while (pos >= _end_pos())
+            if (!_refill())
+                return false;
+        return true;
+    }
+
+    bool _refill() const
+    {
+        if (_eof)
+            return false;
+
+        if (_capacity - _size < _refill_size)
+        {
+            // Move the window so that it starts at the first position that wasn't discarded.
+            auto discard_count = _discarded - _offset;
+            if (discard_count > 0)
+            {
+                _size -= discard_count;
+                std::memmove(_data, _data + discard_count, _size * sizeof(char_type));
+                _offset = _discarded;
+            }
+
+            // If the window is still too small, the non-discarded input doesn't fit and we need
+            // to grow it.
+            if (_capacity - _size < _refill_size)
+            {
+                auto new_capacity = 2 * _capacity;
+                if (new_capacity < _size + _refill_size)
+                    new_capacity = _size + _refill_size;
+
+                // If this throws, nothing has changed, so the input isn't silently truncated.
+                auto memory
+                    = static_cast<char_type*>(::operator new(new_capacity * sizeof(char_type)));
+                if (_size > 0)
+                    std::memcpy(memory, _data, _size * sizeof(char_type));
+                ::operator delete(_data);
+
+                _data     = memory;
+                _capacity = new_capacity;
+            }
+        }
+
+        auto requested = _capacity - _size;
+        auto count     = std::fread(_data + _size, sizeof(char_type), requested, _file);
+        _size += count;
+        if (count < requested)
+            // The stream is either exhausted or an error occurred.
+            _eof = true;
+
+        return count > 0;
+    }
+
+    std::FILE*  _file;
+    std::size_t _refill_size;
+
+    // The window [_offset, _offset + _size) of the stream is stored in _data.
+    mutable char_type*  _data;
+    mutable std::size_t _capacity;
+    mutable std::size_t _size;
+    mutable std::size_t _offset;
+    // Positions before _discarded can be removed from the window.
+    std::size_t  _discarded;
+    mutable bool _eof;
+
+    friend _sr<Encoding>;
+};
+
+template <typename Encoding = default_encoding>
+using stream_lexeme = lexeme_for<stream_input<Encoding>>;
+
+template <typename Tag, typename Encoding = default_encoding>
+using stream_error = error_for<stream_input<Encoding>, Tag>;
+
+template <typename Encoding = default_encoding>
+using stream_error_context = error_context<stream_input<Encoding>>;
+} // namespace lexy
+
+#endif // LEXY_INPUT_STREAM_INPUT_HPP_INCLUDED
+
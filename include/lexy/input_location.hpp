@@ -4,6 +4,8 @@
 #ifndef LEXY_INPUT_LOCATION_HPP_INCLUDED
 #define LEXY_INPUT_LOCATION_HPP_INCLUDED
 
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/_detail/swar.hpp>
 #include <lexy/dsl/code_point.hpp>
 #include <lexy/dsl/newline.hpp>
 #include <lexy/input/base.hpp>
@@ -298,6 +300,173 @@ constexpr auto get_input_location(const Input&                                 i
 }
 } // namespace lexy
 
+//=== input_line_index ===//
+namespace lexy::_detail
+{
+// Advances the reader to the next '\n' or EOF.
+template <typename Reader>
+void skip_to_newline(Reader& reader)
+{
+    using encoding = typename Reader::encoding;
+    if constexpr (lexy::_detail::is_swar_reader<Reader>)
+    {
+        using char_type = typename encoding::char_type;
+        reader.bump_simd_until(
+            lexy::_detail::simd_stop_chars<char_type, 0, char_type('\n'), encoding::eof()>{});
+
+        while (true)
+        {
+            auto cur = reader.peek_swar();
+            if (swar_has_char<char_type, char_type('\n')>(cur)
+                || swar_has_char<char_type, encoding::eof()>(cur))
+                break;
+            reader.bump_swar();
+        }
+    }
+
+    while (reader.peek() != encoding::eof() && reader.peek() != encoding::to_int_type('\n'))
+        reader.bump();
+}
+} // namespace lexy::_detail
+
+namespace lexy
+{
+/// Stores the beginning of every line of the input.
+/// This allows computing input locations by binary search instead of a linear scan.
+template <typename Input>
+class input_line_index
+{
+    using reader_type = lexy::input_reader<Input>;
+    using encoding    = typename reader_type::encoding;
+    using iterator    = typename reader_type::iterator;
+    using marker      = typename reader_type::marker;
+
+public:
+    //=== constructors ===//
+    explicit input_line_index(const Input& input) : _lines(nullptr), _line_count(1)
+    {
+        static_assert(lexy::is_char_encoding<encoding>);
+        static_assert(lexy::_detail::is_random_access_iterator<iterator>,
+                      "input_line_index requires random access iterators");
+
+        // First count the newlines, so we know how much memory we need.
+        auto reader = input.reader();
+        while (true)
+        {
+            _detail::skip_to_newline(reader);
+            if (reader.peek() == encoding::eof())
+                break;
+
+            reader.bump();
+            ++_line_count;
+        }
+        _end = reader.position();
+
+        // Then remember the beginning of each line.
+        _lines = static_cast<marker*>(
+            _detail::default_memory_resource::allocate(_line_count * sizeof(marker),
+                                                       alignof(marker)));
+
+        reader = input.reader();
+        ::new (static_cast<void*>(_lines)) marker(reader.current());
+        for (auto idx = std::size_t(1); idx != _line_count; ++idx)
+        {
+            _detail::skip_to_newline(reader);
+            reader.bump();
+            ::new (static_cast<void*>(_lines + idx)) marker(reader.current());
+        }
+    }
+
+    input_line_index(const input_line_index&)            = delete;
+    input_line_index& operator=(const input_line_index&) = delete;
+
+    ~input_line_index() noexcept
+    {
+        _detail::default_memory_resource::deallocate(_lines, _line_count * sizeof(marker),
+                                                     alignof(marker));
+    }
+
+    //=== access ===//
+    /// The number of lines, which is always at least one.
+    std::size_t line_count() const noexcept
+    {
+        return _line_count;
+    }
+
+    /// The range of the specified line, including its newline.
+    lexy::lexeme_for<Input> line(unsigned line_nr) const noexcept
+    {
+        LEXY_PRECONDITION(1 <= line_nr && line_nr <= _line_count);
+        auto begin = _lines[line_nr - 1].position();
+        auto end   = line_nr == _line_count ? _end : _lines[line_nr].position();
+        return {begin, end};
+    }
+
+    /// The anchor of the specified line.
+    input_location_anchor<Input> line_anchor(unsigned line_nr) const noexcept
+    {
+        LEXY_PRECONDITION(1 <= line_nr && line_nr <= _line_count);
+        return input_location_anchor<Input>(_lines[line_nr - 1], line_nr);
+    }
+
+    /// The anchor of the line that contains the position.
+    input_location_anchor<Input> anchor(iterator position) const noexcept
+    {
+        // Find the last line that begins at or before position.
+        auto first = std::size_t(0);
+        auto count = _line_count;
+        while (count > 1)
+        {
+            auto half = count / 2;
+            if (_lines[first + half].position() - position <= 0)
+            {
+                first += half;
+                count -= half;
+            }
+            else
+            {
+                count = half;
+            }
+        }
+
+        return line_anchor(static_cast<unsigned>(first + 1));
+    }
+
+private:
+    marker*     _lines;
+    std::size_t _line_count;
+    iterator    _end;
+};
+
+// Whether the lines of the counting strategy end at lexy::dsl::newline,
+// i.e. after a '\n', which is what the index stores.
+template <typename Counting>
+constexpr bool _is_newline_location_counting = false;
+template <>
+constexpr bool _is_newline_location_counting<code_unit_location_counting> = true;
+template <>
+constexpr bool _is_newline_location_counting<code_point_location_counting> = true;
+
+/// The location for a position in the input; the line is found using the index.
+template <typename Counting, typename Input>
+constexpr auto get_input_location(const Input&                                 input,
+                                  typename lexy::input_reader<Input>::iterator position,
+                                  const input_line_index<Input>&               index)
+{
+    static_assert(_is_newline_location_counting<Counting>,
+                  "input_line_index only supports counting strategies whose lines end at newlines");
+    return get_input_location<Counting>(input, position, index.anchor(position));
+}
+template <typename Input>
+constexpr auto get_input_location(const Input&                                 input,
+                                  typename lexy::input_reader<Input>::iterator position,
+                                  const input_line_index<Input>&               index)
+{
+    return get_input_location<_default_location_counting<Input>>(input, position,
+                                                                 index.anchor(position));
+}
+} // namespace lexy
+
 //=== input_line_annotation ===//
 namespace lexy::_detail
 {
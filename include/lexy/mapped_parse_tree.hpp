@@ -0,0 +1,361 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_MAPPED_PARSE_TREE_HPP_INCLUDED
+#define LEXY_MAPPED_PARSE_TREE_HPP_INCLUDED
+
+#include <cstdio>
+#include <cstring>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/detect.hpp>
+#include <lexy/compact_parse_tree.hpp>
+#include <lexy/input/base.hpp>
+
+//=== internal: file format ===//
+namespace lexy::_detail
+{
+// A saved tree starts with this header.
+// It is followed by the node array, the offsets of the production names into the name table,
+// and the name table itself, which contains all names as null-terminated strings.
+// Everything is stored in native byte order.
+// The input size is the end of the remaining input, i.e. the size of the input the tree was built
+// for; it is checked on loading so that a tree isn't used with a different input.
+struct cpt_file_header
+{
+    std::uint_least32_t magic;
+    std::uint_least32_t version;
+    cpt_index           node_count;
+    cpt_index           id_count;
+    cpt_index           names_size;
+    cpt_index           size;
+    cpt_index           depth;
+    cpt_index           input_size;
+};
+
+// "lxpt" in little endian; it won't match if the tree is loaded with a different byte order.
+constexpr std::uint_least32_t cpt_file_magic   = 0x7470786C;
+constexpr std::uint_least32_t cpt_file_version = 2;
+
+static_assert(sizeof(cpt_node) == 4 * sizeof(cpt_index) && sizeof(cpt_index) == 4,
+              "saved parse trees require 32-bit indices");
+static_assert(sizeof(cpt_file_header) == 8 * sizeof(cpt_index));
+
+// Writes the tree by calling `write(data, size)` for consecutive blocks of memory.
+template <typename Iterator, typename Fn>
+void cpt_save(const cpt_header<Iterator>* header, std::size_t size, std::size_t depth, Fn write)
+{
+    cpt_file_header file{cpt_file_magic, cpt_file_version, 0, 0, 0, 0, 0, 0};
+    if (header != nullptr && header->size > 0)
+    {
+        file.node_count = header->size;
+        file.id_count   = header->id_count;
+        for (auto idx = cpt_index(0); idx != header->id_count; ++idx)
+            file.names_size += cpt_index(std::strlen(header->production_name(idx)) + 1);
+        file.size  = cpt_index(size);
+        file.depth = cpt_index(depth);
+
+        auto& remaining = header->nodes[header->nodes[0].next];
+        file.input_size = remaining.first + remaining.second;
+    }
+    write(&file, sizeof(file));
+    if (file.node_count == 0)
+        return;
+
+    // The nodes only contain indices and offsets, so they can be written as-is.
+    write(header->nodes, file.node_count * sizeof(cpt_node));
+
+    auto offset = cpt_index(0);
+    for (auto idx = cpt_index(0); idx != file.id_count; ++idx)
+    {
+        write(&offset, sizeof(offset));
+        offset += cpt_index(std::strlen(header->production_name(idx)) + 1);
+    }
+
+    for (auto idx = cpt_index(0); idx != file.id_count; ++idx)
+    {
+        auto name = header->production_name(idx);
+        write(name, std::strlen(name) + 1);
+    }
+}
+
+// Checks that all indices of the nodes are in range and that they form a tree, so traversing it
+// never reads out of bounds or loops forever, and that all tokens are inside the input.
+inline bool cpt_validate(const cpt_node* nodes, cpt_index node_count, cpt_index id_count,
+                         cpt_index input_size) noexcept
+{
+    // The root is followed by the token of the remaining input, which is the only node without a
+    // next node.
+    auto remaining = nodes[0].next;
+    if (nodes[0].type() != cpt_node::type_production || remaining >= node_count
+        || nodes[remaining].type() != cpt_node::type_token)
+        return false;
+
+    for (auto idx = cpt_index(0); idx != node_count; ++idx)
+    {
+        auto& node = nodes[idx];
+
+        if (node.next == cpt_null)
+        {
+            if (idx != remaining)
+                return false;
+        }
+        else if (node.next >= node_count)
+            return false;
+        else if (node.next_role() == cpt_node::role_parent
+                 && nodes[node.next].type() != cpt_node::type_production)
+            return false;
+
+        if (node.type() == cpt_node::type_production)
+        {
+            if (node.payload() >= id_count)
+                return false;
+            if (node.second == 0 ? node.first != cpt_null : node.first >= node_count)
+                return false;
+        }
+        else if (node.first > input_size || node.second > input_size - node.first)
+            return false;
+    }
+
+    // Every node except the root and the remaining input is the child of at most one production.
+    auto child_count = std::size_t(0);
+    for (auto idx = cpt_index(0); idx != node_count; ++idx)
+        if (nodes[idx].type() == cpt_node::type_production)
+            child_count += nodes[idx].second;
+    if (child_count > std::size_t(node_count) - 2)
+        return false;
+
+    // The children of a production are linked as siblings, and the last one links back to it.
+    // As the link identifies the production, no node can be the child of two productions, so the
+    // tree can't contain a cycle.
+    // A production that wraps an operation chain is stored after its children, so we can't
+    // require links to point forward instead.
+    for (auto idx = cpt_index(0); idx != node_count; ++idx)
+    {
+        auto& node = nodes[idx];
+        if (node.type() != cpt_node::type_production || node.second == 0)
+            continue;
+
+        auto cur = node.first;
+        for (auto n = cpt_index(1); n != node.second; ++n)
+        {
+            if (nodes[cur].next_role() != cpt_node::role_sibling || nodes[cur].next == cpt_null)
+                return false;
+            cur = nodes[cur].next;
+        }
+        if (nodes[cur].next_role() != cpt_node::role_parent || nodes[cur].next != idx)
+            return false;
+    }
+
+    return true;
+}
+} // namespace lexy::_detail
+
+//=== mapped_parse_tree ===//
+namespace lexy
+{
+/// A read-only view of a parse tree that was saved using `lexy::save_parse_tree()`.
+/// It has the same interface as `lexy::compact_parse_tree`, but doesn't own any memory.
+template <typename Reader, typename TokenKind = void>
+class mapped_parse_tree
+{
+    static_assert(lexy::is_char_encoding<typename Reader::encoding>);
+    static_assert(_detail::is_random_access_iterator<typename Reader::iterator>,
+                  "mapped_parse_tree requires random access iterators");
+
+    using _header_t = _detail::cpt_header<typename Reader::iterator>;
+
+public:
+    //=== construction ===//
+    /// Creates an empty tree.
+    constexpr mapped_parse_tree() noexcept : _header{}, _size(0), _depth(0) {}
+
+    /// Views the tree stored in `data`, whose tokens refer to an input that begins at `begin` and
+    /// has `input_size` code units.
+    /// If `data` doesn't contain a saved tree for an input of that size, the tree is empty.
+    explicit mapped_parse_tree(typename Reader::iterator begin, std::size_t input_size,
+                               const void* data, std::size_t size) noexcept
+    : mapped_parse_tree()
+    {
+        using namespace _detail;
+
+        if (data == nullptr || size < sizeof(cpt_file_header)
+            || reinterpret_cast<std::uintptr_t>(data) % alignof(cpt_file_header) != 0)
+            return;
+
+        auto bytes = static_cast<const unsigned char*>(data);
+        auto file  = static_cast<const cpt_file_header*>(data);
+        if (file->magic != cpt_file_magic || file->version != cpt_file_version
+            || file->node_count == 0 || file->input_size != input_size)
+            return;
+
+        // Check that all parts fit exactly, without overflowing on the way.
+        auto remaining = size - sizeof(cpt_file_header);
+        if (file->node_count < 2 || file->node_count > remaining / sizeof(cpt_node))
+            return;
+        remaining -= file->node_count * sizeof(cpt_node);
+        if (file->id_count > remaining / sizeof(cpt_index))
+            return;
+        remaining -= file->id_count * sizeof(cpt_index);
+        if (file->names_size != remaining)
+            return;
+
+        auto nodes        = bytes + sizeof(cpt_file_header);
+        auto name_offsets = nodes + file->node_count * sizeof(cpt_node);
+        auto names        = name_offsets + file->id_count * sizeof(cpt_index);
+
+        // Every name must be a null-terminated string inside the name table.
+        if (file->names_size > 0 && names[file->names_size - 1] != '\0')
+            return;
+        for (auto idx = cpt_index(0); idx != file->id_count; ++idx)
+            if (reinterpret_cast<const cpt_index*>(name_offsets)[idx] >= file->names_size)
+                return;
+
+        auto node_array = reinterpret_cast<const cpt_node*>(nodes);
+        if (!cpt_validate(node_array, file->node_count, file->id_count, file->input_size))
+            return;
+
+        _header.base         = begin;
+        _header.nodes        = node_array;
+        _header.size         = file->node_count;
+        _header.capacity     = file->node_count;
+        _header.name_offsets = reinterpret_cast<const cpt_index*>(name_offsets);
+        _header.names        = reinterpret_cast<const char*>(names);
+        _header.id_count     = file->id_count;
+
+        _size  = file->size;
+        _depth = file->depth;
+    }
+
+    // Nodes refer to the view, so it can't be copied.
+    mapped_parse_tree(const mapped_parse_tree&)            = delete;
+    mapped_parse_tree& operator=(const mapped_parse_tree&) = delete;
+
+    //=== container access ===//
+    bool empty() const noexcept
+    {
+        return _header.size == 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    std::size_t depth() const noexcept
+    {
+        LEXY_PRECONDITION(!empty());
+        return _depth;
+    }
+
+    //=== node access ===//
+    using node_kind = _cpt_node_kind<Reader, TokenKind>;
+    using node      = _cpt_node<Reader, TokenKind>;
+
+    node root() const noexcept
+    {
+        LEXY_PRECONDITION(!empty());
+        return node(&_header, 0);
+    }
+
+    //=== traverse ===//
+    using traverse_range = _cpt_traverse_range<Reader, TokenKind>;
+
+    traverse_range traverse(const node& n) const noexcept
+    {
+        return traverse_range(n);
+    }
+    traverse_range traverse() const noexcept
+    {
+        if (empty())
+            return traverse_range();
+        else
+            return traverse_range(root());
+    }
+
+    //=== remaining input ===//
+    lexy::lexeme<Reader> remaining_input() const noexcept
+    {
+        if (empty())
+            return {};
+
+        return node::_token_lexeme(&_header, _header.nodes[0].next);
+    }
+
+    //=== saving ===//
+    template <typename MemoryResource, typename Fn>
+    static void _save(const compact_parse_tree<Reader, TokenKind, MemoryResource>& tree, Fn write)
+    {
+        if (tree.empty())
+            _detail::cpt_save<typename Reader::iterator>(nullptr, 0, 0, write);
+        else
+            _detail::cpt_save(tree.root()._header, tree.size(), tree.depth(), write);
+    }
+
+private:
+    _header_t   _header;
+    std::size_t _size;
+    std::size_t _depth;
+};
+
+template <typename Input, typename TokenKind = void>
+using mapped_parse_tree_for = lexy::mapped_parse_tree<lexy::input_reader<Input>, TokenKind>;
+
+/// Writes the tree as a single block of bytes to the output iterator.
+template <typename OutputIt, typename Reader, typename TokenKind, typename MemoryResource>
+OutputIt save_parse_tree(OutputIt                                                     out,
+                         const compact_parse_tree<Reader, TokenKind, MemoryResource>& tree)
+{
+    mapped_parse_tree<Reader, TokenKind>::_save(tree, [&](const void* data, std::size_t size) {
+        auto bytes = static_cast<const char*>(data);
+        for (auto i = std::size_t(0); i != size; ++i)
+            *out++ = bytes[i];
+    });
+    return out;
+}
+
+/// Writes the tree as a single block of bytes to the file.
+/// Returns whether all bytes have been written.
+template <typename Reader, typename TokenKind, typename MemoryResource>
+bool save_parse_tree(std::FILE*                                                   file,
+                     const compact_parse_tree<Reader, TokenKind, MemoryResource>& tree)
+{
+    auto result = true;
+    mapped_parse_tree<Reader, TokenKind>::_save(tree, [&](const void* data, std::size_t size) {
+        if (result && std::fwrite(data, 1, size, file) != size)
+            result = false;
+    });
+    return result;
+}
+
+template <typename Input>
+using _detect_input_size = decltype(LEXY_DECLVAL(const Input&).size());
+
+/// Views the tree stored in `data` that was built for the input.
+/// Neither copies nor allocates, so `data` must outlive the tree.
+template <typename TokenKind = void, typename Input>
+auto load_parse_tree(const Input& input, const void* data, std::size_t size) noexcept
+    -> mapped_parse_tree<input_reader<Input>, TokenKind>
+{
+    auto reader = input.reader();
+    auto begin  = reader.position();
+
+    auto input_size = std::size_t(0);
+    if constexpr (_detail::is_detected<_detect_input_size, Input>)
+    {
+        input_size = input.size();
+    }
+    else
+    {
+        while (reader.peek() != input_reader<Input>::encoding::eof())
+        {
+            reader.bump();
+            ++input_size;
+        }
+    }
+
+    return mapped_parse_tree<input_reader<Input>, TokenKind>(begin, input_size, data, size);
+}
+} // namespace lexy
+
+#endif // LEXY_MAPPED_PARSE_TREE_HPP_INCLUDED
+
@@ -0,0 +1,333 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_MEMORY_RESOURCE_HPP_INCLUDED
+#define LEXY_MEMORY_RESOURCE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+
+//=== monotonic_resource ===//
+namespace lexy
+{
+/// A memory resource that allocates by bumping a pointer into big blocks.
+/// Deallocation does nothing; all memory is freed at once by `release()` or the destructor.
+class monotonic_resource
+{
+    struct block
+    {
+        block*      next;
+        std::size_t size; // of the memory after the header
+    };
+
+    static constexpr auto _block_alignment = alignof(std::max_align_t);
+    // The header is padded, so the memory after it is aligned as well.
+    static constexpr auto _header_size
+        = (sizeof(block) + _block_alignment - 1) / _block_alignment * _block_alignment;
+
+public:
+    static constexpr std::size_t default_block_size = 4096 - _header_size;
+
+    //=== constructors ===//
+    explicit monotonic_resource(std::size_t initial_block_size = default_block_size) noexcept
+    : _head(nullptr), _cur(nullptr), _end(nullptr),
+      _initial_size(initial_block_size == 0 ? default_block_size : initial_block_size),
+      _next_size(_initial_size)
+    {}
+
+    monotonic_resource(const monotonic_resource&)            = delete;
+    monotonic_resource& operator=(const monotonic_resource&) = delete;
+
+    ~monotonic_resource() noexcept
+    {
+        release();
+    }
+
+    //=== allocation ===//
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (auto ptr = _try_allocate(bytes, alignment))
+            return ptr;
+
+        _allocate_block(bytes + (alignment > _block_alignment ? alignment : 0));
+        auto ptr = _try_allocate(bytes, alignment);
+        LEXY_ASSERT(ptr != nullptr, "block was not big enough");
+        return ptr;
+    }
+
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+#if LEXY_ENABLE_ASSERT
+        // Same as the default resource: make dangling lexemes noticable.
+        std::memset(ptr, 0xFF, bytes);
+#else
+        (void)ptr;
+        (void)bytes;
+#endif
+        (void)alignment;
+    }
+
+    /// Frees all memory that has been allocated, even if it has not been deallocated.
+    void release() noexcept
+    {
+        while (_head != nullptr)
+        {
+            auto next = _head->next;
+            _detail::default_memory_resource::deallocate(_head, _header_size + _head->size,
+                                                         _block_alignment);
+            _head = next;
+        }
+
+        _cur       = nullptr;
+        _end       = nullptr;
+        _next_size = _initial_size;
+    }
+
+    friend bool operator==(const monotonic_resource& lhs, const monotonic_resource& rhs) noexcept
+    {
+        return &lhs == &rhs;
+    }
+    friend bool operator!=(const monotonic_resource& lhs, const monotonic_resource& rhs) noexcept
+    {
+        return &lhs != &rhs;
+    }
+
+private:
+    void* _try_allocate(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (_cur == nullptr)
+            return nullptr;
+
+        auto misalignment = reinterpret_cast<std::uintptr_t>(_cur) % alignment;
+        auto padding      = misalignment == 0 ? 0 : alignment - misalignment;
+        if (static_cast<std::size_t>(_end - _cur) < padding + bytes)
+            return nullptr;
+
+        auto result = _cur + padding;
+        _cur        = result + bytes;
+        return result;
+    }
+
+    void _allocate_block(std::size_t min_size)
+    {
+        auto size = _next_size;
+        while (size < min_size)
+            size *= 2;
+
+        auto memory = _detail::default_memory_resource::allocate(_header_size + size,
+                                                                 _block_alignment);
+        _head       = ::new (memory) block{_head, size};
+        _cur        = static_cast<unsigned char*>(memory) + _header_size;
+        _end        = _cur + size;
+        _next_size  = 2 * size;
+    }
+
+    block*         _head;
+    unsigned char* _cur;
+    unsigned char* _end;
+    std::size_t    _initial_size, _next_size;
+};
+} // namespace lexy
+
+//=== thread_local_pool_resource ===//
+namespace lexy
+{
+/// A memory resource that keeps deallocated small objects in free lists of the current thread,
+/// so they can be re-used without a call to `operator new`.
+/// Bigger objects are allocated directly.
+class thread_local_pool_resource
+{
+    static constexpr std::size_t _granularity = alignof(std::max_align_t);
+
+public:
+    /// Objects up to this size are pooled.
+    static constexpr std::size_t max_pooled_size = 16 * _granularity;
+
+    static void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (!_is_pooled(bytes, alignment))
+            return _detail::default_memory_resource::allocate(bytes, alignment);
+
+        auto idx = _size_class(bytes);
+        if (_pool::alive)
+        {
+            auto& pool = _pool::get();
+            if (auto block = pool.free[idx])
+            {
+                pool.free[idx] = block->next;
+                return block;
+            }
+        }
+
+        return _detail::default_memory_resource::allocate(_class_size(idx), _granularity);
+    }
+
+    static void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (!_is_pooled(bytes, alignment) || !_pool::alive)
+        {
+            _detail::default_memory_resource::deallocate(ptr, _pooled_size(bytes, alignment),
+                                                         _pooled_alignment(bytes, alignment));
+            return;
+        }
+
+#if LEXY_ENABLE_ASSERT
+        // Same as the default resource: make dangling lexemes noticable.
+        std::memset(ptr, 0xFF, bytes);
+#endif
+
+        // The block is put into the free list of the current thread, which need not be the thread
+        // that allocated it.
+        auto& pool     = _pool::get();
+        auto  idx      = _size_class(bytes);
+        pool.free[idx] = ::new (ptr) _block{pool.free[idx]};
+    }
+
+    friend constexpr bool operator==(thread_local_pool_resource,
+                                     thread_local_pool_resource) noexcept
+    {
+        return true;
+    }
+    friend constexpr bool operator!=(thread_local_pool_resource,
+                                     thread_local_pool_resource) noexcept
+    {
+        return false;
+    }
+
+private:
+    struct _block
+    {
+        _block* next;
+    };
+
+    static constexpr auto _class_count = max_pooled_size / _granularity;
+
+    struct _pool
+    {
+        _block* free[_class_count] = {};
+
+        // Memory that is deallocated after the pool is destroyed on thread exit must not be put
+        // into it anymore.
+        static inline thread_local bool alive = true;
+
+        static _pool& get() noexcept
+        {
+            static thread_local _pool pool;
+            return pool;
+        }
+
+        ~_pool() noexcept
+        {
+            alive = false;
+            for (auto idx = std::size_t(0); idx != _class_count; ++idx)
+                while (auto block = free[idx])
+                {
+                    free[idx] = block->next;
+                    _detail::default_memory_resource::deallocate(block, _class_size(idx),
+                                                                 _granularity);
+                }
+        }
+    };
+
+    static constexpr bool _is_pooled(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        return bytes <= max_pooled_size && alignment <= _granularity;
+    }
+
+    static constexpr std::size_t _size_class(std::size_t bytes) noexcept
+    {
+        return bytes == 0 ? 0 : (bytes - 1) / _granularity;
+    }
+    static constexpr std::size_t _class_size(std::size_t idx) noexcept
+    {
+        return (idx + 1) * _granularity;
+    }
+
+    // A pooled block that is freed after the pool was destroyed has been allocated with the size
+    // and alignment of its class.
+    static constexpr std::size_t _pooled_size(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        return _is_pooled(bytes, alignment) ? _class_size(_size_class(bytes)) : bytes;
+    }
+    static constexpr std::size_t _pooled_alignment(std::size_t bytes,
+                                                   std::size_t alignment) noexcept
+    {
+        return _is_pooled(bytes, alignment) ? _granularity : alignment;
+    }
+};
+} // namespace lexy
+
+//=== memory_resource_allocator ===//
+namespace lexy
+{
+/// An allocator that allocates from a memory resource, e.g. for the containers of
+/// `lexy::as_list` and `lexy::as_collection`.
+template <typename T, typename MemoryResource = void>
+class memory_resource_allocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = memory_resource_allocator<U, MemoryResource>;
+    };
+
+    template <typename R = MemoryResource,
+              typename   = std::enable_if_t<std::is_void_v<R> || std::is_empty_v<R>>>
+    constexpr memory_resource_allocator() noexcept
+    : _resource(_detail::get_memory_resource<MemoryResource>())
+    {}
+
+    /// Implicit, so the memory resource can be passed as the allocator of a container.
+    template <typename R = MemoryResource, typename = std::enable_if_t<!std::is_void_v<R>>>
+    constexpr memory_resource_allocator(R& resource) noexcept : _resource(&resource)
+    {}
+
+    template <typename U>
+    constexpr memory_resource_allocator(
+        const memory_resource_allocator<U, MemoryResource>& other) noexcept
+    : _resource(other._resource)
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+        _resource->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    /// The memory resource, or `nullptr` if it is stateless.
+    constexpr auto resource() const noexcept
+    {
+        return _resource.get();
+    }
+
+    template <typename U>
+    friend constexpr bool operator==(const memory_resource_allocator&                  lhs,
+                                     const memory_resource_allocator<U, MemoryResource>& rhs)
+    {
+        return *lhs._resource == *rhs._resource;
+    }
+    template <typename U>
+    friend constexpr bool operator!=(const memory_resource_allocator&                  lhs,
+                                     const memory_resource_allocator<U, MemoryResource>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    _detail::memory_resource_ptr<MemoryResource> _resource;
+
+    template <typename, typename>
+    friend class memory_resource_allocator;
+};
+} // namespace lexy
+
+#endif // LEXY_MEMORY_RESOURCE_HPP_INCLUDED
+
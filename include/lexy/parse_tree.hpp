@@ -190,43 +190,52 @@ class pt_buffer
 {
     using resource_ptr = _detail::memory_resource_ptr<MemoryResource>;
 
-    static constexpr std::size_t block_size = 4096 - sizeof(void*);
-
     struct block
     {
-        block*        next;
-        unsigned char memory[block_size];
+        block*      next;
+        std::size_t size;
+        // Followed by size bytes of memory.
 
-        static block* allocate(resource_ptr resource)
+        static block* allocate(resource_ptr resource, std::size_t size)
         {
-            auto memory = resource->allocate(sizeof(block), alignof(block));
-            auto ptr    = ::new (memory) block; // Don't initialize array!
-            ptr->next   = nullptr;
+            auto memory = resource->allocate(sizeof(block) + size, alignof(block));
+            auto ptr    = ::new (memory) block{nullptr, size}; // Don't initialize memory!
             return ptr;
         }
 
         static block* deallocate(resource_ptr resource, block* ptr)
         {
             auto next = ptr->next;
-            resource->deallocate(ptr, sizeof(block), alignof(block));
+            resource->deallocate(ptr, sizeof(block) + ptr->size, alignof(block));
             return next;
         }
 
+        unsigned char* memory() noexcept
+        {
+            return reinterpret_cast<unsigned char*>(this + 1);
+        }
         unsigned char* end() noexcept
         {
-            return &memory[block_size];
+            return memory() + size;
         }
     };
 
 public:
+    static constexpr std::size_t default_block_size = 4096 - sizeof(block);
+
     //=== constructors/destructors/assignment ===//
     explicit constexpr pt_buffer(MemoryResource* resource) noexcept
-    : _resource(resource), _head(nullptr), _cur_block(nullptr), _cur_pos(nullptr)
+    : pt_buffer(resource, default_block_size)
+    {}
+    // Allocates blocks of size_hint bytes instead, if that is bigger.
+    explicit constexpr pt_buffer(MemoryResource* resource, std::size_t size_hint) noexcept
+    : _resource(resource), _head(nullptr), _cur_block(nullptr), _cur_pos(nullptr),
+      _block_size(size_hint < default_block_size ? default_block_size : size_hint)
     {}
 
     pt_buffer(pt_buffer&& other) noexcept
     : _resource(other._resource), _head(other._head), _cur_block(other._cur_block),
-      _cur_pos(other._cur_pos)
+      _cur_pos(other._cur_pos), _block_size(other._block_size)
     {
         other._head = other._cur_block = nullptr;
         other._cur_pos                 = nullptr;
@@ -245,6 +254,7 @@ public:
         lexy::_detail::swap(_head, other._head);
         lexy::_detail::swap(_cur_block, other._cur_block);
         lexy::_detail::swap(_cur_pos, other._cur_pos);
+        lexy::_detail::swap(_block_size, other._block_size);
         return *this;
     }
 
@@ -257,20 +267,33 @@ public:
     void reset()
     {
         if (!_head)
-            _head = block::allocate(_resource);
+            _head = block::allocate(_resource, _block_size);
 
         _cur_block = _head;
-        _cur_pos   = &_cur_block->memory[0];
+        _cur_pos   = _cur_block->memory();
+    }
+
+    // Destroys all nodes without releasing memory, but doesn't allocate the first block.
+    void clear() noexcept
+    {
+        _cur_block = _head;
+        _cur_pos   = _head ? _head->memory() : nullptr;
     }
 
     void reserve(std::size_t size)
     {
         if (remaining_capacity() < size)
         {
-            auto next        = block::allocate(_resource);
-            _cur_block->next = next;
-            _cur_block       = next;
-            _cur_pos         = &_cur_block->memory[0];
+            // Re-use the blocks of a previous tree before allocating new ones.
+            auto next = _cur_block->next;
+            if (next == nullptr)
+            {
+                next             = block::allocate(_resource, _block_size);
+                _cur_block->next = next;
+            }
+
+            _cur_block = next;
+            _cur_pos   = _cur_block->memory();
         }
     }
 
@@ -300,7 +323,7 @@ public:
         // Note: this is not guaranteed to work by the standard;
         // We'd have to go through std::less instead.
         // However, on all implementations I care about, std::less just does < anyway.
-        if (_cur_block->memory <= pos && pos < _cur_block->end())
+        if (_cur_block->memory() <= pos && pos < _cur_block->end())
             // We're still in the same block, just reset position.
             _cur_pos = pos;
         else
@@ -308,7 +331,7 @@ public:
             // This can waste memory, but this is not a problem here:
             // unwind() is only used to backtrack a production, which happens after a couple of
             // tokens only; the memory waste is directly proportional to the lookahead length.
-            _cur_pos = _cur_block->memory;
+            _cur_pos = _cur_block->memory();
     }
 
 private:
@@ -322,6 +345,7 @@ private:
 
     block*         _cur_block;
     unsigned char* _cur_pos;
+    std::size_t    _block_size;
 };
 } // namespace lexy::_detail
 
@@ -347,6 +371,13 @@ public:
     : _buffer(resource), _root(nullptr), _size(0), _depth(0)
     {}
 
+    constexpr explicit parse_tree(std::size_t size_hint)
+    : parse_tree(size_hint, _detail::get_memory_resource<MemoryResource>())
+    {}
+    constexpr explicit parse_tree(std::size_t size_hint, MemoryResource* resource)
+    : _buffer(resource, size_hint), _root(nullptr), _size(0), _depth(0)
+    {}
+
     //=== container access ===//
     bool empty() const noexcept
     {
@@ -366,7 +397,7 @@ public:
 
     void clear() noexcept
     {
-        _buffer.reset();
+        _buffer.clear();
         _root = nullptr;
     }
 
@@ -415,6 +446,18 @@ private:
 template <typename Input, typename TokenKind = void, typename MemoryResource = void>
 using parse_tree_for = lexy::parse_tree<lexy::input_reader<Input>, TokenKind, MemoryResource>;
 
+// Specialized by every tree that can be built by `lexy::parse_as_tree()`.
+template <typename Tree>
+struct _parse_tree_traits
+{};
+template <typename Reader, typename TokenKind, typename MemoryResource>
+struct _parse_tree_traits<parse_tree<Reader, TokenKind, MemoryResource>>
+{
+    using reader          = Reader;
+    using token_kind      = TokenKind;
+    using memory_resource = MemoryResource;
+};
+
 template <typename Reader, typename TokenKind, typename MemoryResource>
 class parse_tree<Reader, TokenKind, MemoryResource>::builder
 {
@@ -746,6 +789,53 @@ public:
         return _cur.child_count;
     }
 
+    // The production node that is currently being built, or nullptr inside a container.
+    _detail::pt_node_production<Reader>* _current_production() const noexcept
+    {
+        return _cur.prod;
+    }
+
+    //=== copying ===//
+    // Appends copies of all children of `prod`, which is a node of a different tree.
+    // The token positions are translated by `map`, and `on_production(original, copy)` is called
+    // for every copied production node.
+    template <typename Map, typename Fn>
+    void _copy_children(_detail::pt_node_production<Reader>* prod, Map& map, Fn& on_production)
+    {
+        auto child = prod->first_child();
+        for (auto i = std::size_t(0); i != prod->child_count; ++i)
+        {
+            if (auto token = child->as_token())
+            {
+                _result._buffer.reserve(sizeof(_detail::pt_node_token<Reader>));
+                auto node = _result._buffer.template allocate<_detail::pt_node_token<Reader>>(
+                    token->kind, map(token->begin), map(token->end()));
+                _cur.insert(node);
+            }
+            else
+            {
+                auto original = child->as_production();
+
+                // Same as start_production(), but it copies the production information.
+                _result._buffer.reserve(sizeof(_detail::pt_node_production<Reader>)
+                                        + sizeof(_detail::pt_node<Reader>*));
+                auto node = _result._buffer
+                                .template allocate<_detail::pt_node_production<Reader>>(*original);
+                node->set_parent(nullptr);
+                node->child_count          = 0;
+                node->first_child_adjacent = true;
+                on_production(original, node);
+
+                auto parent = LEXY_MOV(_cur);
+                _cur        = marker(node, parent.cur_depth + 1, node);
+                _copy_children(original, map, on_production);
+                finish_production(LEXY_MOV(parent));
+            }
+
+            child = child->next_node();
+        }
+    }
+
 private:
     parse_tree _result;
     marker     _cur;
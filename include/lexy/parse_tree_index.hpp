@@ -0,0 +1,335 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_PARSE_TREE_INDEX_HPP_INCLUDED
+#define LEXY_PARSE_TREE_INDEX_HPP_INCLUDED
+
+#include <lexy/_detail/address_table.hpp>
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/parse_tree.hpp>
+
+namespace lexy
+{
+/// Groups the nodes of a parse tree by their kind.
+/// This allows finding all nodes of a kind, all of them that are descendants of a node,
+/// or all of them that begin in a range of the input, without traversing the tree.
+template <typename Tree, typename MemoryResource = void>
+class parse_tree_index
+{
+public:
+    using node     = typename Tree::node;
+    using iterator = decltype(LEXY_DECLVAL(node).lexeme().begin());
+
+private:
+    struct entry
+    {
+        node        value;
+        std::size_t preorder;
+        // The position of the first token that is a descendant,
+        // or for a node without tokens, of the next token.
+        iterator position;
+    };
+
+    struct kind_entry
+    {
+        node        representative;
+        std::size_t first; // into _entries
+        std::size_t count;
+    };
+
+public:
+    class node_range
+    {
+    public:
+        class iterator
+        : public _detail::bidirectional_iterator_base<iterator, node, node, void>
+        {
+        public:
+            iterator() noexcept = default;
+
+            node deref() const noexcept
+            {
+                return _cur->value;
+            }
+
+            void increment() noexcept
+            {
+                ++_cur;
+            }
+            void decrement() noexcept
+            {
+                --_cur;
+            }
+
+            bool equal(iterator rhs) const noexcept
+            {
+                return _cur == rhs._cur;
+            }
+
+        private:
+            explicit iterator(const entry* cur) noexcept : _cur(cur) {}
+
+            const entry* _cur = nullptr;
+
+            friend node_range;
+        };
+
+        bool empty() const noexcept
+        {
+            return _begin == _end;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return static_cast<std::size_t>(_end - _begin);
+        }
+
+        iterator begin() const noexcept
+        {
+            return iterator(_begin);
+        }
+        iterator end() const noexcept
+        {
+            return iterator(_end);
+        }
+
+    private:
+        explicit node_range(const entry* begin, const entry* end) noexcept
+        : _begin(begin), _end(end)
+        {}
+
+        const entry* _begin;
+        const entry* _end;
+
+        friend parse_tree_index;
+    };
+
+    //=== constructors ===//
+    explicit parse_tree_index(const Tree&     tree,
+                              MemoryResource* resource
+                              = _detail::get_memory_resource<MemoryResource>())
+    : _size(tree.size()), _entries(_size, resource), _subtree_end(_size, resource),
+      _kinds(resource), _kind_count(0), _kind_table(resource), _has_tokens(false),
+      _table(_size, resource)
+    {
+        static_assert(lexy::_detail::is_random_access_iterator<iterator>,
+                      "parse_tree_index requires random access iterators");
+        LEXY_PRECONDITION(!tree.empty());
+
+        // Store the nodes in pre-order and remember their kind.
+        _detail::resource_array<entry, MemoryResource>       preorder_entries(_size, resource);
+        _detail::resource_array<std::size_t, MemoryResource> kind_of(_size, resource);
+        _detail::resource_array<std::size_t, MemoryResource> stack(tree.depth() + 1, resource);
+        auto                                                 stack_size = std::size_t(0);
+
+        auto next_preorder = std::size_t(0);
+        // The nodes since the last token don't have a position yet.
+        auto pending  = std::size_t(0);
+        auto last_end = iterator();
+        for (auto [event, n] : tree.traverse())
+        {
+            if (event == lexy::traverse_event::exit)
+            {
+                _subtree_end[stack[--stack_size]] = next_preorder;
+                continue;
+            }
+
+            auto idx = next_preorder++;
+            ::new (static_cast<void*>(preorder_entries.data() + idx)) entry{n, idx, iterator()};
+            _table.insert(n.address(), idx);
+
+            auto kind = _insert_kind(n);
+            kind_of[idx] = kind;
+            ++_kinds[kind].count;
+
+            if (event == lexy::traverse_event::enter)
+            {
+                stack[stack_size++] = idx;
+            }
+            else
+            {
+                _subtree_end[idx] = idx + 1;
+
+                auto begin = n.lexeme().begin();
+                for (; pending != next_preorder; ++pending)
+                    preorder_entries[pending].position = begin;
+                last_end    = n.lexeme().end();
+                _has_tokens = true;
+            }
+        }
+        // Nodes after the last token are positioned at its end.
+        for (; pending != _size; ++pending)
+            preorder_entries[pending].position = last_end;
+
+        // Then group them by kind, keeping the pre-order within each group.
+        auto offset = std::size_t(0);
+        for (auto kind = std::size_t(0); kind != _kind_count; ++kind)
+        {
+            _kinds[kind].first = offset;
+            offset += _kinds[kind].count;
+            _kinds[kind].count = 0;
+        }
+
+        for (auto idx = std::size_t(0); idx != _size; ++idx)
+        {
+            auto& kind = _kinds[kind_of[idx]];
+            ::new (static_cast<void*>(_entries.data() + kind.first + kind.count))
+                entry(preorder_entries[idx]);
+            ++kind.count;
+        }
+    }
+
+    parse_tree_index(const parse_tree_index&)            = delete;
+    parse_tree_index& operator=(const parse_tree_index&) = delete;
+
+    //=== access ===//
+    /// The number of nodes in the tree.
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /// The number of distinct node kinds in the tree.
+    std::size_t kind_count() const noexcept
+    {
+        return _kind_count;
+    }
+
+    /// All nodes of the kind, in pre-order.
+    /// Finding the kind is linear in the number of distinct kinds.
+    template <typename Kind>
+    node_range nodes(Kind kind) const noexcept
+    {
+        for (auto i = std::size_t(0); i != _kind_count; ++i)
+            if (_kinds[i].representative.kind() == kind)
+                return node_range(_entries.data() + _kinds[i].first,
+                                  _entries.data() + _kinds[i].first + _kinds[i].count);
+
+        return node_range(nullptr, nullptr);
+    }
+
+    /// All nodes of the kind that are descendants of the node, in pre-order.
+    template <typename Kind>
+    node_range nodes(Kind kind, node ancestor) const noexcept
+    {
+        auto range = nodes(kind);
+        if (range.empty())
+            return range;
+
+        auto preorder = _table.find(ancestor.address());
+        auto end      = _subtree_end[preorder];
+        auto first    = _lower_bound(range, [&](const entry& e) { return e.preorder <= preorder; });
+        auto last     = _lower_bound(range, [&](const entry& e) { return e.preorder < end; });
+        return node_range(first, last);
+    }
+
+    /// All nodes of the kind whose first token begins in the range `[begin, end)`, in pre-order.
+    /// A node without tokens is considered to begin at the next token.
+    template <typename Kind>
+    node_range nodes(Kind kind, iterator begin, iterator end) const noexcept
+    {
+        auto range = nodes(kind);
+        if (range.empty() || !_has_tokens)
+            return node_range(nullptr, nullptr);
+
+        auto first = _lower_bound(range, [&](const entry& e) { return e.position - begin < 0; });
+        auto last  = _lower_bound(range, [&](const entry& e) { return e.position - end < 0; });
+        return node_range(first, last);
+    }
+
+private:
+    // Returns the first entry of the range for which the predicate is false.
+    template <typename Predicate>
+    static const entry* _lower_bound(node_range range, Predicate pred) noexcept
+    {
+        auto first = range._begin;
+        auto count = range.size();
+        while (count > 0)
+        {
+            auto half = count / 2;
+            if (pred(first[half]))
+            {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else
+            {
+                count = half;
+            }
+        }
+        return first;
+    }
+
+    //=== kind hash table ===//
+    // Nodes of the same kind share the pointer to their name, but different token kinds can share
+    // a name, so we also compare the kinds.
+    // A slot stores the index of the kind plus one, or zero if it is empty.
+    static std::size_t _hash(const char* name, std::size_t mask) noexcept
+    {
+        auto value = std::uint_least64_t(reinterpret_cast<std::uintptr_t>(name));
+        return std::size_t((value * 0x9E37'79B9'7F4A'7C15) >> 32) & mask;
+    }
+
+    std::size_t _insert_kind(node n)
+    {
+        if (2 * (_kind_count + 1) > _kind_table.size())
+            _grow_kinds();
+
+        auto name = n.kind().name();
+        auto mask = _kind_table.size() - 1;
+        auto slot = _hash(name, mask);
+        for (; _kind_table[slot] != 0; slot = (slot + 1) & mask)
+        {
+            auto kind = _kind_table[slot] - 1;
+            if (_kinds[kind].representative.kind() == n.kind())
+                return kind;
+        }
+
+        auto kind = _kind_count++;
+        ::new (static_cast<void*>(_kinds.data() + kind)) kind_entry{n, 0, 0};
+        _kind_table[slot] = kind + 1;
+        return kind;
+    }
+
+    void _grow_kinds()
+    {
+        // Allocate both arrays before changing anything, so an exception doesn't leave them
+        // inconsistent.
+        auto new_capacity = _kinds.size() == 0 ? std::size_t(16) : 2 * _kinds.size();
+        _detail::resource_array<kind_entry, MemoryResource>  new_kinds(new_capacity,
+                                                                      _kinds.resource());
+        _detail::resource_array<std::size_t, MemoryResource> new_table(2 * new_capacity,
+                                                                       _kinds.resource());
+
+        for (auto i = std::size_t(0); i != _kind_count; ++i)
+            ::new (static_cast<void*>(new_kinds.data() + i)) kind_entry(_kinds[i]);
+        _kinds.swap(new_kinds);
+
+        _kind_table.swap(new_table);
+        for (auto i = std::size_t(0); i != _kind_table.size(); ++i)
+            _kind_table[i] = 0;
+
+        auto mask = _kind_table.size() - 1;
+        for (auto kind = std::size_t(0); kind != _kind_count; ++kind)
+        {
+            auto slot = _hash(_kinds[kind].representative.kind().name(), mask);
+            while (_kind_table[slot] != 0)
+                slot = (slot + 1) & mask;
+            _kind_table[slot] = kind + 1;
+        }
+    }
+
+    std::size_t                                          _size;
+    _detail::resource_array<entry, MemoryResource>       _entries;
+    _detail::resource_array<std::size_t, MemoryResource> _subtree_end; // by pre-order index
+    _detail::resource_array<kind_entry, MemoryResource>  _kinds;
+    std::size_t                                          _kind_count;
+    _detail::resource_array<std::size_t, MemoryResource> _kind_table;
+    bool                                                 _has_tokens;
+    _detail::address_table<MemoryResource>               _table; // address to pre-order index
+};
+} // namespace lexy
+
+#endif // LEXY_PARSE_TREE_INDEX_HPP_INCLUDED
+
@@ -0,0 +1,218 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_PARSE_TREE_NODE_INDEX_HPP_INCLUDED
+#define LEXY_PARSE_TREE_NODE_INDEX_HPP_INCLUDED
+
+#include <lexy/_detail/address_table.hpp>
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/parse_tree.hpp>
+
+namespace lexy
+{
+/// Stores the parent, children, and position of every node of a parse tree.
+/// This allows accessing the parent and the i-th child in constant time,
+/// and finding the node that covers a position by binary search instead of a linear scan.
+template <typename Tree, typename MemoryResource = void>
+class parse_tree_node_index
+{
+public:
+    using node     = typename Tree::node;
+    using iterator = decltype(LEXY_DECLVAL(node).lexeme().begin());
+
+private:
+    struct entry
+    {
+        node        value;
+        std::size_t parent;
+        std::size_t first_child; // into _children
+        std::size_t child_count;
+        // The position of the first token that is a descendant and the end of the last one,
+        // or for a node without tokens, the end of the previous token.
+        iterator begin;
+        iterator end;
+        bool     has_token;
+    };
+
+public:
+    //=== constructors ===//
+    explicit parse_tree_node_index(const Tree&     tree,
+                                   MemoryResource* resource
+                                   = _detail::get_memory_resource<MemoryResource>())
+    : _size(tree.size()), _entries(_size, resource), _children(_size, resource),
+      _table(_size, resource)
+    {
+        static_assert(lexy::_detail::is_random_access_iterator<iterator>,
+                      "parse_tree_node_index requires random access iterators");
+        LEXY_PRECONDITION(!tree.empty());
+
+        // Nodes before the first token begin at its position.
+        auto first_token = iterator();
+        for (auto [event, n] : tree.traverse())
+            if (event == lexy::traverse_event::leaf)
+            {
+                first_token = n.lexeme().begin();
+                break;
+            }
+
+        // Store the nodes in pre-order, with the children of each node adjacent.
+        _detail::resource_array<std::size_t, MemoryResource> stack(tree.depth() + 1, resource);
+        auto                                                 stack_size = std::size_t(0);
+        // The nodes on the stack starting at that level don't have a token yet.
+        auto pending    = std::size_t(0);
+        auto cursor     = first_token;
+
+        auto next_index = std::size_t(0), next_child = std::size_t(0);
+        for (auto [event, n] : tree.traverse())
+        {
+            if (event == lexy::traverse_event::exit)
+            {
+                auto& e = _entries[stack[--stack_size]];
+                if (pending > stack_size)
+                    pending = stack_size;
+                if (!e.has_token)
+                    e.begin = cursor;
+                e.end = cursor;
+                continue;
+            }
+
+            auto idx    = next_index++;
+            auto parent = stack_size == 0 ? idx : stack[stack_size - 1];
+            auto& e = *::new (static_cast<void*>(_entries.data() + idx))
+                           entry{n, parent, next_child, 0, cursor, cursor, false};
+            _table.insert(n.address(), idx);
+
+            if (idx != parent)
+                _children[_entries[parent].first_child + _entries[parent].child_count++] = idx;
+
+            if (event == lexy::traverse_event::enter)
+            {
+                next_child += n.children().size();
+                stack[stack_size++] = idx;
+            }
+            else
+            {
+                // All productions that didn't have a token yet begin here.
+                auto begin  = n.lexeme().begin();
+                e.begin     = begin;
+                e.has_token = true;
+                for (; pending != stack_size; ++pending)
+                {
+                    _entries[stack[pending]].begin     = begin;
+                    _entries[stack[pending]].has_token = true;
+                }
+                cursor = n.lexeme().end();
+                e.end  = cursor;
+            }
+        }
+    }
+
+    parse_tree_node_index(const parse_tree_node_index&)            = delete;
+    parse_tree_node_index& operator=(const parse_tree_node_index&) = delete;
+
+    //=== access ===//
+    /// The number of nodes in the tree.
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /// The root node of the tree.
+    node root() const noexcept
+    {
+        return _entries[0].value;
+    }
+
+    /// The parent of the node, or the node itself if it is the root.
+    node parent(node n) const noexcept
+    {
+        return _entries[_entries[_find(n)].parent].value;
+    }
+
+    /// The number of children of the node.
+    std::size_t child_count(node n) const noexcept
+    {
+        return _entries[_find(n)].child_count;
+    }
+
+    /// The child of the node with the specified index.
+    node child(node n, std::size_t idx) const noexcept
+    {
+        auto& e = _entries[_find(n)];
+        LEXY_PRECONDITION(idx < e.child_count);
+        return _entries[_children[e.first_child + idx]].value;
+    }
+
+    /// The position where the node begins: the beginning of its first token,
+    /// or, if it doesn't have any tokens, the end of the previous one.
+    iterator position(node n) const noexcept
+    {
+        return _entries[_find(n)].begin;
+    }
+
+    /// Whether the node is a token or has a token as descendant.
+    bool has_token(node n) const noexcept
+    {
+        return _entries[_find(n)].has_token;
+    }
+
+    /// The first child of the node that has a token ending after the position,
+    /// or the last child if there is none.
+    node child_at(node n, iterator pos) const noexcept
+    {
+        auto& e = _entries[_find(n)];
+        LEXY_PRECONDITION(e.child_count > 0);
+        return _entries[_child_at(e, pos)].value;
+    }
+
+    /// The token that covers the position.
+    node find_covering_node(iterator pos) const noexcept
+    {
+        auto idx = std::size_t(0);
+        while (_entries[idx].child_count > 0)
+            idx = _child_at(_entries[idx], pos);
+        return _entries[idx].value;
+    }
+
+private:
+    std::size_t _child_at(const entry& e, iterator pos) const noexcept
+    {
+        // Find the first child that ends after the position.
+        auto first = e.first_child;
+        auto count = e.child_count;
+        while (count > 0)
+        {
+            auto half = count / 2;
+            if (_entries[_children[first + half]].end - pos <= 0)
+            {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else
+            {
+                count = half;
+            }
+        }
+
+        auto last = e.first_child + e.child_count - 1;
+        // A child without tokens ends where the previous token ends; skip it, as the position is
+        // covered by the next token.
+        while (first < last && !_entries[_children[first]].has_token)
+            ++first;
+        return _children[first < last ? first : last];
+    }
+
+    std::size_t _find(node n) const noexcept
+    {
+        return _table.find(n.address());
+    }
+
+    std::size_t                                          _size;
+    _detail::resource_array<entry, MemoryResource>       _entries;
+    _detail::resource_array<std::size_t, MemoryResource> _children;
+    _detail::address_table<MemoryResource>               _table;
+};
+} // namespace lexy
+
+#endif // LEXY_PARSE_TREE_NODE_INDEX_HPP_INCLUDED
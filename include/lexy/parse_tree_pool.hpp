@@ -0,0 +1,148 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_PARSE_TREE_POOL_HPP_INCLUDED
+#define LEXY_PARSE_TREE_POOL_HPP_INCLUDED
+
+#include <lexy/parse_tree.hpp>
+#include <mutex>
+
+namespace lexy
+{
+/// Keeps parse trees around after use, so parsing many inputs can re-use their memory.
+/// Trees can be acquired and released from multiple threads.
+template <typename Reader, typename TokenKind = void, typename MemoryResource = void>
+class parse_tree_pool
+{
+    using tree_type    = parse_tree<Reader, TokenKind, MemoryResource>;
+    using resource_ptr = _detail::memory_resource_ptr<MemoryResource>;
+
+    struct entry
+    {
+        tree_type tree;
+        entry*    next;
+    };
+
+public:
+    /// Owns a tree of the pool and returns it on destruction.
+    class handle
+    {
+    public:
+        handle(handle&& other) noexcept : _pool(other._pool), _entry(other._entry)
+        {
+            other._entry = nullptr;
+        }
+
+        ~handle() noexcept
+        {
+            if (_entry != nullptr)
+                _pool->_release(_entry);
+        }
+
+        handle& operator=(handle&& other) noexcept
+        {
+            lexy::_detail::swap(_pool, other._pool);
+            lexy::_detail::swap(_entry, other._entry);
+            return *this;
+        }
+
+        tree_type& get() const noexcept
+        {
+            return _entry->tree;
+        }
+
+        tree_type& operator*() const noexcept
+        {
+            return _entry->tree;
+        }
+        tree_type* operator->() const noexcept
+        {
+            return &_entry->tree;
+        }
+
+    private:
+        explicit handle(parse_tree_pool* pool, entry* e) noexcept : _pool(pool), _entry(e) {}
+
+        parse_tree_pool* _pool;
+        entry*           _entry;
+
+        friend parse_tree_pool;
+    };
+
+    //=== constructors ===//
+    explicit parse_tree_pool(std::size_t size_hint = 0)
+    : parse_tree_pool(size_hint, _detail::get_memory_resource<MemoryResource>())
+    {}
+    explicit parse_tree_pool(std::size_t size_hint, MemoryResource* resource)
+    : _free(nullptr), _size_hint(size_hint), _resource(resource)
+    {}
+
+    parse_tree_pool(const parse_tree_pool&)            = delete;
+    parse_tree_pool& operator=(const parse_tree_pool&) = delete;
+
+    /// All handles must have been destroyed.
+    ~parse_tree_pool() noexcept
+    {
+        while (_free != nullptr)
+        {
+            auto next = _free->next;
+            _free->~entry();
+            _resource->deallocate(_free, sizeof(entry), alignof(entry));
+            _free = next;
+        }
+    }
+
+    //=== access ===//
+    /// Returns an empty tree, which keeps the memory of its previous use.
+    handle acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_free != nullptr)
+            {
+                auto result = _free;
+                _free       = result->next;
+                return handle(this, result);
+            }
+        }
+
+        // The tree is created first, so it is destroyed if allocating the entry throws.
+        tree_type tree(_size_hint, _resource.get());
+        auto      memory = _resource->allocate(sizeof(entry), alignof(entry));
+        return handle(this, ::new (memory) entry{LEXY_MOV(tree), nullptr});
+    }
+
+    /// The number of trees that are currently not acquired.
+    std::size_t available() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto result = std::size_t(0);
+        for (auto cur = _free; cur != nullptr; cur = cur->next)
+            ++result;
+        return result;
+    }
+
+private:
+    void _release(entry* e) noexcept
+    {
+        e->tree.clear();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        e->next = _free;
+        _free   = e;
+    }
+
+    mutable std::mutex             _mutex;
+    entry*                         _free;
+    std::size_t                    _size_hint;
+    LEXY_EMPTY_MEMBER resource_ptr _resource;
+};
+
+template <typename Input, typename TokenKind = void, typename MemoryResource = void>
+using parse_tree_pool_for
+    = lexy::parse_tree_pool<lexy::input_reader<Input>, TokenKind, MemoryResource>;
+} // namespace lexy
+
+#endif // LEXY_PARSE_TREE_POOL_HPP_INCLUDED
+
@@ -0,0 +1,321 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_TOKEN_STREAM_HPP_INCLUDED
+#define LEXY_TOKEN_STREAM_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/input/base.hpp>
+#include <lexy/lexeme.hpp>
+#include <lexy/token.hpp>
+
+//=== internal: ts_buffer ===//
+namespace lexy::_detail
+{
+// A token is stored as offset and length relative to the beginning of the input.
+struct ts_token
+{
+    std::uint_least32_t offset;
+    std::uint_least32_t length;
+    std::uint_least16_t kind;
+};
+
+// A growable array of tokens.
+template <typename MemoryResource>
+class ts_buffer
+{
+    using resource_ptr = _detail::memory_resource_ptr<MemoryResource>;
+
+    static constexpr std::size_t initial_capacity = 4096 / sizeof(ts_token);
+
+public:
+    //=== constructors/destructors/assignment ===//
+    explicit constexpr ts_buffer(MemoryResource* resource) noexcept
+    : _resource(resource), _data(nullptr), _size(0), _capacity(0)
+    {}
+
+    ts_buffer(ts_buffer&& other) noexcept
+    : _resource(other._resource), _data(other._data), _size(other._size),
+      _capacity(other._capacity)
+    {
+        other._data     = nullptr;
+        other._size     = 0;
+        other._capacity = 0;
+    }
+
+    ~ts_buffer() noexcept
+    {
+        if (_data != nullptr)
+            _resource->deallocate(_data, _capacity * sizeof(ts_token), alignof(ts_token));
+    }
+
+    ts_buffer& operator=(ts_buffer&& other) noexcept
+    {
+        lexy::_detail::swap(_resource, other._resource);
+        lexy::_detail::swap(_data, other._data);
+        lexy::_detail::swap(_size, other._size);
+        lexy::_detail::swap(_capacity, other._capacity);
+        return *this;
+    }
+
+    //=== access ===//
+    const ts_token* data() const noexcept
+    {
+        return _data;
+    }
+    ts_token* data() noexcept
+    {
+        return _data;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    //=== modifiers ===//
+    void reserve(std::size_t capacity)
+    {
+        if (capacity > _capacity)
+            _grow(capacity);
+    }
+
+    void push_back(const ts_token& token)
+    {
+        if (_size == _capacity)
+            _grow(_capacity == 0 ? initial_capacity : 2 * _capacity);
+
+        ::new (static_cast<void*>(_data + _size)) ts_token(token);
+        ++_size;
+    }
+
+    // Removes all tokens starting at idx.
+    void truncate(std::size_t idx) noexcept
+    {
+        LEXY_PRECONDITION(idx <= _size);
+        _size = idx;
+    }
+
+private:
+    void _grow(std::size_t new_capacity)
+    {
+        auto memory = _resource->allocate(new_capacity * sizeof(ts_token), alignof(ts_token));
+        if (_data != nullptr)
+        {
+            std::memcpy(memory, static_cast<void*>(_data), _size * sizeof(ts_token));
+            _resource->deallocate(_data, _capacity * sizeof(ts_token), alignof(ts_token));
+        }
+
+        _data     = static_cast<ts_token*>(memory);
+        _capacity = new_capacity;
+    }
+
+    LEXY_EMPTY_MEMBER resource_ptr _resource;
+    ts_token*                      _data;
+    std::size_t                    _size, _capacity;
+};
+} // namespace lexy::_detail
+
+//=== token_stream ===//
+namespace lexy
+{
+template <typename Reader, typename TokenKind>
+class _ts_token;
+
+/// The tokens of an input without any productions, as produced by `lexy::tokenize()`.
+/// Each token is stored in 12 bytes, regardless of the size of the iterator.
+template <typename Reader, typename TokenKind = void, typename MemoryResource = void>
+class token_stream
+{
+    static_assert(_detail::is_random_access_iterator<typename Reader::iterator>,
+                  "token_stream requires random access iterators");
+
+public:
+    //=== construction ===//
+    constexpr token_stream() : token_stream(_detail::get_memory_resource<MemoryResource>()) {}
+    constexpr explicit token_stream(MemoryResource* resource)
+    : _buffer(resource), _begin(), _remaining_offset(0), _remaining_length(0)
+    {}
+
+    //=== container access ===//
+    bool empty() const noexcept
+    {
+        return _buffer.size() == 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _buffer.size();
+    }
+
+    /// Removes all tokens, but keeps the memory for the next use.
+    void clear() noexcept
+    {
+        _buffer.truncate(0);
+        _remaining_offset = _remaining_length = 0;
+    }
+
+    void reserve(std::size_t size)
+    {
+        _buffer.reserve(size);
+    }
+
+    //=== token access ===//
+    using token = _ts_token<Reader, TokenKind>;
+
+    token operator[](std::size_t idx) const noexcept
+    {
+        LEXY_PRECONDITION(idx < size());
+        return token(_begin, _buffer.data() + idx);
+    }
+
+    class iterator : public _detail::bidirectional_iterator_base<iterator, token, token, void>
+    {
+    public:
+        iterator() noexcept : _begin(), _ptr(nullptr) {}
+
+        token deref() const noexcept
+        {
+            return token(_begin, _ptr);
+        }
+
+        void increment() noexcept
+        {
+            ++_ptr;
+        }
+        void decrement() noexcept
+        {
+            --_ptr;
+        }
+
+        bool equal(iterator rhs) const noexcept
+        {
+            return _ptr == rhs._ptr;
+        }
+
+    private:
+        explicit iterator(typename Reader::iterator begin, const _detail::ts_token* ptr) noexcept
+        : _begin(begin), _ptr(ptr)
+        {}
+
+        typename Reader::iterator _begin;
+        const _detail::ts_token*  _ptr;
+
+        friend token_stream;
+    };
+
+    iterator begin() const noexcept
+    {
+        return iterator(_begin, _buffer.data());
+    }
+    iterator end() const noexcept
+    {
+        return iterator(_begin, _buffer.data() + _buffer.size());
+    }
+
+    //=== remaining input ===//
+    lexy::lexeme<Reader> remaining_input() const noexcept
+    {
+        auto begin = _detail::next(_begin, _remaining_offset);
+        return {begin, _detail::next(begin, _remaining_length)};
+    }
+
+    //=== building ===//
+    // Removes all tokens and starts tokenizing the input beginning at `begin`.
+    void _reset(typename Reader::iterator begin) noexcept
+    {
+        clear();
+        _begin = begin;
+    }
+
+    void _token(token_kind<TokenKind> _kind, typename Reader::iterator begin,
+                typename Reader::iterator end)
+    {
+        if (_kind.ignore_if_empty() && begin == end)
+            return;
+
+        auto kind   = token_kind<TokenKind>::to_raw(_kind);
+        auto offset = _offset(begin);
+        auto length = std::size_t(end - begin);
+        LEXY_PRECONDITION(offset + length <= UINT_LEAST32_MAX);
+
+        // We merge error tokens.
+        if (kind == lexy::error_token_kind && !empty())
+        {
+            auto& last = _buffer.data()[_buffer.size() - 1];
+            if (last.kind == lexy::error_token_kind && last.offset + last.length == offset)
+            {
+                last.length = std::uint_least32_t(last.length + length);
+                return;
+            }
+        }
+
+        _buffer.push_back(
+            {std::uint_least32_t(offset), std::uint_least32_t(length), std::uint_least16_t(kind)});
+    }
+
+    // Removes all tokens starting at idx.
+    void _truncate(std::size_t idx) noexcept
+    {
+        _buffer.truncate(idx);
+    }
+
+    void _finish(lexy::lexeme<Reader> remaining_input) noexcept
+    {
+        _remaining_offset = _offset(remaining_input.begin());
+        _remaining_length = remaining_input.size();
+    }
+
+private:
+    std::size_t _offset(typename Reader::iterator pos) const noexcept
+    {
+        return std::size_t(pos - _begin);
+    }
+
+    _detail::ts_buffer<MemoryResource> _buffer;
+    typename Reader::iterator          _begin;
+    std::size_t                        _remaining_offset, _remaining_length;
+};
+
+template <typename Input, typename TokenKind = void, typename MemoryResource = void>
+using token_stream_for = lexy::token_stream<lexy::input_reader<Input>, TokenKind, MemoryResource>;
+
+template <typename Reader, typename TokenKind>
+class _ts_token
+{
+public:
+    token_kind<TokenKind> kind() const noexcept
+    {
+        return token_kind<TokenKind>::from_raw(_ptr->kind);
+    }
+
+    typename Reader::iterator position() const noexcept
+    {
+        return _begin + _ptr->offset;
+    }
+
+    lexy::lexeme<Reader> lexeme() const noexcept
+    {
+        auto begin = position();
+        return lexy::lexeme<Reader>(begin, begin + _ptr->length);
+    }
+
+private:
+    explicit _ts_token(typename Reader::iterator begin, const _detail::ts_token* ptr) noexcept
+    : _begin(begin), _ptr(ptr)
+    {}
+
+    typename Reader::iterator _begin;
+    const _detail::ts_token*  _ptr;
+
+    template <typename, typename, typename>
+    friend class token_stream;
+};
+} // namespace lexy
+
+#endif // LEXY_TOKEN_STREAM_HPP_INCLUDED
@@ -5,6 +5,7 @@
 #define LEXY_EXT_PARSE_TREE_ALGORITHM_HPP_INCLUDED
 
 #include <lexy/parse_tree.hpp>
+#include <lexy/parse_tree_node_index.hpp>
 #include <optional>
 
 namespace lexy_ext
@@ -130,6 +131,20 @@ auto find_covering_node(const lexy::parse_tree<Reader, TokenKind, MemoryResource
     LEXY_PRECONDITION(false); // Position out of bounds.
     return tree.root();
 }
+
+/// Returns the node of the tree that covers the position.
+/// It uses the index to descend from the root by binary search over the children.
+template <typename Reader, typename TokenKind, typename MemoryResource, typename IndexResource>
+auto find_covering_node(const lexy::parse_tree<Reader, TokenKind, MemoryResource>& tree,
+                        typename Reader::iterator                                  position,
+                        const lexy::parse_tree_node_index<
+                            lexy::parse_tree<Reader, TokenKind, MemoryResource>, IndexResource>&
+                            index) ->
+    typename lexy::parse_tree<Reader, TokenKind, MemoryResource>::node
+{
+    LEXY_PRECONDITION(!tree.empty());
+    return index.find_covering_node(position);
+}
 } // namespace lexy_ext
 
 namespace lexy_ext
@@ -275,6 +290,26 @@ auto node_position(const lexy::parse_tree<Reader, TokenKind, MemoryResource>&
     else
         return tokens.begin()->lexeme().begin();
 }
+
+/// Returns the position of a node.
+/// It uses the index to look only at the children of the node instead of all its descendants.
+template <typename Reader, typename TokenKind, typename MemoryResource, typename IndexResource>
+auto node_position(const lexy::parse_tree<Reader, TokenKind, MemoryResource>&,
+                   typename lexy::parse_tree<Reader, TokenKind, MemoryResource>::node node,
+                   const lexy::parse_tree_node_index<
+                       lexy::parse_tree<Reader, TokenKind, MemoryResource>, IndexResource>& index)
+    -> typename Reader::iterator
+{
+    for (auto i = std::size_t(0); i != index.child_count(node); ++i)
+        if (auto child = index.child(node, i); child.kind() == lexy::position_token_kind)
+            return child.lexeme().begin();
+
+    if (index.has_token(node))
+        return index.position(node);
+    else
+        // The node does not have a token as descendant.
+        return {};
+}
 } // namespace lexy_ext
 
 #endif // LEXY_EXT_PARSE_TREE_ALGORITHM_HPP_INCLUDED
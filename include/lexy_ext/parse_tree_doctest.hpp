@@ -7,6 +7,8 @@
 #include <cctype>
 #include <cstdio>
 #include <doctest/doctest.h>
+#include <lexy/compact_parse_tree.hpp>
+#include <lexy/mapped_parse_tree.hpp>
 #include <lexy/parse_tree.hpp>
 
 namespace lexy_ext
@@ -138,6 +140,38 @@ public:
         return toString(desc) == string_maker::convert(tree);
     }
 
+    template <typename Reader, typename MemoryResource>
+    friend bool operator==(const parse_tree_desc&                                             desc,
+                           const lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>& tree)
+    {
+        using string_maker
+            = doctest::StringMaker<lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>>;
+        return toString(desc) == string_maker::convert(tree);
+    }
+    template <typename Reader, typename MemoryResource>
+    friend bool operator==(const lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>& tree,
+                           const parse_tree_desc&                                             desc)
+    {
+        using string_maker
+            = doctest::StringMaker<lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>>;
+        return toString(desc) == string_maker::convert(tree);
+    }
+
+    template <typename Reader>
+    friend bool operator==(const parse_tree_desc&                             desc,
+                           const lexy::mapped_parse_tree<Reader, TokenKind>& tree)
+    {
+        using string_maker = doctest::StringMaker<lexy::mapped_parse_tree<Reader, TokenKind>>;
+        return toString(desc) == string_maker::convert(tree);
+    }
+    template <typename Reader>
+    friend bool operator==(const lexy::mapped_parse_tree<Reader, TokenKind>& tree,
+                           const parse_tree_desc&                             desc)
+    {
+        using string_maker = doctest::StringMaker<lexy::mapped_parse_tree<Reader, TokenKind>>;
+        return toString(desc) == string_maker::convert(tree);
+    }
+
 private:
     void prefix()
     {
@@ -165,7 +199,8 @@ struct StringMaker<lexy::parse_tree<Reader, TokenKind, MemoryResource>>
 {
     using parse_tree = lexy::parse_tree<Reader, TokenKind, MemoryResource>;
 
-    static String convert(const parse_tree& tree)
+    template <typename Tree>
+    static String convert(const Tree& tree)
     {
         lexy_ext::parse_tree_desc<TokenKind> builder;
 
@@ -189,6 +224,28 @@ struct StringMaker<lexy::parse_tree<Reader, TokenKind, MemoryResource>>
         return toString(builder);
     }
 };
+
+template <typename Reader, typename TokenKind, typename MemoryResource>
+struct StringMaker<lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>>
+{
+    using parse_tree = lexy::compact_parse_tree<Reader, TokenKind, MemoryResource>;
+
+    static String convert(const parse_tree& tree)
+    {
+        return StringMaker<lexy::parse_tree<Reader, TokenKind, MemoryResource>>::convert(tree);
+    }
+};
+
+template <typename Reader, typename TokenKind>
+struct StringMaker<lexy::mapped_parse_tree<Reader, TokenKind>>
+{
+    using parse_tree = lexy::mapped_parse_tree<Reader, TokenKind>;
+
+    static String convert(const parse_tree& tree)
+    {
+        return StringMaker<lexy::parse_tree<Reader, TokenKind>>::convert(tree);
+    }
+};
 } // namespace doctest
 
 #endif // LEXY_EXT_PARSE_TREE_DOCTEST_HPP_INCLUDED
@@ -41,8 +41,34 @@ class diagnostic_writer
 {
 public:
     explicit diagnostic_writer(const Input& input, lexy::visualization_options opts = {})
-    : _input(&input), _opts(opts)
+    : _input(&input), _index(nullptr), _opts(opts)
     {}
+    /// Uses the line index to compute locations.
+    explicit diagnostic_writer(const Input& input, const lexy::input_line_index<Input>& index,
+                               lexy::visualization_options opts = {})
+    : _input(&input), _index(&index), _opts(opts)
+    {}
+
+    //=== locations ===//
+    /// Computes the location of the position, using the line index if there is one.
+    auto location(typename lexy::input_reader<Input>::iterator position) const
+    {
+        return location(position, lexy::input_location_anchor(*_input));
+    }
+    /// Computes the location of the position, starting the search at the anchor.
+    auto location(typename lexy::input_reader<Input>::iterator position,
+                  lexy::input_location_anchor<Input>           anchor) const
+    {
+        // Only inputs with random access iterators can have an index.
+        if constexpr (lexy::_detail::is_random_access_iterator<
+                          typename lexy::input_reader<Input>::iterator>)
+        {
+            if (_index != nullptr)
+                return lexy::get_input_location(*_input, position, *_index);
+        }
+
+        return lexy::get_input_location(*_input, position, anchor);
+    }
 
     //=== writers ===//
     /// Writes a message.
@@ -226,24 +252,22 @@ private:
         return "";
     }
 
-    const Input*                _input;
-    lexy::visualization_options _opts;
+    const Input*                         _input;
+    const lexy::input_line_index<Input>* _index;
+    lexy::visualization_options          _opts;
 };
 } // namespace lexy_ext
 
 namespace lexy_ext::_detail
 {
 template <typename OutputIt, typename Input, typename Reader, typename Tag>
-OutputIt write_error(OutputIt out, const lexy::error_context<Input>& context,
-                     const lexy::error<Reader, Tag>& error, lexy::visualization_options opts,
-                     const char* path)
+OutputIt write_error(OutputIt out, const diagnostic_writer<Input>& writer,
+                     const lexy::error_context<Input>& context,
+                     const lexy::error<Reader, Tag>& error, const char* path)
 {
-    diagnostic_writer<Input> writer(context.input(), opts);
-
     // Convert the context location and error location into line/column information.
-    auto context_location = lexy::get_input_location(context.input(), context.position());
-    auto location
-        = lexy::get_input_location(context.input(), error.position(), context_location.anchor());
+    auto context_location = writer.location(context.position());
+    auto location         = writer.location(error.position(), context_location.anchor());
 
     // Write the main error headline.
     out = writer.write_message(out, diagnostic_kind::error,
@@ -313,22 +337,33 @@ OutputIt write_error(OutputIt out, const lexy::error_context<Input>& context,
 
     return out;
 }
+
+template <typename OutputIt, typename Input, typename Reader, typename Tag>
+OutputIt write_error(OutputIt out, const lexy::error_context<Input>& context,
+                     const lexy::error<Reader, Tag>& error, lexy::visualization_options opts,
+                     const char* path)
+{
+    diagnostic_writer<Input> writer(context.input(), opts);
+    return write_error(out, writer, context, error, path);
+}
 } // namespace lexy_ext::_detail
 
 namespace lexy_ext
 {
-template <typename OutputIterator>
+template <typename OutputIterator, typename LineIndex = void>
 struct _report_error
 {
     OutputIterator              _iter;
     lexy::visualization_options _opts;
     const char*                 _path;
+    const LineIndex*            _index;
 
     struct _sink
     {
         OutputIterator              _iter;
         lexy::visualization_options _opts;
         const char*                 _path;
+        const LineIndex*            _index;
         std::size_t                 _count;
 
         using return_type = std::size_t;
@@ -337,7 +372,17 @@ struct _report_error
         void operator()(const lexy::error_context<Input>& context,
                         const lexy::error<Reader, Tag>&   error)
         {
-            _iter = _detail::write_error(_iter, context, error, _opts, _path);
+            if constexpr (std::is_same_v<LineIndex, lexy::input_line_index<Input>>)
+            {
+                LEXY_PRECONDITION(_index != nullptr);
+                diagnostic_writer<Input> writer(context.input(), *_index, _opts);
+                _iter = _detail::write_error(_iter, writer, context, error, _path);
+            }
+            else
+            {
+                static_assert(std::is_void_v<LineIndex>, "line index is for a different input");
+                _iter = _detail::write_error(_iter, context, error, _opts, _path);
+            }
             ++_count;
         }
 
@@ -350,26 +395,34 @@ struct _report_error
     };
     constexpr auto sink() const
     {
-        return _sink{_iter, _opts, _path, 0};
+        return _sink{_iter, _opts, _path, _index, 0};
     }
 
     /// Specifies a path that will be printed alongside the diagnostic.
     constexpr _report_error path(const char* path) const
     {
-        return {_iter, _opts, path};
+        return {_iter, _opts, path, _index};
     }
 
     /// Specifies an output iterator where the errors are written to.
     template <typename OI>
-    constexpr _report_error<OI> to(OI out) const
+    constexpr _report_error<OI, LineIndex> to(OI out) const
     {
-        return {out, _opts, _path};
+        return {out, _opts, _path, _index};
     }
 
     /// Overrides visualization options.
     constexpr _report_error opts(lexy::visualization_options opts) const
     {
-        return {_iter, opts, _path};
+        return {_iter, opts, _path, _index};
+    }
+
+    /// Specifies a line index of the input that is used to compute the error locations.
+    template <typename Input>
+    constexpr _report_error<OutputIterator, lexy::input_line_index<Input>> index(
+        const lexy::input_line_index<Input>& index) const
+    {
+        return {_iter, _opts, _path, &index};
     }
 };
 
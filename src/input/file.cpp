@@ -108,6 +108,54 @@ lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, vo
     return lexy::file_error::_success;
 }
 
+lexy::file_error lexy::_detail::map_file(const char* path, std::size_t padding,
+                                         file_mapping* mapping)
+{
+    raii_fd fd(::open(path, O_RDONLY));
+    if (fd < 0)
+        return get_file_error();
+
+    auto off = ::lseek(fd, 0, SEEK_END);
+    if (off == static_cast<::off_t>(-1))
+        return lexy::file_error::os_error;
+    auto size = static_cast<std::size_t>(off);
+
+    auto page_size    = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    auto mapping_size = (size + padding + page_size - 1) / page_size * page_size;
+
+    // We first reserve zero-initialized memory for the file and the padding.
+    // That way, the padding is guaranteed to be accessible even if the file ends on a page
+    // boundary.
+    auto memory
+        = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (memory == MAP_FAILED) // NOLINT: int-to-ptr conversion happens in header
+        return lexy::file_error::os_error;
+
+    if (size > 0)
+    {
+        // Then we map the file over the beginning of it.
+        // The remainder of the last page of the file is zero-filled by the OS; as it is a private
+        // mapping, writing the padding into it does not modify the file.
+        auto file_memory = ::mmap(memory, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+                                  fd, 0);
+        if (file_memory == MAP_FAILED) // NOLINT: int-to-ptr conversion happens in header
+        {
+            ::munmap(memory, mapping_size);
+            return lexy::file_error::os_error;
+        }
+    }
+
+    mapping->memory       = static_cast<char*>(memory);
+    mapping->size         = size;
+    mapping->mapping_size = mapping_size;
+    return lexy::file_error::_success;
+}
+
+void lexy::_detail::unmap_file(const file_mapping& mapping) noexcept
+{
+    ::munmap(mapping.memory, mapping.mapping_size);
+}
+
 #else // portable read_file() using C I/O
 
 namespace
@@ -184,6 +232,43 @@ lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, vo
     return file_error::_success;
 }
 
+lexy::file_error lexy::_detail::map_file(const char* path, std::size_t padding,
+                                         file_mapping* mapping)
+{
+    // We cannot map the file, so we read it into zero-initialized memory instead.
+    raii_file file(std::fopen(path, "rb"));
+    if (!file)
+        return get_file_error();
+
+    if (std::fseek(file, 0, SEEK_END) != 0)
+        return lexy::file_error::os_error;
+
+    auto size = std::ftell(file);
+    if (size == -1)
+        return lexy::file_error::os_error;
+
+    if (std::fseek(file, 0, SEEK_SET) != 0)
+        return lexy::file_error::os_error;
+
+    auto mapping_size = std::size_t(size) + padding;
+    auto memory       = new char[mapping_size]();
+    if (std::fread(memory, sizeof(char), std::size_t(size), file) != std::size_t(size))
+    {
+        delete[] memory;
+        return lexy::file_error::os_error;
+    }
+
+    mapping->memory       = memory;
+    mapping->size         = std::size_t(size);
+    mapping->mapping_size = mapping_size;
+    return file_error::_success;
+}
+
+void lexy::_detail::unmap_file(const file_mapping& mapping) noexcept
+{
+    delete[] mapping.memory;
+}
+
 #endif
 
 // When reading from stdin, performance doesn't really matter.
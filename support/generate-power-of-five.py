@@ -0,0 +1,58 @@
+#!/usr/bin/python
+# Generate the header file containing the table of 128-bit approximations of powers of five.
+# It is used by the Eisel-Lemire algorithm to convert decimal floating-point numbers, see
+# https://arxiv.org/abs/2101.11408.
+# For negative powers, the approximation is rounded up, for positive ones it is truncated.
+
+SMALLEST_POWER = -342
+LARGEST_POWER  = 308
+
+def power_of_five_128(q):
+    if q < 0:
+        power5 = 5 ** -q
+        z = 0
+        while (1 << z) < power5:
+            z += 1
+        if q >= -27:
+            b = z + 127
+            c = 2 ** b // power5 + 1
+        else:
+            b = 2 * z + 2 * 64
+            c = 2 ** b // power5 + 1
+            while c >= (1 << 128):
+                c //= 2
+        return c
+    else:
+        power5 = 5 ** q
+        while power5 < (1 << 127):
+            power5 *= 2
+        while power5 >= (1 << 128):
+            power5 //= 2
+        return power5
+
+def generate():
+    yield '// AUTOGENERATED FILE --- DO NOT EDIT!\n'
+    yield '// Generated by `support/generate-power-of-five.py`.\n'
+    yield '\n'
+    yield 'namespace lexy::_detail\n'
+    yield '{\n'
+    yield f'constexpr int power_of_five_128_smallest = {SMALLEST_POWER};\n'
+    yield f'constexpr int power_of_five_128_largest  = {LARGEST_POWER};\n'
+    yield '\n'
+    yield '// The high and low 64 bits of the approximation of 5^q, for q from smallest to largest.\n'
+    yield 'constexpr std::uint64_t power_of_five_128[] = {\n'
+    for q in range(SMALLEST_POWER, LARGEST_POWER + 1):
+        c = power_of_five_128(q)
+        yield f'    0x{c >> 64:016x}, 0x{c & ((1 << 64) - 1):016x}, // {q}\n'
+    yield '};\n'
+    yield '} // namespace lexy::_detail\n'
+
+#=== main ===#
+import sys
+
+if len(sys.argv) < 2:
+    print(f'usage: {sys.argv[0]} <output-file>')
+    sys.exit(1)
+
+with open(sys.argv[1], "w") as output_file:
+    print(''.join(generate()), file=output_file, end='')
@@ -4,6 +4,7 @@
 #include <lexy/action/parse_as_tree.hpp>
 
 #include <doctest/doctest.h>
+#include <lexy/compact_parse_tree.hpp>
 #include <lexy/dsl.hpp>
 #include <lexy/input/string_input.hpp>
 #include <lexy_ext/parse_tree_doctest.hpp>
@@ -239,3 +240,164 @@ TEST_CASE("parse_as_tree")
     }
 }
 
+
+TEST_CASE("parse_as_tree compact_parse_tree")
+{
+    using parse_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+    parse_tree tree;
+
+    SUBCASE("whitespace")
+    {
+        auto input  = lexy::zstring_input("123 ( abc //  \n) 321!!!");
+        auto result = lexy::parse_as_tree<root_p>(tree, input, lexy::noop);
+        CHECK(result);
+
+        // clang-format off
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+            .token(token_kind::a, "123")
+            .whitespace(" ")
+            .production(child_p{})
+                .token(token_kind::b, "(")
+                .whitespace(" ")
+                .production("abc_p")
+                    .token(token_kind::c, "abc")
+                    .finish()
+                .whitespace(" //  \\{a}")
+                .token(token_kind::b, ")")
+                .whitespace(" ")
+                .finish()
+            .token(token_kind::a, "321");
+        // clang-format on
+        CHECK(tree == expected);
+        CHECK(tree.remaining_input().begin() == input.data() + 20);
+        CHECK(tree.remaining_input().end() == input.data() + 23);
+    }
+    SUBCASE("failure")
+    {
+        auto input  = lexy::zstring_input("123(abc");
+        auto result = lexy::parse_as_tree<root_p>(tree, input, lexy::noop);
+        CHECK(!result);
+        CHECK(tree.empty());
+        CHECK(tree.remaining_input().empty());
+    }
+    SUBCASE("recovered")
+    {
+        auto input  = lexy::zstring_input("123(abxxx)321");
+        auto result = lexy::parse_as_tree<root_p>(tree, input, lexy::noop);
+        CHECK(!result);
+        // clang-format off
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+            .token(token_kind::a, "123")
+            .production(child_p{})
+                .token(token_kind::b, "(")
+                .token(lexy::error_token_kind, "abxxx")
+                .token(token_kind::b, ")")
+                .finish()
+            .token(token_kind::a, "321");
+        // clang-format on
+        CHECK(tree == expected);
+    }
+}
+
+TEST_CASE("parse_as_tree token filter")
+{
+    auto input = lexy::zstring_input("123 ( abc //  \n) 321");
+
+    SUBCASE("drop_tokens")
+    {
+        using parse_tree = lexy::parse_tree_for<lexy::string_input<>, token_kind>;
+        using filter     = lexy::drop_tokens<lexy::whitespace_token_kind, token_kind::b>;
+
+        parse_tree tree;
+        auto       result = lexy::parse_as_tree<root_p, filter>(tree, input, lexy::noop);
+        CHECK(result);
+
+        // clang-format off
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+            .token(token_kind::a, "123")
+            .production(child_p{})
+                .token(lexy::position_token_kind, "")
+                .production("abc_p")
+                    .token(token_kind::c, "abc")
+                    .finish()
+                .token(lexy::position_token_kind, "")
+                .token(lexy::position_token_kind, "")
+                .finish()
+            .token(token_kind::a, "321");
+        // clang-format on
+        CHECK(tree == expected);
+        CHECK(tree.size() == 9);
+
+        // The production still begins at the dropped parenthesis and ends after the dropped
+        // parenthesis and whitespace.
+        auto child = *++tree.root().children().begin();
+        CHECK(child.kind() == child_p{});
+        CHECK(child.position() == input.data() + 4);
+        CHECK(child.covering_lexeme().begin() == input.data() + 4);
+        CHECK(child.covering_lexeme().end() == input.data() + 17);
+
+        // The production before the dropped whitespace still ends before it.
+        auto abc = *++child.children().begin();
+        CHECK(abc.covering_lexeme().begin() == input.data() + 6);
+        CHECK(abc.covering_lexeme().end() == input.data() + 9);
+    }
+    SUBCASE("keep_tokens")
+    {
+        using parse_tree = lexy::parse_tree_for<lexy::string_input<>, token_kind>;
+        using filter     = lexy::keep_tokens<token_kind::a>;
+
+        parse_tree tree;
+        auto       result = lexy::parse_as_tree<root_p, filter>(tree, input, lexy::noop);
+        CHECK(result);
+
+        // clang-format off
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+            .token(token_kind::a, "123")
+            .production(child_p{})
+                .token(lexy::position_token_kind, "")
+                .production("abc_p")
+                    .token(lexy::position_token_kind, "")
+                    .token(lexy::position_token_kind, "")
+                    .finish()
+                .token(lexy::position_token_kind, "")
+                .token(lexy::position_token_kind, "")
+                .finish()
+            .token(token_kind::a, "321");
+        // clang-format on
+        CHECK(tree == expected);
+
+        // A production whose only token is dropped keeps its span.
+        auto abc = *++(*++tree.root().children().begin()).children().begin();
+        CHECK(abc.position() == input.data() + 6);
+        CHECK(abc.covering_lexeme().begin() == input.data() + 6);
+        CHECK(abc.covering_lexeme().end() == input.data() + 9);
+    }
+    SUBCASE("compact_parse_tree")
+    {
+        using parse_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+        using filter     = lexy::drop_tokens<lexy::whitespace_token_kind, token_kind::b>;
+
+        parse_tree tree;
+        auto       result = lexy::parse_as_tree<root_p, filter>(tree, input, lexy::noop);
+        CHECK(result);
+
+        // clang-format off
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+            .token(token_kind::a, "123")
+            .production(child_p{})
+                .token(lexy::position_token_kind, "")
+                .production("abc_p")
+                    .token(token_kind::c, "abc")
+                    .finish()
+                .token(lexy::position_token_kind, "")
+                .token(lexy::position_token_kind, "")
+                .finish()
+            .token(token_kind::a, "321");
+        // clang-format on
+        CHECK(tree == expected);
+        CHECK(tree.size() == 9);
+
+        auto child = *++tree.root().children().begin();
+        CHECK(child.covering_lexeme().end() == input.data() + 17);
+    }
+}
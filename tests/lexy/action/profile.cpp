@@ -0,0 +1,193 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/action/profile.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/dsl.hpp>
+#include <lexy/input/string_input.hpp>
+
+namespace
+{
+namespace dsl = lexy::dsl;
+
+struct number
+{
+    static constexpr auto name = "number";
+    static constexpr auto rule = dsl::identifier(dsl::ascii::digit);
+};
+
+struct list
+{
+    static constexpr auto name = "list";
+    static constexpr auto rule
+        = dsl::square_bracketed.list(dsl::p<number> | dsl::recurse_branch<list>,
+                                     dsl::sep(dsl::comma));
+};
+
+struct document
+{
+    static constexpr auto name       = "document";
+    static constexpr auto whitespace = dsl::ascii::space;
+    static constexpr auto rule       = dsl::p<list> + dsl::eof;
+};
+
+struct keyword
+{
+    static constexpr auto name = "keyword";
+    static constexpr auto rule = LEXY_LIT("abcd");
+};
+
+struct other_keyword
+{
+    static constexpr auto name = "other_keyword";
+    static constexpr auto rule = LEXY_LIT("abcx");
+};
+
+struct letters
+{
+    static constexpr auto name = "letters";
+    static constexpr auto rule
+        = dsl::list(LEXY_LIT("a") | LEXY_LIT("b") | LEXY_LIT("c")) + dsl::eof;
+};
+
+struct keywords
+{
+    static constexpr auto name = "keywords";
+    static constexpr auto rule
+        = dsl::peek(LEXY_LIT("ab")) + (dsl::p<keyword> | dsl::p<other_keyword>) + dsl::eof;
+};
+} // namespace
+
+TEST_CASE("profile")
+{
+    lexy::profile_report<> report;
+    CHECK(report.empty());
+    CHECK(report.find(document{}) == nullptr);
+
+    SUBCASE("basic")
+    {
+        auto result = lexy::profile<document>(report, lexy::zstring_input("[1, [22, 333]]"));
+        CHECK(result);
+        CHECK(report.size() == 3);
+
+        auto doc = report.find(document{});
+        REQUIRE(doc != nullptr);
+        CHECK(doc->entry_count == 1);
+        CHECK(doc->success_count == 1);
+        CHECK(doc->failure_count == 0);
+        CHECK(doc->consumed == 14);
+
+        auto l = report.find(list{});
+        REQUIRE(l != nullptr);
+        CHECK(l->entry_count == 2);
+        CHECK(l->success_count == 2);
+        CHECK(l->consumed == 14 + 9);
+
+        auto n = report.find(number{});
+        REQUIRE(n != nullptr);
+        // It is also started and canceled as branch condition before the nested list.
+        CHECK(n->entry_count == 4);
+        CHECK(n->success_count == 3);
+        CHECK(n->failure_count == 1);
+        CHECK(n->consumed == 1 + 2 + 3);
+
+        // The nested list is only counted once.
+        CHECK(doc->total_time >= l->total_time);
+        CHECK(l->total_time >= l->self_time);
+        CHECK(doc->total_time.count()
+              == doc->self_time.count() + l->self_time.count() + n->self_time.count());
+
+        // Branch conditions fail on the first character, so nothing is examined twice.
+        CHECK(n->backtrack_count == 0);
+        CHECK(report.input_size() == 14);
+        CHECK(report.rescanned() == 0);
+        CHECK(report.amplification() == 1);
+    }
+    SUBCASE("backtracking")
+    {
+        auto result = lexy::profile<keywords>(report, lexy::zstring_input("abcx"));
+        CHECK(result);
+
+        // dsl::peek() examines "ab" before the choice.
+        auto root = report.find(keywords{});
+        REQUIRE(root != nullptr);
+        CHECK(root->backtrack_count == 1);
+        CHECK(root->rescanned == 2);
+
+        // The literal of keyword examines "abc" before it fails.
+        auto kw = report.find(keyword{});
+        REQUIRE(kw != nullptr);
+        CHECK(kw->failure_count == 1);
+        CHECK(kw->backtrack_count == 1);
+        CHECK(kw->rescanned == 3);
+
+        auto other = report.find(other_keyword{});
+        REQUIRE(other != nullptr);
+        CHECK(other->backtrack_count == 0);
+
+        CHECK(report.input_size() == 4);
+        CHECK(report.rescanned() == 5);
+        CHECK(report.amplification() == 2.25);
+    }
+    SUBCASE("choice")
+    {
+        auto result = lexy::profile<letters>(report, lexy::zstring_input("abcab"));
+        CHECK(result);
+
+        // The choice only peeks at the next code unit to select the branch, which isn't a
+        // backtrack.
+        auto root = report.find(letters{});
+        REQUIRE(root != nullptr);
+        CHECK(root->backtrack_count == 0);
+        CHECK(report.amplification() == 1);
+    }
+    SUBCASE("failure")
+    {
+        auto result = lexy::profile<document>(report, lexy::zstring_input("x"));
+        CHECK(!result);
+
+        auto doc = report.find(document{});
+        REQUIRE(doc != nullptr);
+        CHECK(doc->entry_count == 1);
+        CHECK(doc->failure_count == 1);
+
+        auto l = report.find(list{});
+        REQUIRE(l != nullptr);
+        CHECK(l->failure_count == 1);
+        CHECK(l->consumed == 0);
+    }
+    SUBCASE("accumulate")
+    {
+        CHECK(lexy::profile<document>(report, lexy::zstring_input("[1]")));
+        CHECK(lexy::profile<document>(report, lexy::zstring_input("[1, 2]")));
+        CHECK(report.size() == 3);
+        CHECK(report.find(document{})->entry_count == 2);
+        CHECK(report.find(number{})->entry_count == 3);
+
+        CHECK(report.input_size() == 3 + 6);
+
+        report.clear();
+        CHECK(report.empty());
+        CHECK(report.input_size() == 0);
+        CHECK(report.find(number{}) == nullptr);
+
+        CHECK(lexy::profile<document>(report, lexy::zstring_input("[1]")));
+        CHECK(report.find(number{})->entry_count == 1);
+    }
+    SUBCASE("sort")
+    {
+        CHECK(lexy::profile<document>(report, lexy::zstring_input("[1, [2, 3], 4]")));
+
+        report.sort([](const lexy::profile_entry& lhs, const lexy::profile_entry& rhs) {
+            return lhs.entry_count > rhs.entry_count;
+        });
+        REQUIRE(report.size() == 3);
+        CHECK(report.begin()[0].production == number{});
+        CHECK(report.begin()[1].production == list{});
+        CHECK(report.begin()[2].production == document{});
+
+        // Lookup still works after sorting.
+        CHECK(report.find(list{})->entry_count == 2);
+    }
+}
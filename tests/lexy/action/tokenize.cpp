@@ -0,0 +1,156 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/action/tokenize.hpp>
+
+#include <doctest/doctest.h>
+#include <initializer_list>
+#include <lexy/dsl.hpp>
+#include <lexy/input/string_input.hpp>
+#include <string>
+
+namespace
+{
+enum class token_kind
+{
+    a,
+    b,
+    c,
+};
+
+const char* token_kind_name(token_kind k)
+{
+    switch (k)
+    {
+    case token_kind::a:
+        return "a";
+    case token_kind::b:
+        return "b";
+    case token_kind::c:
+        return "c";
+    }
+
+    return "";
+}
+
+struct abc_p : lexy::token_production
+{
+    static constexpr auto name = "abc_p";
+    static constexpr auto rule = LEXY_LIT("abc").kind<token_kind::c>;
+};
+
+struct child_p
+{
+    static constexpr auto name = "child_p";
+    static constexpr auto rule = lexy::dsl::parenthesized.try_(lexy::dsl::p<abc_p>);
+};
+
+struct root_p
+{
+    static constexpr auto name       = "root_p";
+    static constexpr auto whitespace = lexy::dsl::ascii::space;
+
+    static constexpr auto rule = [] {
+        auto digits = lexy::dsl::digits<>.kind<token_kind::a>;
+        return digits + lexy::dsl::p<child_p> + digits;
+    }();
+};
+
+struct expected_token
+{
+    lexy::token_kind<token_kind> kind;
+    const char*                  spelling;
+};
+
+template <typename Stream>
+bool equal_tokens(const Stream& stream, std::initializer_list<expected_token> expected)
+{
+    if (stream.size() != expected.size())
+        return false;
+
+    auto cur = stream.begin();
+    for (auto token : expected)
+    {
+        auto lexeme = (*cur).lexeme();
+        if ((*cur).kind() != token.kind
+            || std::string(lexeme.begin(), lexeme.end()) != token.spelling)
+            return false;
+        ++cur;
+    }
+    return cur == stream.end();
+}
+} // namespace
+
+template <>
+constexpr auto lexy::token_kind_map_for<token_kind>
+    = lexy::token_kind_map.map<::token_kind::b>(lexy::dsl::parenthesized.open())
+          .map<::token_kind::b>(lexy::dsl::parenthesized.close());
+
+TEST_CASE("tokenize")
+{
+    using token_stream = lexy::token_stream_for<lexy::string_input<>, token_kind>;
+    token_stream stream;
+    CHECK(stream.empty());
+
+    SUBCASE("basic")
+    {
+        auto input  = lexy::zstring_input("123 ( abc ) 321!!!");
+        auto result = lexy::tokenize<root_p>(stream, input, lexy::noop);
+        CHECK(result);
+
+        CHECK(equal_tokens(stream, {{token_kind::a, "123"},
+                                    {lexy::whitespace_token_kind, " "},
+                                    {token_kind::b, "("},
+                                    {lexy::whitespace_token_kind, " "},
+                                    {token_kind::c, "abc"},
+                                    {lexy::whitespace_token_kind, " "},
+                                    {token_kind::b, ")"},
+                                    {lexy::whitespace_token_kind, " "},
+                                    {token_kind::a, "321"}}));
+        CHECK(stream[4].position() == input.data() + 6);
+        CHECK(stream.remaining_input().begin() == input.data() + 15);
+        CHECK(stream.remaining_input().end() == input.data() + 18);
+    }
+    SUBCASE("failure")
+    {
+        auto input  = lexy::zstring_input("123(abc");
+        auto result = lexy::tokenize<root_p>(stream, input, lexy::noop);
+        CHECK(!result);
+        CHECK(stream.empty());
+        CHECK(stream.remaining_input().empty());
+    }
+    SUBCASE("recovered")
+    {
+        auto input  = lexy::zstring_input("123(abxxx)321");
+        auto result = lexy::tokenize<root_p>(stream, input, lexy::noop);
+        CHECK(!result);
+        CHECK(result.error_count() == 1);
+
+        // The cancelled production is an error token, which is merged with the recovery.
+        CHECK(equal_tokens(stream, {{token_kind::a, "123"},
+                                    {token_kind::b, "("},
+                                    {lexy::error_token_kind, "abxxx"},
+                                    {token_kind::b, ")"},
+                                    {token_kind::a, "321"}}));
+    }
+    SUBCASE("reuse")
+    {
+        stream.reserve(1024);
+
+        auto input = lexy::zstring_input("1(abc)2");
+        CHECK(lexy::tokenize<root_p>(stream, input, lexy::noop));
+        CHECK(stream.size() == 5);
+
+        // The previous tokens are replaced.
+        auto other = lexy::zstring_input("3(abc)4");
+        CHECK(lexy::tokenize<root_p>(stream, other, lexy::noop));
+        CHECK(equal_tokens(stream, {{token_kind::a, "3"},
+                                    {token_kind::b, "("},
+                                    {token_kind::c, "abc"},
+                                    {token_kind::b, ")"},
+                                    {token_kind::a, "4"}}));
+
+        stream.clear();
+        CHECK(stream.empty());
+    }
+}
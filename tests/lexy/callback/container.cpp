@@ -6,6 +6,7 @@
 #include <doctest/doctest.h>
 #include <lexy/callback/adapter.hpp>
 #include <lexy/dsl/option.hpp>
+#include <lexy/memory_resource.hpp>
 #include <set>
 #include <string>
 #include <vector>
@@ -98,6 +99,21 @@ TEST_CASE("as_list")
         auto result = LEXY_MOV(cb).finish();
         CHECK(result == decltype(result)({"a", "b", "c"}, 42));
     }
+    SUBCASE("sink state memory resource")
+    {
+        using allocator = lexy::memory_resource_allocator<int, lexy::monotonic_resource>;
+        constexpr auto sink = lexy::as_list<std::vector<int, allocator>>.allocator();
+
+        lexy::monotonic_resource resource;
+        auto                     cb = sink.sink(resource);
+        cb(1);
+        cb(2);
+        cb(3);
+
+        auto result = LEXY_MOV(cb).finish();
+        CHECK(result == std::vector<int, allocator>({1, 2, 3}, resource));
+        CHECK(result.get_allocator().resource() == &resource);
+    }
 }
 
 TEST_CASE("as_collection")
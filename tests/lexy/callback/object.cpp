@@ -4,6 +4,7 @@
 #include <lexy/callback/object.hpp>
 
 #include <doctest/doctest.h>
+#include <lexy/memory_resource.hpp>
 #include <memory>
 
 TEST_CASE("construct")
@@ -84,5 +85,25 @@ TEST_CASE("new_")
         CHECK(result->a == 11);
         CHECK(result->b == 3.14f);
     }
+    SUBCASE("resource")
+    {
+        struct type
+        {
+            int   a;
+            float b;
+        };
+        struct state
+        {
+            lexy::monotonic_resource resource;
+        };
+
+        state s;
+        auto  cb = lexy::new_<type>.resource(&state::resource);
+
+        type* result = cb[s](11, 3.14f);
+        CHECK(result->a == 11);
+        CHECK(result->b == 3.14f);
+        CHECK(*lexy::new_<int>.resource()[s.resource](42) == 42);
+    }
 }
 
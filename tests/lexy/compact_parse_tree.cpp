@@ -0,0 +1,377 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/compact_parse_tree.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/dsl/any.hpp>
+#include <lexy/input/string_input.hpp>
+#include <lexy_ext/parse_tree_doctest.hpp>
+#include <vector>
+
+namespace
+{
+enum class token_kind
+{
+    a,
+    b,
+    c,
+};
+
+const char* token_kind_name(token_kind k)
+{
+    switch (k)
+    {
+    case token_kind::a:
+        return "a";
+    case token_kind::b:
+        return "b";
+    case token_kind::c:
+        return "c";
+    }
+
+    return "";
+}
+
+struct child_p
+{
+    static constexpr auto name = "child_p";
+    static constexpr auto rule = lexy::dsl::any;
+};
+
+struct other_p
+{
+    static constexpr auto name = "other_p";
+    static constexpr auto rule = lexy::dsl::any;
+};
+
+struct root_p
+{
+    static constexpr auto name = "root_p";
+    static constexpr auto rule = lexy::dsl::any;
+};
+} // namespace
+
+TEST_CASE("compact_parse_tree::builder")
+{
+    using parse_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+    auto input       = lexy::zstring_input("abc");
+
+    SUBCASE("empty")
+    {
+        parse_tree tree;
+        CHECK(tree.empty());
+        CHECK(tree.size() == 0);
+        CHECK(tree.remaining_input().empty());
+    }
+
+    SUBCASE("empty root")
+    {
+        auto tree = parse_tree::builder(root_p{}, input.data()).finish(input.data());
+        CHECK(!tree.empty());
+        CHECK(tree.size() == 1);
+        CHECK(tree.depth() == 0);
+        CHECK(tree.remaining_input().empty());
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{});
+        CHECK(tree == expected);
+    }
+    SUBCASE("root node with child tokens and remaining input")
+    {
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+
+            builder.token(token_kind::a, input.data(), input.data() + 1);
+            builder.token(token_kind::b, input.data() + 1, input.data() + 2);
+
+            return LEXY_MOV(builder).finish({input.data() + 2, input.data() + 3});
+        }();
+        CHECK(!tree.empty());
+        CHECK(tree.size() == 3);
+        CHECK(tree.depth() == 1);
+        CHECK(tree.remaining_input().begin() == input.data() + 2);
+        CHECK(tree.remaining_input().end() == input.data() + 3);
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+                            .token(token_kind::a, "a")
+                            .token(token_kind::b, "b");
+        CHECK(tree == expected);
+    }
+
+    SUBCASE("production node with child production nodes")
+    {
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+
+            auto child = builder.start_production(child_p{});
+            builder.token(token_kind::a, input.data(), input.data() + 1);
+
+            auto grand_child = builder.start_production(other_p{});
+            builder.token(token_kind::b, input.data() + 1, input.data() + 2);
+            builder.finish_production(LEXY_MOV(grand_child));
+
+            builder.token(token_kind::c, input.data() + 2, input.data() + 3);
+            builder.finish_production(LEXY_MOV(child));
+
+            return LEXY_MOV(builder).finish(input.data() + 3);
+        }();
+        CHECK(!tree.empty());
+        CHECK(tree.size() == 6);
+        CHECK(tree.depth() == 3);
+        CHECK(tree.remaining_input().empty());
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+                            .production(child_p{})
+                            .token(token_kind::a, "a")
+                            .production(other_p{})
+                            .token(token_kind::b, "b")
+                            .finish()
+                            .token(token_kind::c, "c")
+                            .finish();
+        CHECK(tree == expected);
+    }
+    SUBCASE("cancelled production node")
+    {
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+
+            auto child = builder.start_production(child_p{});
+            builder.token(token_kind::a, input.data(), input.data() + 1);
+            builder.cancel_production(LEXY_MOV(child));
+
+            builder.token(lexy::error_token_kind, input.data(), input.data() + 1);
+            builder.token(lexy::error_token_kind, input.data() + 1, input.data() + 2);
+
+            child = builder.start_production(other_p{});
+            builder.token(token_kind::c, input.data() + 2, input.data() + 3);
+            builder.finish_production(LEXY_MOV(child));
+
+            return LEXY_MOV(builder).finish(input.data() + 3);
+        }();
+        CHECK(!tree.empty());
+        CHECK(tree.size() == 4);
+        CHECK(tree.depth() == 2);
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+                            .token(lexy::error_token_kind, "ab")
+                            .production(other_p{})
+                            .token(token_kind::c, "c")
+                            .finish();
+        CHECK(tree == expected);
+    }
+    SUBCASE("production node with child container")
+    {
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+
+            auto child = builder.start_production(child_p{});
+            builder.token(token_kind::a, input.data(), input.data() + 1);
+
+            auto grand_child = builder.start_container();
+            builder.token(token_kind::b, input.data() + 1, input.data() + 2);
+            builder.set_container_production(other_p{});
+            builder.finish_container(LEXY_MOV(grand_child));
+
+            builder.token(token_kind::c, input.data() + 2, input.data() + 3);
+            builder.finish_production(LEXY_MOV(child));
+
+            return LEXY_MOV(builder).finish(input.data() + 3);
+        }();
+        CHECK(!tree.empty());
+        CHECK(tree.size() == 6);
+        CHECK(tree.depth() == 3);
+        CHECK(tree.remaining_input().empty());
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+                            .production(child_p{})
+                            .token(token_kind::a, "a")
+                            .production(other_p{})
+                            .token(token_kind::b, "b")
+                            .finish()
+                            .token(token_kind::c, "c")
+                            .finish();
+        CHECK(tree == expected);
+    }
+
+    constexpr auto many_count = 1024u;
+    SUBCASE("many left associative operator")
+    {
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+
+            auto m = builder.start_container();
+            builder.token(token_kind::a, input.data(), input.data() + input.size());
+
+            for (auto i = 0u; i != many_count; ++i)
+            {
+                builder.token(token_kind::b, input.data(), input.data() + input.size());
+                builder.set_container_production(child_p{});
+            }
+
+            builder.finish_container(LEXY_MOV(m));
+            return LEXY_MOV(builder).finish(input.data() + input.size());
+        }();
+        CHECK(!tree.empty());
+        CHECK(tree.size() == 2 * many_count + 2);
+        CHECK(tree.depth() == many_count + 1);
+        CHECK(tree.remaining_input().empty());
+
+        auto expected = [&] {
+            lexy_ext::parse_tree_desc<token_kind> result(root_p{});
+            for (auto i = 0u; i != many_count; ++i)
+                result.production(child_p{});
+
+            result.token(token_kind::a, "abc");
+            result.token(token_kind::b, "abc");
+
+            for (auto i = 0u; i != many_count - 1; ++i)
+            {
+                result.finish();
+                result.token(token_kind::b, "abc");
+            }
+            return result;
+        }();
+        CHECK(tree == expected);
+    }
+
+    SUBCASE("reuse")
+    {
+        auto tree = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+            builder.token(token_kind::a, input.data(), input.data() + 1);
+            return LEXY_MOV(builder).finish(input.data() + 1);
+        }();
+        CHECK(tree.size() == 2);
+
+        tree.clear();
+        CHECK(tree.empty());
+
+        auto other = lexy::zstring_input("cba");
+        tree       = [&] {
+            parse_tree::builder builder(LEXY_MOV(tree), root_p{}, other.data());
+            builder.token(token_kind::c, other.data(), other.data() + 3);
+            return LEXY_MOV(builder).finish(other.data() + 3);
+        }();
+        CHECK(tree.size() == 2);
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{}).token(token_kind::c, "cba");
+        CHECK(tree == expected);
+        CHECK(tree.root().children().begin()->lexeme().begin() == other.data());
+    }
+}
+
+TEST_CASE("compact_parse_tree::node")
+{
+    using parse_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+    auto input       = lexy::zstring_input("123(abc)321");
+
+    auto tree = [&] {
+        parse_tree::builder builder(root_p{}, input.data());
+        builder.token(token_kind::a, input.data(), input.data() + 3);
+
+        auto child = builder.start_production(child_p{});
+        builder.token(token_kind::b, input.data() + 3, input.data() + 4);
+        builder.token(token_kind::c, input.data() + 4, input.data() + 7);
+        builder.token(token_kind::b, input.data() + 7, input.data() + 8);
+        builder.finish_production(LEXY_MOV(child));
+
+        builder.token(token_kind::a, input.data() + 8, input.data() + 11);
+
+        return LEXY_MOV(builder).finish(input.data() + 11);
+    }();
+    CHECK(!tree.empty());
+
+    auto root = tree.root();
+    CHECK(root.kind().is_root());
+    CHECK(root.kind().is_production());
+    CHECK(root.kind() == root_p{});
+    CHECK(root.kind().name() == lexy::_detail::string_view("root_p"));
+    CHECK(root.parent() == root);
+    CHECK(root.lexeme().empty());
+    CHECK(root.covering_lexeme().begin() == input.data());
+    CHECK(root.covering_lexeme().end() == input.data() + 11);
+
+    auto children = root.children();
+    CHECK(children.size() == 3);
+
+    auto iter = children.begin();
+    CHECK(iter->kind() == token_kind::a);
+    CHECK(!iter->kind().is_root());
+    CHECK(iter->lexeme().begin() == input.data());
+    CHECK(iter->lexeme().end() == input.data() + 3);
+    CHECK(iter->token().kind() == token_kind::a);
+    CHECK(iter->parent() == root);
+    CHECK(!iter->is_last_child());
+
+    ++iter;
+    {
+        auto child = *iter;
+        CHECK(child.kind() == child_p{});
+        CHECK(child.kind() != other_p{});
+        CHECK(child.kind() != root.kind());
+        CHECK(child.parent() == root);
+        CHECK(child.position() == input.data() + 3);
+        CHECK(child.covering_lexeme().begin() == input.data() + 3);
+        CHECK(child.covering_lexeme().end() == input.data() + 8);
+
+        auto grand_children = child.children();
+        CHECK(grand_children.size() == 3);
+        for (auto grand_child : grand_children)
+            CHECK(grand_child.parent() == child);
+
+        auto count = 0;
+        for (auto sibling : grand_children.begin()->siblings())
+        {
+            CHECK(sibling.parent() == child);
+            ++count;
+        }
+        CHECK(count == 2);
+    }
+
+    ++iter;
+    CHECK(iter->kind() == token_kind::a);
+    CHECK(iter->lexeme().begin() == input.data() + 8);
+    CHECK(iter->is_last_child());
+
+    ++iter;
+    CHECK(iter == children.end());
+}
+
+TEST_CASE("compact_parse_tree::traverse_range")
+{
+    using parse_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+    auto input       = lexy::zstring_input("abc");
+
+    auto tree = [&] {
+        parse_tree::builder builder(root_p{}, input.data());
+        builder.token(token_kind::a, input.data(), input.data() + 1);
+
+        auto child = builder.start_production(child_p{});
+        builder.token(token_kind::b, input.data() + 1, input.data() + 2);
+        builder.finish_production(LEXY_MOV(child));
+
+        child = builder.start_production(other_p{});
+        builder.finish_production(LEXY_MOV(child));
+
+        builder.token(token_kind::c, input.data() + 2, input.data() + 3);
+        return LEXY_MOV(builder).finish(input.data() + 3);
+    }();
+
+    std::vector<lexy::traverse_event> events;
+    for (auto [event, node] : tree.traverse())
+    {
+        (void)node;
+        events.push_back(event);
+    }
+
+    using ev = lexy::traverse_event;
+    CHECK(events
+          == std::vector<ev>{ev::enter, ev::leaf, ev::enter, ev::leaf, ev::exit, ev::enter,
+                             ev::exit, ev::leaf, ev::exit});
+
+    auto child       = *lexy::_detail::next(tree.root().children().begin());
+    auto child_range = tree.traverse(child);
+    CHECK(lexy::_detail::range_size(child_range.begin(), child_range.end()) == 3);
+
+    CHECK(parse_tree().traverse().empty());
+}
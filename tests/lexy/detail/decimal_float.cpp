@@ -0,0 +1,93 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/_detail/decimal_float.hpp>
+
+#include <cfloat>
+#include <doctest/doctest.h>
+#include <limits>
+#include <lexy/_detail/string_view.hpp>
+#include <string>
+
+namespace
+{
+template <typename T>
+constexpr T parse(lexy::_detail::string_view str)
+{
+    return lexy::_detail::parse_decimal_float<T>(str.begin(), str.end());
+}
+} // namespace
+
+TEST_CASE("parse_decimal_float")
+{
+    SUBCASE("double")
+    {
+        // Clinger fast path.
+        CHECK(parse<double>("0") == 0.0);
+        CHECK(parse<double>("000.000") == 0.0);
+        CHECK(parse<double>("1") == 1.0);
+        CHECK(parse<double>("1.5") == 1.5);
+        CHECK(parse<double>("123.456") == 123.456);
+        CHECK(parse<double>("1e22") == 1e22);
+        CHECK(parse<double>("9007199254740992") == 9007199254740992.0);
+
+        // Eisel-Lemire.
+        CHECK(parse<double>("9007199254740993") == 9007199254740992.0);
+        CHECK(parse<double>("0.1e-5") == 0.1e-5);
+        CHECK(parse<double>("3.141592653589793") == 3.141592653589793);
+        CHECK(parse<double>("1.7976931348623157e308") == DBL_MAX);
+        CHECK(parse<double>("2.2250738585072014e-308") == DBL_MIN);
+        CHECK(parse<double>("1e23") == 1e23);
+        CHECK(parse<double>("8.41e21") == 8.41e21);
+
+        // Subnormal numbers and underflow.
+        CHECK(parse<double>("4.9406564584124654e-324") == 4.9406564584124654e-324);
+        CHECK(parse<double>("2.2250738585072011e-308") == 2.2250738585072011e-308);
+        CHECK(parse<double>("2.4703282292062327e-324") == 0.0);
+        CHECK(parse<double>("1e-400") == 0.0);
+
+        // Overflow.
+        CHECK(parse<double>("1.7976931348623159e308") == std::numeric_limits<double>::infinity());
+        CHECK(parse<double>("1e400") == std::numeric_limits<double>::infinity());
+        CHECK(parse<double>("1e1000000000") == std::numeric_limits<double>::infinity());
+
+        // Halfway between two doubles, which requires looking at all digits.
+        CHECK(parse<double>("9007199254740993.0000000000000000001") == 9007199254740994.0);
+        CHECK(parse<double>("1.00000000000000011102230246251565404236316680908203125") == 1.0);
+        CHECK(parse<double>("1.00000000000000011102230246251565404236316680908203125001")
+              == 1.0000000000000002);
+        CHECK(parse<double>("2.4703282292062327208828439643411068618252990130716238221279284125"
+                            "0337753635104375932649918180817996189898282347722858865463328355177"
+                            "969898199387398005390939063150356595155702263922908583924491051844"
+                            "359318028499365361525003193704576782492193656236698636584807570236"
+                            "133e-324")
+              == 4.9406564584124654e-324);
+
+        auto many_digits = std::string(400, '1') + "e-400";
+        CHECK(lexy::_detail::parse_decimal_float<double>(many_digits.begin(), many_digits.end())
+              == 1.1111111111111111e-1);
+        auto many_zeroes = "0." + std::string(400, '0') + "1e401";
+        CHECK(lexy::_detail::parse_decimal_float<double>(many_zeroes.begin(), many_zeroes.end())
+              == 1.0);
+    }
+    SUBCASE("float")
+    {
+        CHECK(parse<float>("0") == 0.0f);
+        CHECK(parse<float>("1.5") == 1.5f);
+        CHECK(parse<float>("16777217") == 16777216.0f);
+        CHECK(parse<float>("3.4028234663852886e38") == FLT_MAX);
+        CHECK(parse<float>("1.1754943508222875e-38") == FLT_MIN);
+        CHECK(parse<float>("1.4e-45") == 1.4e-45f);
+        CHECK(parse<float>("1e-50") == 0.0f);
+        CHECK(parse<float>("3.5e38") == std::numeric_limits<float>::infinity());
+        CHECK(parse<float>("1.00000005960464477539062500001") == 1.00000012f);
+    }
+    SUBCASE("constexpr")
+    {
+        static_assert(parse<double>("1.5") == 1.5);
+        static_assert(parse<double>("2.2250738585072011e-308") == 2.2250738585072011e-308);
+        static_assert(parse<double>("1e-320") == 1e-320);
+        static_assert(parse<double>("1e400") == std::numeric_limits<double>::infinity());
+        static_assert(parse<float>("0.1") == 0.1f);
+    }
+}
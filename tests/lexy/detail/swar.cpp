@@ -141,3 +141,125 @@ TEST_CASE("swar_has_char")
     }
 }
 
+
+namespace
+{
+constexpr const char* unbounded = nullptr;
+
+template <simd_level Level>
+void test_simd_find()
+{
+    using stop = simd_stop_chars<char, 0xF, '"', '\\'>;
+
+    // The memory is padded by a full block after the stop char.
+    char memory[128 + simd_block_size];
+    for (auto& c : memory)
+        c = 'a';
+    memory[sizeof(memory) - simd_block_size] = '"';
+
+    for (auto pos = 0u; pos != 128; ++pos)
+    {
+        auto old    = memory[pos];
+        memory[pos] = '\\';
+        CHECK(simd_find<Level>(memory, unbounded, stop{}) == memory + pos);
+        memory[pos] = '\n';
+        CHECK(simd_find<Level>(memory + 1, unbounded, stop{}) == (pos == 0 ? memory + 128 : memory + pos));
+        memory[pos] = old;
+    }
+    CHECK(simd_find<Level>(memory, unbounded, stop{}) == memory + 128);
+
+    // With an end, it stops before reading past it.
+    auto end = memory + 100;
+    auto ptr = simd_find<Level>(memory, end, stop{});
+    CHECK(ptr <= end);
+    CHECK(ptr + simd_block_size > end);
+
+    memory[42] = '"';
+    CHECK(simd_find<Level>(memory, end, stop{}) == memory + 42);
+}
+
+constexpr simd_nibble_table lower_table = [] {
+    simd_nibble_table result{};
+    for (auto hi = 0; hi != 8; ++hi)
+        result.hi[hi] = static_cast<unsigned char>(1 << hi);
+    for (auto c = 'a'; c <= 'z'; ++c)
+        result.lo[c & 0xF] |= static_cast<unsigned char>(1 << (c >> 4));
+    return result;
+}();
+
+template <simd_level Level>
+void test_simd_skip_set()
+{
+    // The memory is padded by a full block after the terminator.
+    char memory[128 + simd_block_size];
+    for (auto i = 0u; i != sizeof(memory); ++i)
+        memory[i] = char('a' + i % 26);
+    memory[128] = char(0xFF);
+
+    CHECK(simd_skip_set<Level>(memory, unbounded, lower_table) == memory + 128);
+    for (auto pos = 0u; pos != 128; ++pos)
+    {
+        for (auto c : {'A', '`', '{', '0', ' ', char(0xE1)})
+        {
+            auto old    = memory[pos];
+            memory[pos] = c;
+            CHECK(simd_skip_set<Level>(memory, unbounded, lower_table) == memory + pos);
+            memory[pos] = old;
+        }
+    }
+
+    // With an end, it stops before reading past it.
+    auto end = memory + 100;
+    auto ptr = simd_skip_set<Level>(memory, end, lower_table);
+    CHECK(ptr <= end);
+    CHECK(ptr + simd_block_size > end);
+
+    memory[42] = '0';
+    CHECK(simd_skip_set<Level>(memory, end, lower_table) == memory + 42);
+}
+} // namespace
+
+TEST_CASE("simd_find")
+{
+    SUBCASE("none")
+    {
+        test_simd_find<simd_level::none>();
+    }
+#if LEXY_ENABLE_SIMD
+    SUBCASE("sse2")
+    {
+        test_simd_find<simd_level::sse2>();
+    }
+    if (get_simd_level() == simd_level::avx2)
+    {
+        SUBCASE("avx2")
+        {
+            test_simd_find<simd_level::avx2>();
+        }
+    }
+#endif
+}
+
+TEST_CASE("simd_skip_set")
+{
+    SUBCASE("none")
+    {
+        test_simd_skip_set<simd_level::none>();
+    }
+#if LEXY_ENABLE_SIMD
+    if (get_simd_level() >= simd_level::ssse3)
+    {
+        SUBCASE("ssse3")
+        {
+            test_simd_skip_set<simd_level::ssse3>();
+        }
+    }
+    if (get_simd_level() == simd_level::avx2)
+    {
+        SUBCASE("avx2")
+        {
+            test_simd_skip_set<simd_level::avx2>();
+        }
+    }
+#endif
+}
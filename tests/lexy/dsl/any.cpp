@@ -32,6 +32,13 @@ TEST_CASE("dsl::any")
     CHECK(swar_long.status == test_result::success);
     CHECK(swar_long.trace == test_trace().token("any", "123456789012345678901234567890"));
 
+    auto simd_long = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                                 "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    CHECK(simd_long.status == test_result::success);
+    CHECK(simd_long.trace
+          == test_trace().token("any",
+                                "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+
     auto swar_unicode
         = LEXY_VERIFY(lexy::utf8_char_encoding{}, "123456789\u00E401234567890\u00E51234567890");
     CHECK(swar_unicode.status == test_result::success);
@@ -0,0 +1,176 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/dsl/blob.hpp>
+
+#include "verify.hpp"
+#include <lexy/callback/string.hpp>
+#include <string>
+
+namespace
+{
+// Hashes the decoded bytes, so the result fits into the int value of the tests.
+constexpr int hash(const unsigned char* begin, const unsigned char* end, int seed = 0)
+{
+    auto result = unsigned(seed);
+    for (auto cur = begin; cur != end; ++cur)
+        result = (result * 31u + *cur) % 1000000007u;
+    return int(result);
+}
+int hash(const std::string& str)
+{
+    auto ptr = reinterpret_cast<const unsigned char*>(str.data());
+    return hash(ptr, ptr + str.size());
+}
+
+struct blob_sink
+{
+    int result;
+
+    using return_type = int;
+
+    void operator()(const unsigned char* begin, const unsigned char* end)
+    {
+        // Chunk boundaries must not influence the result.
+        result = hash(begin, end, result);
+    }
+
+    int finish() &&
+    {
+        return result;
+    }
+};
+
+template <typename Callback>
+struct blob_callback : Callback
+{
+    constexpr blob_callback(Callback cb) : Callback(cb) {}
+
+    auto sink() const
+    {
+        return blob_sink{0};
+    }
+};
+
+std::string repeat(const std::string& str, std::size_t count)
+{
+    std::string result;
+    for (auto i = 0u; i != count; ++i)
+        result += str;
+    return result;
+}
+} // namespace
+
+TEST_CASE("dsl::hex_blob")
+{
+    constexpr auto rule = dsl::hex_blob;
+    CHECK(lexy::is_rule<decltype(rule)>);
+
+    constexpr blob_callback callback
+        = lexy::callback<int>([](const char*, int result) { return result; });
+
+    auto empty = LEXY_VERIFY("");
+    CHECK(empty.status == test_result::success);
+    CHECK(empty.value == 0);
+    CHECK(empty.trace == test_trace().token("digits", ""));
+
+    auto one = LEXY_VERIFY("4a");
+    CHECK(one.status == test_result::success);
+    CHECK(one.value == hash("\x4a"));
+    CHECK(one.trace == test_trace().token("digits", "4a"));
+    auto mixed = LEXY_VERIFY("DeadBeef!");
+    CHECK(mixed.status == test_result::success);
+    CHECK(mixed.value == hash("\xde\xad\xbe\xef"));
+    CHECK(mixed.trace == test_trace().token("digits", "DeadBeef"));
+
+    auto odd = LEXY_VERIFY("abc");
+    CHECK(odd.status == test_result::fatal_error);
+    CHECK(odd.trace
+          == test_trace().error_token("abc").expected_char_class(3, "digit.hex").cancel());
+    auto invalid = LEXY_VERIFY("0g");
+    CHECK(invalid.status == test_result::fatal_error);
+    CHECK(invalid.trace
+          == test_trace().error_token("0").expected_char_class(1, "digit.hex").cancel());
+
+    SUBCASE("long")
+    {
+        // Long enough for multiple SIMD blocks and buffer flushes.
+        auto input    = repeat("0123456789abcdefFEDCBA9876543210", 40) + "ff";
+        auto expected = repeat("\x01\x23\x45\x67\x89\xab\xcd\xef\xfe\xdc\xba\x98\x76\x54\x32\x10",
+                               40)
+                        + "\xff";
+
+        auto result = LEXY_VERIFY_RUNTIME(input.c_str(), input.size());
+        CHECK(result.status == test_result::success);
+        CHECK(result.value == hash(expected));
+
+        // An invalid digit in the middle of a block.
+        input[500] = 'x';
+        auto prefix = LEXY_VERIFY_RUNTIME(input.c_str(), input.size());
+        CHECK(prefix.status == test_result::success);
+        CHECK(prefix.value == hash(expected.substr(0, 250)));
+
+        // An odd digit count in the middle of a block.
+        input[500] = '0';
+        input[501] = 'x';
+        auto odd_prefix = LEXY_VERIFY_RUNTIME(input.c_str(), input.size());
+        CHECK(odd_prefix.status == test_result::fatal_error);
+    }
+}
+
+TEST_CASE("dsl::base64")
+{
+    constexpr auto rule = dsl::base64;
+    CHECK(lexy::is_rule<decltype(rule)>);
+
+    constexpr blob_callback callback
+        = lexy::callback<int>([](const char*, int result) { return result; });
+
+    auto empty = LEXY_VERIFY("");
+    CHECK(empty.status == test_result::success);
+    CHECK(empty.value == 0);
+    CHECK(empty.trace == test_trace().token("any", ""));
+
+    auto full = LEXY_VERIFY("bGV4eQ+/");
+    CHECK(full.status == test_result::success);
+    CHECK(full.value == hash("lexy\x0f\xbf"));
+    CHECK(full.trace == test_trace().token("any", "bGV4eQ+/"));
+    auto pad1 = LEXY_VERIFY("bGV4eS4=");
+    CHECK(pad1.status == test_result::success);
+    CHECK(pad1.value == hash("lexy."));
+    CHECK(pad1.trace == test_trace().token("any", "bGV4eS4="));
+    auto pad2 = LEXY_VERIFY("bGV4eQ==");
+    CHECK(pad2.status == test_result::success);
+    CHECK(pad2.value == hash("lexy"));
+    CHECK(pad2.trace == test_trace().token("any", "bGV4eQ=="));
+
+    auto missing_pad = LEXY_VERIFY("bGV4eQ=");
+    CHECK(missing_pad.status == test_result::fatal_error);
+    CHECK(missing_pad.trace
+          == test_trace().error_token("bGV4eQ=").expected_char_class(7, "base64").cancel());
+    auto single = LEXY_VERIFY("bGV4e");
+    CHECK(single.status == test_result::fatal_error);
+    CHECK(single.trace
+          == test_trace().error_token("bGV4e").expected_char_class(5, "base64").cancel());
+
+    SUBCASE("long")
+    {
+        // Long enough for multiple SIMD blocks and buffer flushes.
+        auto input    = repeat("TWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdv", 40) + "cms=";
+        auto expected = repeat("Many hands make light wo", 40) + "rk";
+
+        auto result = LEXY_VERIFY_RUNTIME(input.c_str(), input.size());
+        CHECK(result.status == test_result::success);
+        CHECK(result.value == hash(expected));
+
+        // An invalid character in the middle of a block ends the blob after the last full group.
+        input[502] = '.';
+        auto prefix = LEXY_VERIFY_RUNTIME(input.c_str(), input.size());
+        CHECK(prefix.status == test_result::fatal_error);
+
+        input[500] = '.';
+        auto group_prefix = LEXY_VERIFY_RUNTIME(input.c_str(), input.size());
+        CHECK(group_prefix.status == test_result::success);
+        CHECK(group_prefix.value == hash(expected.substr(0, 375)));
+    }
+}
@@ -4,6 +4,8 @@
 #include <lexy/dsl/choice.hpp>
 
 #include "verify.hpp"
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/case_folding.hpp>
 #include <lexy/dsl/error.hpp>
 #include <lexy/dsl/if.hpp>
 #include <lexy/dsl/production.hpp>
@@ -156,6 +158,79 @@ TEST_CASE("dsl::operator|")
                      .recovery());
     }
 
+    SUBCASE("dispatch on first code unit")
+    {
+        constexpr auto rule = LEXY_LIT("a") >> dsl::p<label<0>>                              //
+                              | LEXY_LIT("abc") >> dsl::p<label<1>>                          //
+                              | dsl::ascii::digit >> dsl::p<label<2>>                        //
+                              | dsl::ascii::case_folding(LEXY_LIT("def")) >> dsl::p<label<3>> //
+                              | LEXY_LIT("bc") >> dsl::p<label<4>>;
+        CHECK(lexy::is_branch_rule<decltype(rule)>);
+        CHECK(decltype(rule)::_dispatch<lexy::utf8_encoding>);
+        CHECK(!decltype(rule)::_dispatch<lexy::utf16_encoding>);
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::fatal_error);
+        CHECK(empty.trace == test_trace().error(0, 0, "exhausted choice").cancel());
+
+        auto abc = LEXY_VERIFY("abc!");
+        CHECK(abc.status == test_result::recovered_error);
+        CHECK(abc.value == 0);
+        CHECK(abc.trace
+              == test_trace()
+                     .literal("a")
+                     .production("label")
+                     .expected_literal(1, "!", 0)
+                     .recovery());
+
+        auto digit = LEXY_VERIFY("7!");
+        CHECK(digit.status == test_result::success);
+        CHECK(digit.value == 2);
+        CHECK(digit.trace == test_trace().token("7").production("label").literal("!"));
+
+        auto def = LEXY_VERIFY("DeF!");
+        CHECK(def.status == test_result::success);
+        CHECK(def.value == 3);
+        CHECK(def.trace == test_trace().literal("DeF").production("label").literal("!"));
+
+        auto bc = LEXY_VERIFY("bc!");
+        CHECK(bc.status == test_result::success);
+        CHECK(bc.value == 4);
+        CHECK(bc.trace == test_trace().literal("bc").production("label").literal("!"));
+
+        auto other = LEXY_VERIFY("x");
+        CHECK(other.status == test_result::fatal_error);
+        CHECK(other.trace == test_trace().error(0, 0, "exhausted choice").cancel());
+    }
+    SUBCASE("dispatch on first code unit as branch")
+    {
+        constexpr auto rule = dsl::if_(LEXY_LIT("abc") >> dsl::p<label<0>>   //
+                                       | dsl::ascii::digit >> dsl::p<label<1>> //
+                                       | LEXY_LIT("bc") >> dsl::p<label<2>>    //
+                                       | LEXY_LIT("b") >> dsl::p<label<3>>);
+        CHECK(lexy::is_rule<decltype(rule)>);
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::success);
+        CHECK(empty.value == 42);
+        CHECK(empty.trace == test_trace());
+
+        auto other = LEXY_VERIFY("x");
+        CHECK(other.status == test_result::success);
+        CHECK(other.value == 42);
+        CHECK(other.trace == test_trace());
+
+        auto abc = LEXY_VERIFY("abc!");
+        CHECK(abc.status == test_result::success);
+        CHECK(abc.value == 0);
+        CHECK(abc.trace == test_trace().literal("abc").production("label").literal("!"));
+
+        auto b = LEXY_VERIFY("b!");
+        CHECK(b.status == test_result::success);
+        CHECK(b.value == 3);
+        CHECK(b.trace == test_trace().literal("b").production("label").literal("!"));
+    }
+
     SUBCASE("as branch")
     {
         constexpr auto rule
@@ -17,6 +17,21 @@ struct with_whitespace
 };
 } // namespace
 
+namespace
+{
+template <std::size_t N>
+struct counter_id
+{};
+
+template <std::size_t... Idx>
+constexpr auto many_counters(lexy::_detail::index_sequence<Idx...>)
+{
+    return (dsl::context_counter<counter_id<Idx>>.template create<int(Idx)>() + ...)
+           + (dsl::context_counter<counter_id<Idx>>.inc() + ...)
+           + (dsl::context_counter<counter_id<Idx>>.value() + ...);
+}
+} // namespace
+
 TEST_CASE("dsl::context_counter")
 {
     // Note: runtime checks only here due to https://gcc.gnu.org/bugzilla/show_bug.cgi?id=89074.
@@ -162,6 +177,37 @@ TEST_CASE("dsl::context_counter")
     {
         CHECK(equivalent_rules(counter.is_zero(), counter.is<0>()));
     }
+
+    SUBCASE("shadowing")
+    {
+        constexpr auto other = dsl::context_counter<struct other_id>;
+        constexpr auto rule  = counter.create<1>() + other.create<2>() + counter.create<3>()
+                              + counter.inc() + counter.value();
+
+        auto empty = LEXY_VERIFY_RUNTIME("");
+        CHECK(empty.status == test_result::success);
+        CHECK(empty.value == 4);
+        CHECK(empty.trace == test_trace());
+    }
+    SUBCASE("many counters")
+    {
+        // More counters than slots, so some of them have to share one.
+        constexpr auto rule = many_counters(lexy::_detail::make_index_sequence<12>{});
+
+        auto empty = [&] {
+            constexpr auto callback = lexy::callback<int>([](const char*, auto... values) {
+                auto result = 0;
+                auto weight = 1;
+                ((result += weight++ * values), ...);
+                return result;
+            });
+            return LEXY_VERIFY_RUNTIME("");
+        }();
+        CHECK(empty.status == test_result::success);
+        // sum of (i + 1) * (i + 1) for i = 0, ..., 11
+        CHECK(empty.value == 650);
+        CHECK(empty.trace == test_trace());
+    }
 }
 
 TEST_CASE("dsl::equal_counts()")
@@ -0,0 +1,178 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/dsl/datetime.hpp>
+
+#include "verify.hpp"
+#include <lexy/dsl/if.hpp>
+
+namespace
+{
+// Encodes the value as seconds since 2000-01-01T00:00:00Z, which fits into an int.
+constexpr auto callback
+    = lexy::callback<int>([](const char*) { return -11; },
+                          [](const char*, lexy::datetime value) {
+                              return int(value.unix_seconds() - 946684800) + value.nanosecond % 7;
+                          });
+} // namespace
+
+TEST_CASE("lexy::datetime")
+{
+    auto value = lexy::datetime{1970, 1, 1, 0, 0, 0, 0, false, 0};
+    CHECK(value.unix_seconds() == 0);
+
+    value = lexy::datetime{2024, 2, 29, 23, 59, 60, 0, true, 90};
+    CHECK(value.unix_seconds() == 1709245800);
+    value = lexy::datetime{1900, 3, 1, 12, 0, 0, 0, true, -60};
+    CHECK(value.unix_seconds() == -2203844400);
+    value = lexy::datetime{0, 1, 1, 0, 0, 0, 0, false, 0};
+    CHECK(value.unix_seconds() == -62167219200);
+}
+
+TEST_CASE("dsl::iso8601_datetime")
+{
+    constexpr auto datetime = dsl::iso8601_datetime;
+    CHECK(lexy::is_branch_rule<decltype(datetime)>);
+
+    SUBCASE("as rule")
+    {
+        constexpr auto rule = datetime;
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::fatal_error);
+        CHECK(empty.trace == test_trace().expected_char_class(0, "digit.decimal").cancel());
+
+        auto local = LEXY_VERIFY("2024-06-30T12:34:56");
+        CHECK(local.status == test_result::success);
+        CHECK(local.value == 773066096);
+        CHECK(local.trace == test_trace().token("digits", "2024-06-30T12:34:56"));
+        auto utc = LEXY_VERIFY("2024-06-30T12:34:56Z");
+        CHECK(utc.status == test_result::success);
+        CHECK(utc.value == 773066096);
+        CHECK(utc.trace == test_trace().token("digits", "2024-06-30T12:34:56Z"));
+        auto offset = LEXY_VERIFY("2024-06-30T14:04:56+01:30");
+        CHECK(offset.status == test_result::success);
+        CHECK(offset.value == 773066096);
+        CHECK(offset.trace == test_trace().token("digits", "2024-06-30T14:04:56+01:30"));
+        auto negative_offset = LEXY_VERIFY("2024-06-30T11:34:56-01:00");
+        CHECK(negative_offset.status == test_result::success);
+        CHECK(negative_offset.value == 773066096);
+
+        // 123456789 % 7 == 1, 500000000 % 7 == 3
+        auto fraction = LEXY_VERIFY("2000-01-01T00:00:00.123456789Z");
+        CHECK(fraction.status == test_result::success);
+        CHECK(fraction.value == 1);
+        CHECK(fraction.trace == test_trace().token("digits", "2000-01-01T00:00:00.123456789Z"));
+        auto long_fraction = LEXY_VERIFY("2000-01-01T00:00:00.1234567891234");
+        CHECK(long_fraction.status == test_result::success);
+        CHECK(long_fraction.value == 1);
+        auto comma = LEXY_VERIFY("2000-01-01T00:00:00,5");
+        CHECK(comma.status == test_result::success);
+        CHECK(comma.value == 3);
+
+        auto lower_t = LEXY_VERIFY("2000-01-01t00:00:00");
+        CHECK(lower_t.status == test_result::fatal_error);
+        CHECK(lower_t.trace
+              == test_trace()
+                     .error_token("2000-01-01")
+                     .expected_literal(10, "T", 0)
+                     .cancel());
+        auto bad_digit = LEXY_VERIFY("2000-01-01T00:0a:00");
+        CHECK(bad_digit.status == test_result::fatal_error);
+        CHECK(bad_digit.trace
+              == test_trace()
+                     .error_token("2000-01-01T00:0")
+                     .expected_char_class(15, "digit.decimal")
+                     .cancel());
+        auto missing_fraction = LEXY_VERIFY("2000-01-01T00:00:00.Z");
+        CHECK(missing_fraction.status == test_result::fatal_error);
+        CHECK(missing_fraction.trace
+              == test_trace()
+                     .error_token("2000-01-01T00:00:00.")
+                     .expected_char_class(20, "digit.decimal")
+                     .cancel());
+        auto partial_offset = LEXY_VERIFY("2000-01-01T00:00:00+0100");
+        CHECK(partial_offset.status == test_result::fatal_error);
+        CHECK(partial_offset.trace
+              == test_trace()
+                     .error_token("2000-01-01T00:00:00+01")
+                     .expected_literal(22, ":", 0)
+                     .cancel());
+
+        auto leap_second = LEXY_VERIFY("2016-12-31T23:59:60Z");
+        CHECK(leap_second.status == test_result::success);
+        CHECK(leap_second.value == 536544000);
+        auto leap_day = LEXY_VERIFY("2000-02-29T00:00:00Z");
+        CHECK(leap_day.status == test_result::success);
+        CHECK(leap_day.value == 5097600);
+
+        auto no_leap_day = LEXY_VERIFY("1900-02-29T00:00:00Z");
+        CHECK(no_leap_day.status == test_result::recovered_error);
+        CHECK(no_leap_day.trace
+              == test_trace()
+                     .token("digits", "1900-02-29T00:00:00Z")
+                     .error(0, 20, "invalid date or time"));
+        auto bad_month = LEXY_VERIFY("2000-13-01T00:00:00");
+        CHECK(bad_month.status == test_result::recovered_error);
+        CHECK(bad_month.trace
+              == test_trace()
+                     .token("digits", "2000-13-01T00:00:00")
+                     .error(0, 19, "invalid date or time"));
+        auto bad_hour = LEXY_VERIFY("2000-01-01T24:00:00");
+        CHECK(bad_hour.status == test_result::recovered_error);
+        auto bad_offset = LEXY_VERIFY("2000-01-01T00:00:00+01:60");
+        CHECK(bad_offset.status == test_result::recovered_error);
+    }
+    SUBCASE("as branch")
+    {
+        constexpr auto rule = dsl::if_(datetime);
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::success);
+        CHECK(empty.value == -11);
+        CHECK(empty.trace == test_trace());
+
+        auto utc = LEXY_VERIFY("2024-06-30T12:34:56Z");
+        CHECK(utc.status == test_result::success);
+        CHECK(utc.value == 773066096);
+        CHECK(utc.trace == test_trace().token("digits", "2024-06-30T12:34:56Z"));
+
+        auto partial = LEXY_VERIFY("2024-06-30");
+        CHECK(partial.status == test_result::success);
+        CHECK(partial.value == -11);
+        CHECK(partial.trace == test_trace());
+
+        auto bad_month = LEXY_VERIFY("2000-13-01T00:00:00");
+        CHECK(bad_month.status == test_result::recovered_error);
+    }
+}
+
+TEST_CASE("dsl::rfc3339_datetime")
+{
+    constexpr auto rule = dsl::rfc3339_datetime;
+    CHECK(lexy::is_branch_rule<decltype(rule)>);
+
+    auto utc = LEXY_VERIFY("2024-06-30T12:34:56Z");
+    CHECK(utc.status == test_result::success);
+    CHECK(utc.value == 773066096);
+    CHECK(utc.trace == test_trace().token("digits", "2024-06-30T12:34:56Z"));
+    auto lower = LEXY_VERIFY("2024-06-30t12:34:56.5z");
+    CHECK(lower.status == test_result::success);
+    CHECK(lower.value == 773066096 + 3);
+    CHECK(lower.trace == test_trace().token("digits", "2024-06-30t12:34:56.5z"));
+
+    auto local = LEXY_VERIFY("2024-06-30T12:34:56");
+    CHECK(local.status == test_result::fatal_error);
+    CHECK(local.trace
+          == test_trace()
+                 .error_token("2024-06-30T12:34:56")
+                 .expected_literal(19, "Z", 0)
+                 .cancel());
+    auto comma = LEXY_VERIFY("2024-06-30T12:34:56,5Z");
+    CHECK(comma.status == test_result::fatal_error);
+    CHECK(comma.trace
+          == test_trace()
+                 .error_token("2024-06-30T12:34:56")
+                 .expected_literal(19, "Z", 0)
+                 .cancel());
+}
@@ -624,6 +624,19 @@ TEST_CASE("dsl::delimited(open, close) - SWAR")
     CHECK(many.value == 26);
     CHECK(many.trace == test_trace().literal("(").token("abcdefghijklmnopqrstuvwxyz").literal(")"));
 
+    auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                            "(abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ$)abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ)");
+    CHECK(simd.status == test_result::success);
+    CHECK(simd.value == 208);
+    CHECK(simd.trace
+          == test_trace()
+                 .literal("(")
+                 .token("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ")
+                 .literal("$")
+                 .literal(")")
+                 .token("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ")
+                 .literal(")"));
+
     auto esc = LEXY_VERIFY(lexy::utf8_char_encoding{}, "(abcdefghijklmnopqr$)stuvwxyz)");
     CHECK(esc.status == test_result::success);
     CHECK(esc.value == 26);
@@ -637,6 +650,60 @@ TEST_CASE("dsl::delimited(open, close) - SWAR")
                  .literal(")"));
 }
 
+TEST_CASE("dsl::delimited(open, close) - custom char class")
+{
+    constexpr auto cc
+        = LEXY_CHAR_CLASS("my class", dsl::ascii::alpha / dsl::lit_c<'-'> / dsl::lit_c<'$'>);
+    constexpr auto rule = dsl::delimited(dsl::lit_c<'('>,
+                                         dsl::lit_c<')'>) //
+        (cc, dsl::dollar_escape.rule(dsl::lit_c<')'>));
+
+    constexpr delim_callback callback
+        = lexy::callback<int>([](const char*, std::size_t count) { return int(count); });
+
+    auto many = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                            "(abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ-"
+                            "abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ)");
+    CHECK(many.status == test_result::success);
+    CHECK(many.value == 111);
+    CHECK(many.trace
+          == test_trace()
+                 .literal("(")
+                 .token("abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ-"
+                        "abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ")
+                 .literal(")"));
+
+    auto esc = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                           "(abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ$)"
+                           "abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ)");
+    CHECK(esc.status == test_result::success);
+    CHECK(esc.value == 110);
+    CHECK(esc.trace
+          == test_trace()
+                 .literal("(")
+                 .token("abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ")
+                 .literal("$")
+                 .literal(")")
+                 .token("abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ")
+                 .literal(")"));
+
+    auto invalid = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                               "(abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ!"
+                               "abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ)");
+    CHECK(invalid.status == test_result::recovered_error);
+    CHECK(invalid.value == 110);
+    CHECK(invalid.trace
+          == test_trace()
+                 .literal("(")
+                 .token("abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ")
+                 .expected_char_class(56, "my class")
+                 .recovery()
+                 .error_token("!")
+                 .finish()
+                 .token("abcdefghijklm-nopqrstuvwxyz-ABCDEFGHIJKLM-NOPQRSTUVWXYZ")
+                 .literal(")"));
+}
+
 TEST_CASE("dsl::delimited(delim)")
 {
     CHECK(equivalent_rules(dsl::delimited(dsl::lit_c<'"'>),
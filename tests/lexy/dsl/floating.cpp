@@ -0,0 +1,163 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/dsl/floating.hpp>
+
+#include "verify.hpp"
+#include <lexy/callback/integer.hpp>
+#include <lexy/dsl/if.hpp>
+#include <lexy/dsl/sign.hpp>
+
+TEST_CASE("dsl::floating")
+{
+    constexpr auto floating = dsl::floating<double>;
+    CHECK(lexy::is_branch_rule<decltype(floating)>);
+
+    // The value in thousandths; values that don't fit are -1.
+    constexpr auto callback = lexy::callback<int>([](const char*) { return -11; },
+                                                  [](const char*, double value) {
+                                                      return value < 1e6 ? int(value * 1000) : -1;
+                                                  });
+
+    SUBCASE("as rule")
+    {
+        constexpr auto rule = floating;
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::fatal_error);
+        CHECK(empty.trace == test_trace().expected_char_class(0, "digit.decimal").cancel());
+        auto dot = LEXY_VERIFY(".5");
+        CHECK(dot.status == test_result::fatal_error);
+        CHECK(dot.trace == test_trace().expected_char_class(0, "digit.decimal").cancel());
+
+        auto integer = LEXY_VERIFY("42");
+        CHECK(integer.status == test_result::success);
+        CHECK(integer.value == 42000);
+        CHECK(integer.trace == test_trace().token("digits", "42"));
+        auto fraction = LEXY_VERIFY("3.25");
+        CHECK(fraction.status == test_result::success);
+        CHECK(fraction.value == 3250);
+        CHECK(fraction.trace == test_trace().token("digits", "3.25"));
+        auto exponent = LEXY_VERIFY("1e3");
+        CHECK(exponent.status == test_result::success);
+        CHECK(exponent.value == 1000000);
+        CHECK(exponent.trace == test_trace().token("digits", "1e3"));
+        auto full = LEXY_VERIFY("6.25E+2");
+        CHECK(full.status == test_result::success);
+        CHECK(full.value == 625000);
+        CHECK(full.trace == test_trace().token("digits", "6.25E+2"));
+        auto negative_exponent = LEXY_VERIFY("125e-5");
+        CHECK(negative_exponent.status == test_result::success);
+        CHECK(negative_exponent.value == 1);
+        CHECK(negative_exponent.trace == test_trace().token("digits", "125e-5"));
+        auto long_ = LEXY_VERIFY("3.14159265358979323846264338327950288");
+        CHECK(long_.status == test_result::success);
+        CHECK(long_.value == 3141);
+
+        auto missing_fraction = LEXY_VERIFY("1.");
+        CHECK(missing_fraction.status == test_result::recovered_error);
+        CHECK(missing_fraction.value == 1000);
+        CHECK(missing_fraction.trace
+              == test_trace()
+                     .expected_char_class(2, "digit.decimal")
+                     .recovery()
+                     .token("digits", "1.")
+                     .finish());
+        auto missing_exponent = LEXY_VERIFY("2e+");
+        CHECK(missing_exponent.status == test_result::recovered_error);
+        CHECK(missing_exponent.value == 2000);
+        CHECK(missing_exponent.trace
+              == test_trace()
+                     .expected_char_class(3, "digit.decimal")
+                     .recovery()
+                     .token("digits", "2e+")
+                     .finish());
+
+        auto overflow = LEXY_VERIFY("1e400");
+        CHECK(overflow.status == test_result::recovered_error);
+        CHECK(overflow.value == -1);
+        CHECK(overflow.trace
+              == test_trace().token("digits", "1e400").error(0, 5, "floating-point overflow"));
+        auto underflow = LEXY_VERIFY("1e-400");
+        CHECK(underflow.status == test_result::success);
+        CHECK(underflow.value == 0);
+        CHECK(underflow.trace == test_trace().token("digits", "1e-400"));
+    }
+    SUBCASE("as branch")
+    {
+        constexpr auto rule = dsl::if_(floating);
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::success);
+        CHECK(empty.value == -11);
+        CHECK(empty.trace == test_trace());
+
+        auto full = LEXY_VERIFY("6.25E+2");
+        CHECK(full.status == test_result::success);
+        CHECK(full.value == 625000);
+        CHECK(full.trace == test_trace().token("digits", "6.25E+2"));
+
+        auto missing_fraction = LEXY_VERIFY("1.");
+        CHECK(missing_fraction.status == test_result::success);
+        CHECK(missing_fraction.value == -11);
+        CHECK(missing_fraction.trace == test_trace());
+
+        auto overflow = LEXY_VERIFY("1e400");
+        CHECK(overflow.status == test_result::recovered_error);
+        CHECK(overflow.value == -1);
+        CHECK(overflow.trace
+              == test_trace().token("digits", "1e400").error(0, 5, "floating-point overflow"));
+    }
+    SUBCASE("float")
+    {
+        constexpr auto rule = dsl::floating<float>;
+        constexpr auto callback = lexy::callback<int>([](const char*, float value) {
+            return value < 1e6f ? int(value * 1000) : -1;
+        });
+
+        auto fraction = LEXY_VERIFY("0.1");
+        CHECK(fraction.status == test_result::success);
+        CHECK(fraction.value == 100);
+        CHECK(fraction.trace == test_trace().token("digits", "0.1"));
+
+        auto overflow = LEXY_VERIFY("1e39");
+        CHECK(overflow.status == test_result::recovered_error);
+        CHECK(overflow.value == -1);
+        CHECK(overflow.trace
+              == test_trace().token("digits", "1e39").error(0, 4, "floating-point overflow"));
+    }
+    SUBCASE("with sign")
+    {
+        constexpr auto rule = dsl::minus_sign + floating;
+        constexpr auto callback = lexy::callback<int>([](const char*, auto... args) {
+            return int(lexy::as_floating<double>(args...) * 1000);
+        });
+
+        auto positive = LEXY_VERIFY("2.5");
+        CHECK(positive.status == test_result::success);
+        CHECK(positive.value == 2500);
+        auto negative = LEXY_VERIFY("-2.5");
+        CHECK(negative.status == test_result::success);
+        CHECK(negative.value == -2500);
+    }
+}
+
+TEST_CASE("dsl::floating.no_leading_zero()")
+{
+    constexpr auto rule = dsl::floating<double>.no_leading_zero();
+    CHECK(lexy::is_branch_rule<decltype(rule)>);
+
+    constexpr auto callback
+        = lexy::callback<int>([](const char*, double value) { return int(value * 1000); });
+
+    auto zero = LEXY_VERIFY("0.5");
+    CHECK(zero.status == test_result::success);
+    CHECK(zero.value == 500);
+    CHECK(zero.trace == test_trace().token("digits", "0.5"));
+
+    auto leading_zero = LEXY_VERIFY("00.5");
+    CHECK(leading_zero.status == test_result::recovered_error);
+    CHECK(leading_zero.value == 0);
+    CHECK(leading_zero.trace
+          == test_trace().error(0, 1, "forbidden leading zero").recovery().token("digits", "00"));
+}
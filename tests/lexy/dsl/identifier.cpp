@@ -48,6 +48,37 @@ TEST_CASE("dsl::identifier(leading, trailing).pattern()")
     auto swar = LEXY_VERIFY(lexy::utf8_char_encoding{}, "Abcdefghijklmnopqrstuvwxyz");
     CHECK(swar.status == test_result::success);
     CHECK(swar.trace == test_trace().token("identifier", "Abcdefghijklmnopqrstuvwxyz"));
+
+    auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                            "Abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz-abc");
+    CHECK(simd.status == test_result::success);
+    CHECK(simd.trace
+          == test_trace().token("identifier",
+                                "Abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"));
+}
+
+TEST_CASE("dsl::identifier(leading, custom trailing)")
+{
+    constexpr auto rule = dsl::identifier(dsl::ascii::alpha,
+                                          LEXY_CHAR_CLASS("trailing", dsl::ascii::alnum
+                                                                          / dsl::lit_c<'-'>))
+                              .pattern();
+    CHECK(lexy::is_token_rule<decltype(rule)>);
+
+    constexpr auto callback = token_callback;
+
+    auto short_ = LEXY_VERIFY(lexy::utf8_char_encoding{}, "a-b-c!");
+    CHECK(short_.status == test_result::success);
+    CHECK(short_.trace == test_trace().token("identifier", "a-b-c"));
+
+    auto long_ = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                             "abcdefghijklm-nopqrstuvwxyz-0123456789-ABCDEFGHIJKLM-NOPQRSTUVWXYZ-"
+                             "0123456789!abc");
+    CHECK(long_.status == test_result::success);
+    CHECK(long_.trace
+          == test_trace().token("identifier",
+                                "abcdefghijklm-nopqrstuvwxyz-0123456789-ABCDEFGHIJKLM-"
+                                "NOPQRSTUVWXYZ-0123456789"));
 }
 
 TEST_CASE("dsl::identifier(leading, trailing)")
@@ -269,6 +269,61 @@ TEST_CASE("_integer_parser")
         CHECK(parse_int(parser, "0'0'F'F") == 255);
         CHECK(parse_int(parser, "0'0'F'F") == 255);
     }
+
+    // Numbers with at least eight digits are parsed eight digits at a time.
+    SUBCASE("base 10, uint64_t")
+    {
+        auto check = [](auto parser) {
+            for (auto value : {12345678ull, 123456789ull, 1234567890123456ull,
+                               10000000000000000000ull, 18446744073709551615ull})
+            {
+                INFO(value);
+                auto result = parse_int(parser, std::to_string(value).c_str());
+                CHECK(!result.overflow);
+                CHECK(result.value == value);
+            }
+
+            auto zeroes = parse_int(parser, "00000000000000000018446744073709551615");
+            CHECK(!zeroes.overflow);
+            CHECK(zeroes.value == 18446744073709551615ull);
+
+            auto overflow = parse_int(parser, "18446744073709551616");
+            CHECK(overflow.overflow);
+            CHECK(overflow.value == 18446744073709551610ull);
+
+            CHECK(parse_int(parser, "123456789012345678901").overflow);
+        };
+        check(dsl::_integer_parser<std::uint64_t, dsl::decimal, true>{});
+        check(dsl::_integer_parser<std::uint64_t, dsl::decimal, false>{});
+
+        constexpr auto parser = dsl::_integer_parser<std::uint64_t, dsl::decimal, false>{};
+        auto           sep    = parse_int(parser, "1'234'567'890'123'456");
+        CHECK(!sep.overflow);
+        CHECK(sep.value == 1234567890123456ull);
+    }
+    SUBCASE("base 10, unbounded uint32_t")
+    {
+        constexpr auto parser
+            = dsl::_integer_parser<lexy::unbounded<std::uint32_t>, dsl::decimal, true>{};
+
+        auto result = parse_int(parser, "123456789012345678");
+        CHECK(result.value == std::uint32_t(123456789012345678ull));
+    }
+    SUBCASE("base 16, uint64_t")
+    {
+        constexpr auto parser = dsl::_integer_parser<std::uint64_t, dsl::hex, true>{};
+
+        auto lower = parse_int(parser, "0123456789abcdef");
+        CHECK(!lower.overflow);
+        CHECK(lower.value == 0x0123456789ABCDEFull);
+
+        auto upper = parse_int(parser, "FEDCBA9876543210");
+        CHECK(!upper.overflow);
+        CHECK(upper.value == 0xFEDCBA9876543210ull);
+
+        auto overflow = parse_int(parser, "10000000000000000");
+        CHECK(overflow.overflow);
+    }
 }
 
 TEST_CASE("dsl::integer(token)")
@@ -4,12 +4,20 @@
 #include <lexy/dsl/production.hpp>
 
 #include "verify.hpp"
+#include <lexy/action/validate.hpp>
 #include <lexy/dsl/capture.hpp>
+#include <lexy/dsl/choice.hpp>
+#include <lexy/dsl/context_counter.hpp>
 #include <lexy/dsl/if.hpp>
+#include <lexy/dsl/peek.hpp>
 #include <lexy/dsl/position.hpp>
 #include <lexy/dsl/recover.hpp>
 #include <lexy/dsl/whitespace.hpp>
 
+#if LEXY_HAS_STACK_SEGMENTS
+#    include <pthread.h>
+#endif
+
 namespace
 {
 struct with_whitespace
@@ -545,3 +553,225 @@ TEST_CASE("dsl::recurse_branch")
     // No need to test other cases, code is shared with `dsl::p`.
 }
 
+
+namespace
+{
+int memo_parse_count = 0;
+
+// Counts how often a production is actually parsed.
+struct memo_count : lexy::dsl::rule_base
+{
+    template <typename NextParser>
+    struct p
+    {
+        template <typename Context, typename Reader, typename... Args>
+        static bool parse(Context& context, Reader& reader, Args&&... args)
+        {
+            ++memo_parse_count;
+            return NextParser::parse(context, reader, LEXY_FWD(args)...);
+        }
+    };
+};
+
+struct not_memoized
+{};
+
+// Each level looks ahead at the next level before parsing it again,
+// which requires exponential time without memoization.
+template <int N, bool Memoize>
+struct memo_level
+: std::conditional_t<Memoize, lexy::memoized_production, not_memoized>
+{
+    static constexpr auto name = "memo_level";
+    static constexpr auto rule = [] {
+        using next = memo_level<N - 1, Memoize>;
+        auto plus  = dsl::lit_c<'+'>;
+        return memo_count{}
+               + (dsl::peek(dsl::p<next> + plus) >> dsl::p<next> + plus
+                  | dsl::else_ >> dsl::p<next>);
+    }();
+};
+template <bool Memoize>
+struct memo_level<0, Memoize>
+: std::conditional_t<Memoize, lexy::memoized_production, not_memoized>
+{
+    static constexpr auto name = "memo_level";
+    static constexpr auto rule = memo_count{} + LEXY_LIT("a");
+};
+
+template <bool Memoize>
+bool memo_match(const char* str)
+{
+    memo_parse_count = 0;
+    return lexy::match<memo_level<5, Memoize>>(lexy::zstring_input(str));
+}
+template <bool Memoize>
+bool memo_validate(const char* str)
+{
+    memo_parse_count = 0;
+    return lexy::validate<memo_level<5, Memoize>>(lexy::zstring_input(str), lexy::noop)
+        .is_success();
+}
+
+struct memo_ws_ab : lexy::memoized_production
+{
+    static constexpr auto name       = "memo_ws_ab";
+    static constexpr auto whitespace = dsl::lit_c<'.'>;
+    static constexpr auto rule       = dsl::lit_c<'a'> + dsl::lit_c<'b'>;
+};
+
+// The lookahead matches with whitespace, which must not be used without it.
+struct memo_no_whitespace : lexy::memoized_production
+{
+    static constexpr auto name       = "memo_no_whitespace";
+    static constexpr auto whitespace = dsl::lit_c<'.'>;
+    static constexpr auto rule
+        = dsl::peek(dsl::p<memo_ws_ab>) >> dsl::no_whitespace(dsl::p<memo_ws_ab>);
+};
+
+constexpr auto memo_counter = dsl::context_counter<struct memo_counter_id>;
+
+struct memo_reads_counter : lexy::memoized_production
+{
+    static constexpr auto name = "memo_reads_counter";
+    static constexpr auto rule
+        = memo_counter.is_zero() >> dsl::lit_c<'a'> | dsl::else_ >> dsl::lit_c<'b'>;
+};
+
+template <int Value>
+struct memo_with_counter
+{
+    static constexpr auto name = "memo_with_counter";
+    static constexpr auto rule = memo_counter.create<Value>() + dsl::p<memo_reads_counter>;
+};
+
+// The lookahead parses the production with a different value of the counter.
+struct memo_counter_root : lexy::memoized_production
+{
+    static constexpr auto name = "memo_counter_root";
+    static constexpr auto rule = dsl::peek(dsl::p<memo_with_counter<0>>) >> dsl::lit_c<'a'>
+                                 | dsl::else_ >> dsl::p<memo_with_counter<1>>;
+};
+} // namespace
+
+TEST_CASE("lexy::memoized_production")
+{
+    CHECK(lexy::is_memoized_production<memo_level<0, true>>);
+    CHECK(!lexy::is_memoized_production<memo_level<0, false>>);
+
+    SUBCASE("match")
+    {
+        CHECK(memo_match<false>("a"));
+        CHECK(memo_parse_count == 63);
+        // Every level is only parsed once.
+        CHECK(memo_match<true>("a"));
+        CHECK(memo_parse_count == 6);
+
+        CHECK(!memo_match<false>("b"));
+        CHECK(memo_parse_count == 63);
+        CHECK(!memo_match<true>("b"));
+        CHECK(memo_parse_count == 6);
+
+        for (auto str : {"a+", "a++", "a+++++", "a+b"})
+            CHECK(memo_match<true>(str) == memo_match<false>(str));
+    }
+    SUBCASE("validate")
+    {
+        // The productions have to be parsed again to produce values,
+        // but all the lookahead inside them is memoized.
+        CHECK(memo_validate<false>("a"));
+        CHECK(memo_parse_count == 63);
+        CHECK(memo_validate<true>("a"));
+        CHECK(memo_parse_count == 11);
+
+        for (auto str : {"b", "a+", "a++", "a+++++", "a+b"})
+            CHECK(memo_validate<true>(str) == memo_validate<false>(str));
+    }
+    SUBCASE("no_whitespace")
+    {
+        CHECK(lexy::match<memo_no_whitespace>(lexy::zstring_input("ab")));
+        CHECK(!lexy::match<memo_no_whitespace>(lexy::zstring_input("a.b")));
+    }
+    SUBCASE("context counter")
+    {
+        CHECK(lexy::match<memo_counter_root>(lexy::zstring_input("a")));
+        CHECK(lexy::match<memo_counter_root>(lexy::zstring_input("b")));
+    }
+}
+
+#if LEXY_HAS_STACK_SEGMENTS
+namespace
+{
+struct nested_parens
+{
+    static constexpr auto max_recursion_depth = 1'000'000;
+    static constexpr auto stack_segment_size  = 64 * 1024;
+
+    static constexpr auto rule
+        = dsl::if_(dsl::lit_c<'('> >> dsl::recurse<nested_parens> + dsl::lit_c<')'>);
+};
+
+std::string nested_parens_input(std::size_t depth)
+{
+    return std::string(depth, '(') + std::string(depth, ')');
+}
+
+// The segments are bigger than the stack of the thread that parses.
+struct big_nested_parens
+{
+    static constexpr auto max_recursion_depth = 1'000'000;
+    static constexpr auto stack_segment_size  = 1024 * 1024;
+
+    static constexpr auto rule
+        = dsl::if_(dsl::lit_c<'('> >> dsl::recurse<big_nested_parens> + dsl::lit_c<')'>);
+};
+
+struct small_stack_parse
+{
+    std::string input;
+    bool        result;
+
+    static void* run(void* arg)
+    {
+        auto self    = static_cast<small_stack_parse*>(arg);
+        self->result = lexy::match<big_nested_parens>(lexy::string_input(self->input));
+        return nullptr;
+    }
+};
+} // namespace
+
+TEST_CASE("lexy::stack_segment_size")
+{
+    CHECK(lexy::stack_segment_size<nested_parens>() == 64 * 1024);
+    CHECK(lexy::stack_segment_size<with_max_depth<4>>() == 0);
+
+    // Nested far deeper than the stack of the thread allows.
+    auto deep = nested_parens_input(100'000);
+    CHECK(lexy::match<nested_parens>(lexy::string_input(deep)));
+
+    deep.pop_back();
+    CHECK(!lexy::match<nested_parens>(lexy::string_input(deep)));
+
+    auto errors = 0;
+    auto result = lexy::validate<nested_parens>(lexy::string_input(deep),
+                                                lexy::callback([&](auto&&...) { ++errors; }));
+    CHECK(!result);
+    CHECK(errors == 1);
+
+    SUBCASE("small thread stack")
+    {
+        small_stack_parse parse{nested_parens_input(100'000), false};
+
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, 256 * 1024);
+
+        pthread_t thread;
+        REQUIRE(pthread_create(&thread, &attr, &small_stack_parse::run, &parse) == 0);
+        pthread_join(thread, nullptr);
+        pthread_attr_destroy(&attr);
+
+        CHECK(parse.result);
+    }
+}
+#endif
@@ -62,6 +62,13 @@ TEST_CASE("dsl::until()")
         CHECK(many.status == test_result::success);
         CHECK(many.trace == test_trace().token("any", "abcdefghijklmnopqrstuvwxyz\\n"));
 
+        auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                                "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\tabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\n");
+        CHECK(simd.status == test_result::success);
+        CHECK(simd.trace
+              == test_trace().token("any",
+                                    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\\tabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\\n"));
+
         auto partial_before
             = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmno\rpqrstuvwxyz\n");
         CHECK(partial_before.status == test_result::success);
@@ -133,6 +140,13 @@ TEST_CASE("dsl::until().or_eof()")
         CHECK(many.status == test_result::success);
         CHECK(many.trace == test_trace().token("any", "abcdefghijklmnopqrstuvwxyz\\n"));
 
+        auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                                "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\tabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\n");
+        CHECK(simd.status == test_result::success);
+        CHECK(simd.trace
+              == test_trace().token("any",
+                                    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\\tabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\\n"));
+
         auto partial_before
             = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmno\rpqrstuvwxyz\n");
         CHECK(partial_before.status == test_result::success);
@@ -427,6 +427,7 @@ public:
                 handler._trace.backtracked(spelling.c_str());
             }
         }
+        void on(test_handler&, lexy::parse_events::lookahead, iterator) {}
 
         template <typename Reader, typename Tag>
         void on(test_handler&                   handler, lexy::parse_events::error,
@@ -0,0 +1,177 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/incremental_parse_tree.hpp>
+
+#include <doctest/doctest.h>
+#include <iterator>
+#include <lexy/action/parse_as_tree.hpp>
+#include <lexy/callback/noop.hpp>
+#include <lexy/dsl.hpp>
+#include <lexy/input/string_input.hpp>
+#include <lexy/visualize.hpp>
+#include <string>
+
+namespace
+{
+namespace dsl = lexy::dsl;
+
+struct atom
+{
+    static constexpr auto name = "atom";
+    static constexpr auto rule = dsl::identifier(dsl::ascii::alpha);
+};
+
+struct item
+{
+    static constexpr auto name = "item";
+    // The arrow looks at the input following the atom even if it doesn't match.
+    static constexpr auto rule = dsl::p<atom> >> dsl::opt(LEXY_LIT("->") >> dsl::p<atom>);
+};
+
+struct neg
+{
+    static constexpr auto name = "neg";
+    static constexpr auto rule = dsl::lit_c<'-'> >> dsl::p<atom>;
+};
+
+struct group
+{
+    static constexpr auto name = "group";
+    static constexpr auto rule = dsl::parenthesized.list(dsl::recurse<struct element>);
+};
+
+struct element
+{
+    static constexpr auto name = "element";
+    static constexpr auto rule = dsl::p<group> | dsl::p<neg> | dsl::p<item>;
+};
+
+struct document
+{
+    static constexpr auto name       = "document";
+    static constexpr auto whitespace = dsl::ascii::space;
+    static constexpr auto rule       = dsl::list(dsl::p<element>) + dsl::eof;
+};
+
+struct flag_document
+{
+    static constexpr auto name       = "flag_document";
+    static constexpr auto whitespace = dsl::ascii::space;
+    static constexpr auto rule
+        = dsl::context_flag<flag_document>.create() + dsl::list(dsl::p<element>) + dsl::eof;
+};
+
+using tree_type = lexy::incremental_parse_tree_for<lexy::string_input<>>;
+
+template <typename Tree>
+std::string visualize(const Tree& tree)
+{
+    std::string result;
+    lexy::visualize_to(std::back_inserter(result), tree);
+    return result;
+}
+
+// The tree of a parse from scratch.
+template <typename Production>
+std::string expected_tree(const char* str)
+{
+    lexy::parse_tree_for<lexy::string_input<>> tree;
+    auto result = lexy::parse_as_tree<Production>(tree, lexy::zstring_input(str), lexy::noop);
+    REQUIRE(result.is_success());
+    return visualize(tree);
+}
+
+template <typename Production = document>
+void parse(tree_type& tree, const char* str)
+{
+    auto result = lexy::parse_as_tree<Production>(tree, lexy::zstring_input(str), lexy::noop);
+    REQUIRE(result.is_success());
+    CHECK(visualize(tree.tree()) == expected_tree<Production>(str));
+}
+} // namespace
+
+TEST_CASE("incremental_parse_tree")
+{
+    tree_type tree;
+    CHECK(tree.empty());
+
+    parse(tree, "a b (c d) -e f");
+    CHECK(!tree.empty());
+    CHECK(tree.reused_count() == 0);
+
+    SUBCASE("no edit")
+    {
+        // Without an edit, the tree is built from scratch.
+        parse(tree, "a b (c d) -e f");
+        CHECK(tree.reused_count() == 0);
+    }
+    SUBCASE("replace")
+    {
+        tree.edit(5, 1, 3);
+        parse(tree, "a b (xyz d) -e f");
+        // a, b, -e, f, and d inside the group.
+        CHECK(tree.reused_count() == 5);
+    }
+    SUBCASE("insert")
+    {
+        tree.edit(0, 0, 2);
+        parse(tree, "z a b (c d) -e f");
+        // Everything except the new element.
+        CHECK(tree.reused_count() == 5);
+    }
+    SUBCASE("erase")
+    {
+        tree.edit(10, 3, 0);
+        parse(tree, "a b (c d) f");
+        // The group has looked at the whitespace after it, but its elements are reused.
+        CHECK(tree.reused_count() == 5);
+    }
+    SUBCASE("lookahead")
+    {
+        parse(tree, "a b-c");
+
+        // The arrow after b has looked at "-c", so b changes even though it ends before the edit.
+        tree.edit(4, 0, 1);
+        parse(tree, "a b->c");
+        // a, and the atoms b and c.
+        CHECK(tree.reused_count() == 3);
+    }
+    SUBCASE("context variable")
+    {
+        parse<flag_document>(tree, "a b (c d) -e f");
+
+        // The elements could depend on the flag, so they are parsed again.
+        tree.edit(0, 1, 1);
+        parse<flag_document>(tree, "x b (c d) -e f");
+        CHECK(tree.reused_count() == 0);
+    }
+    SUBCASE("multiple edits")
+    {
+        tree.edit(0, 1, 1);
+        tree.edit(13, 0, 3);
+        parse(tree, "x b (c d) -e gh f");
+        // The edits are merged into one that covers everything but f.
+        CHECK(tree.reused_count() == 1);
+    }
+    SUBCASE("failure")
+    {
+        tree.edit(0, 1, 1);
+        auto result = lexy::parse_as_tree<document>(tree, lexy::zstring_input("! b (c d) -e f"),
+                                                    lexy::noop);
+        CHECK(!result.is_success());
+        CHECK(tree.empty());
+
+        parse(tree, "a b (c d) -e f");
+        CHECK(tree.reused_count() == 0);
+    }
+    SUBCASE("clear")
+    {
+        tree.clear();
+        CHECK(tree.empty());
+
+        tree.edit(0, 1, 1);
+        parse(tree, "x b (c d) -e f");
+        CHECK(tree.reused_count() == 0);
+    }
+}
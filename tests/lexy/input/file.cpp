@@ -195,6 +195,108 @@ TEST_CASE("read_file")
     std::remove(test_file_name);
 }
 
+TEST_CASE("map_file")
+{
+    std::remove(test_file_name);
+
+    SUBCASE("non-existing file")
+    {
+        auto result = lexy::map_file(test_file_name);
+        CHECK(!result);
+        CHECK(result.error() == lexy::file_error::file_not_found);
+    }
+    SUBCASE("empty file")
+    {
+        write_test_data("");
+
+        auto result = lexy::map_file(test_file_name);
+        REQUIRE(result);
+        CHECK(result.buffer().size() == 0);
+
+        auto reader = result.buffer().reader();
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+    }
+    SUBCASE("tiny file")
+    {
+        write_test_data("abc");
+
+        auto result = lexy::map_file(test_file_name);
+        REQUIRE(result);
+        CHECK(result.buffer().size() == 3);
+
+        auto reader = result.buffer().reader();
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        CHECK(reader.peek() == 'c');
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+    }
+    SUBCASE("page-sized file")
+    {
+        {
+            auto file = std::fopen(test_file_name, "wb");
+            for (auto i = 0; i != 64 * 1024; ++i)
+                std::fputc('a', file);
+            std::fclose(file);
+        }
+
+        auto result = lexy::map_file<lexy::utf8_encoding>(test_file_name);
+        REQUIRE(result);
+        CHECK(result.buffer().size() == 64 * 1024);
+
+        auto reader = result.buffer().reader();
+        for (auto i = 0; i != 64 * 1024; ++i)
+        {
+            CHECK(reader.peek() == 'a');
+            reader.bump();
+        }
+
+        CHECK(reader.peek() == lexy::utf8_encoding::eof());
+        CHECK(reader.peek_swar() == lexy::_detail::swar_fill(lexy::utf8_encoding::eof()));
+    }
+    SUBCASE("UTF-8 with BOM")
+    {
+        write_test_data("\xEF\xBB\xBF"
+                        "abc");
+
+        auto result = lexy::map_file<lexy::utf8_encoding>(test_file_name);
+        REQUIRE(result);
+        CHECK(result.buffer().size() == 3);
+
+        auto reader = result.buffer().reader();
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        CHECK(reader.peek() == 'c');
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::utf8_encoding::eof());
+    }
+    SUBCASE("move")
+    {
+        write_test_data("abc");
+
+        auto buffer = lexy::map_file(test_file_name).buffer();
+        CHECK(buffer.size() == 3);
+
+        lexy::mapped_buffer<> other;
+        other = LEXY_MOV(buffer);
+        CHECK(buffer.size() == 0);
+        CHECK(other.size() == 3);
+        CHECK(other.reader().peek() == 'a');
+    }
+
+    std::remove(test_file_name);
+}
+
 TEST_CASE("read_stdin")
 {
     // Here, we'll reassociate stdin with our test file.
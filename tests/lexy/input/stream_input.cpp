@@ -0,0 +1,193 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/input/stream_input.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/action/match.hpp>
+#include <lexy/action/scan.hpp>
+#include <lexy/callback/noop.hpp>
+#include <lexy/dsl/branch.hpp>
+#include <lexy/dsl/capture.hpp>
+#include <lexy/dsl/choice.hpp>
+#include <lexy/dsl/digit.hpp>
+#include <lexy/dsl/eof.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/newline.hpp>
+#include <lexy/dsl/peek.hpp>
+#include <lexy/dsl/sequence.hpp>
+#include <string>
+
+namespace
+{
+struct production
+{
+    static constexpr auto rule = lexy::dsl::peek(LEXY_LIT("abcdefx")) >> LEXY_LIT("abcdefx")
+                                 | lexy::dsl::else_ >> LEXY_LIT("abcdefg") + lexy::dsl::eof;
+};
+
+struct test_file
+{
+    std::FILE* file;
+
+    explicit test_file(const char* data) : file(std::tmpfile())
+    {
+        std::fputs(data, file);
+        std::rewind(file);
+    }
+    ~test_file()
+    {
+        std::fclose(file);
+    }
+};
+} // namespace
+
+TEST_CASE("stream_input")
+{
+    SUBCASE("empty")
+    {
+        test_file            file("");
+        lexy::stream_input<> input(file.file);
+
+        auto reader = input.reader();
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(input.window_size() == 0);
+        CHECK(!input.has_error());
+    }
+    SUBCASE("refills")
+    {
+        test_file            file("abcdefg");
+        lexy::stream_input<> input(file.file, 2);
+
+        auto reader = input.reader();
+        auto begin  = reader.position();
+        CHECK(begin.offset() == 0);
+
+        for (auto c : {'a', 'b', 'c', 'd', 'e', 'f', 'g'})
+        {
+            CHECK(reader.peek() == c);
+            reader.bump();
+        }
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(reader.position().offset() == 7);
+        CHECK(reader.position() - begin == 7);
+
+        // Nothing was discarded, so everything is still available.
+        CHECK(input.window_size() == 7);
+        CHECK(*begin == 'a');
+        CHECK(lexy::_detail::range_size(begin, reader.position()) == 7);
+    }
+    SUBCASE("growth")
+    {
+        std::string str;
+        for (auto i = 0; i != 1000; ++i)
+            str += char('a' + i % 26);
+        test_file            file(str.c_str());
+        lexy::stream_input<> input(file.file, 1);
+
+        // Nothing is discarded, so the window has to grow many times.
+        auto reader = input.reader();
+        for (auto c : str)
+        {
+            CHECK(reader.peek() == c);
+            reader.bump();
+        }
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(input.window_size() == str.size());
+        CHECK(!input.has_error());
+    }
+    SUBCASE("allocation failure")
+    {
+        test_file            file("abc");
+        lexy::stream_input<> input(file.file, std::size_t(-1) / 2);
+
+        // The window can't be allocated, which must not look like the end of the stream.
+        auto reader = input.reader();
+        auto thrown = false;
+        try
+        {
+            reader.peek();
+        }
+        catch (const std::bad_alloc&)
+        {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+    SUBCASE("discard")
+    {
+        test_file            file("abcdefg");
+        lexy::stream_input<> input(file.file, 2);
+
+        auto reader = input.reader();
+        reader.bump();
+        reader.bump();
+        reader.bump();
+        CHECK(reader.peek() == 'd');
+        input.discard(reader.position());
+
+        // A new reader starts at the discarded position.
+        auto other = input.reader();
+        CHECK(other.position() == reader.position());
+        CHECK(other.peek() == 'd');
+
+        for (auto c : {'d', 'e', 'f', 'g'})
+        {
+            CHECK(reader.peek() == c);
+            reader.bump();
+        }
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(input.window_size() == 4);
+    }
+    SUBCASE("backtracking across refills")
+    {
+        test_file            file("abcdefg");
+        lexy::stream_input<> input(file.file, 1);
+
+        auto reader = input.reader();
+        auto marker = reader.current();
+        for (auto i = 0; i != 5; ++i)
+            reader.bump();
+        CHECK(reader.peek() == 'f');
+
+        reader.reset(marker);
+        CHECK(reader.peek() == 'a');
+    }
+    SUBCASE("match")
+    {
+        test_file            file("abcdefg");
+        lexy::stream_input<> input(file.file, 1);
+        CHECK(lexy::match<production>(input));
+    }
+    SUBCASE("scan records")
+    {
+        test_file            file("123\n45\n6789\n");
+        lexy::stream_input<> input(file.file, 4);
+
+        auto scanner = lexy::scan(input, lexy::noop);
+
+        auto lex = scanner.capture(lexy::dsl::digits<>);
+        scanner.parse(lexy::dsl::newline);
+        REQUIRE(scanner);
+        CHECK(lex.value().size() == 3);
+        input.discard(scanner.position());
+
+        lex = scanner.capture(lexy::dsl::digits<>);
+        scanner.parse(lexy::dsl::newline);
+        REQUIRE(scanner);
+        CHECK(lex.value().size() == 2);
+        CHECK(*lex.value().begin() == '4');
+        input.discard(scanner.position());
+
+        lex = scanner.capture(lexy::dsl::digits<>);
+        scanner.parse(lexy::dsl::newline);
+        REQUIRE(scanner);
+        CHECK(lex.value().size() == 4);
+        CHECK(*lex.value().begin() == '6');
+        CHECK(scanner.is_at_eof());
+
+        // Only the last record is kept in memory.
+        CHECK(input.window_size() == 5);
+    }
+}
+
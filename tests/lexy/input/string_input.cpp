@@ -4,6 +4,7 @@
 #include <lexy/input/string_input.hpp>
 
 #include <doctest/doctest.h>
+#include <lexy/_detail/swar.hpp>
 
 TEST_CASE("string_input")
 {
@@ -90,3 +91,34 @@ TEST_CASE("string_input")
     }
 }
 
+
+TEST_CASE("string_input SWAR")
+{
+    using lexy::_detail::swar_pack;
+
+    CHECK(!lexy::_detail::is_swar_reader<lexy::input_reader<lexy::string_input<>>>);
+#if LEXY_HAS_IS_CONSTANT_EVALUATED
+    CHECK(lexy::_detail::is_swar_reader<
+          lexy::input_reader<lexy::string_input<lexy::utf8_char_encoding>>>);
+
+    constexpr auto eof = char(lexy::utf8_char_encoding::eof());
+
+    auto input  = lexy::zstring_input<lexy::utf8_char_encoding>("abcdefghijk");
+    auto reader = input.reader();
+    CHECK(reader.peek_swar() == swar_pack('a', 'b', 'c', 'd', 'e', 'f', 'g', 'h').value);
+
+    reader.bump_swar();
+    CHECK(reader.peek_swar() == swar_pack('i', 'j', 'k', eof, eof, eof, eof, eof).value);
+
+    reader.bump_swar(3);
+    CHECK(reader.peek_swar() == swar_pack(eof, eof, eof, eof, eof, eof, eof, eof).value);
+    CHECK(reader.position() == input.data() + input.size());
+
+    constexpr auto constexpr_swar = [] {
+        auto r = lexy::zstring_input<lexy::utf8_char_encoding>("abcdefghijk").reader();
+        r.bump_swar(2);
+        return r.peek_swar();
+    }();
+    CHECK(constexpr_swar == swar_pack('c', 'd', 'e', 'f', 'g', 'h', 'i', 'j').value);
+#endif
+}
@@ -4,7 +4,9 @@
 #include <lexy/input_location.hpp>
 
 #include <doctest/doctest.h>
+#include <lexy/input/buffer.hpp>
 #include <lexy/input/string_input.hpp>
+#include <string>
 
 TEST_CASE("get_input_location()")
 {
@@ -159,6 +161,97 @@ TEST_CASE("get_input_location()")
     }
 }
 
+TEST_CASE("input_line_index")
+{
+    // The index only works for strategies whose lines end at newlines.
+    CHECK(lexy::_is_newline_location_counting<lexy::code_unit_location_counting>);
+    CHECK(lexy::_is_newline_location_counting<lexy::code_point_location_counting>);
+    CHECK(!lexy::_is_newline_location_counting<lexy::byte_location_counting<>>);
+
+    auto verify = [](const auto& input, const auto& index) {
+        auto begin = input.reader().position();
+        auto end   = begin + input.size();
+
+        auto line_count = 1u;
+        for (auto iter = begin; iter != end; ++iter)
+            if (*iter == '\n')
+                ++line_count;
+        REQUIRE(index.line_count() == line_count);
+
+        for (auto iter = begin;; ++iter)
+        {
+            auto expected = lexy::get_input_location(input, iter);
+            auto actual   = lexy::get_input_location(input, iter, index);
+            INFO(iter - begin);
+            CHECK(actual.line_nr() == expected.line_nr());
+            CHECK(actual.column_nr() == expected.column_nr());
+            CHECK(actual.position() == expected.position());
+            CHECK(actual.anchor()._line_begin.position()
+                  == expected.anchor()._line_begin.position());
+
+            if (iter == end)
+                break;
+        }
+
+        auto last = begin;
+        for (auto line_nr = 1u; line_nr <= line_count; ++line_nr)
+        {
+            auto line = index.line(line_nr);
+            CHECK(line.begin() == last);
+            CHECK(index.line_anchor(line_nr)._line_begin.position() == last);
+            CHECK(index.line_anchor(line_nr)._line_nr == line_nr);
+            if (line_nr < line_count)
+                CHECK(line.end()[-1] == '\n');
+            last = line.end();
+        }
+        CHECK(last == end);
+    };
+
+    SUBCASE("empty")
+    {
+        auto input = lexy::zstring_input("");
+        auto index = lexy::input_line_index(input);
+        verify(input, index);
+        CHECK(index.line(1).empty());
+    }
+    SUBCASE("single line")
+    {
+        auto input = lexy::zstring_input("Line 1");
+        auto index = lexy::input_line_index(input);
+        verify(input, index);
+    }
+    SUBCASE("multiple lines")
+    {
+        auto input = lexy::zstring_input("Line 1\n"
+                                         "Line 2\r\n"
+                                         "\n"
+                                         "Line 4\n");
+        auto index = lexy::input_line_index(input);
+        verify(input, index);
+        CHECK(index.line_count() == 5);
+        CHECK(index.line(2).size() == 8);
+        CHECK(index.line(5).empty());
+    }
+    SUBCASE("long lines")
+    {
+        std::string str;
+        for (auto i = 0u; i != 20; ++i)
+        {
+            str.append(i * 7, 'a');
+            str += i % 3 == 0 ? "\r\n" : "\n";
+        }
+        str += "end";
+
+        auto input = lexy::string_input(str.data(), str.size());
+        auto index = lexy::input_line_index(input);
+        verify(input, index);
+
+        auto buffer       = lexy::buffer(str.data(), str.size());
+        auto buffer_index = lexy::input_line_index(buffer);
+        verify(buffer, buffer_index);
+    }
+}
+
 TEST_CASE("_detail::get_input_line()")
 {
     auto input = lexy::zstring_input("Line 1\n"
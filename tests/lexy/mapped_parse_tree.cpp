@@ -0,0 +1,245 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/mapped_parse_tree.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <doctest/doctest.h>
+#include <iterator>
+#include <lexy/dsl/any.hpp>
+#include <lexy/input/string_input.hpp>
+#include <lexy_ext/parse_tree_doctest.hpp>
+#include <vector>
+
+namespace
+{
+enum class token_kind
+{
+    a,
+    b,
+    c,
+};
+
+const char* token_kind_name(token_kind k)
+{
+    switch (k)
+    {
+    case token_kind::a:
+        return "a";
+    case token_kind::b:
+        return "b";
+    case token_kind::c:
+        return "c";
+    }
+
+    return "";
+}
+
+struct child_p
+{
+    static constexpr auto name = "child_p";
+    static constexpr auto rule = lexy::dsl::any;
+};
+
+struct other_p
+{
+    static constexpr auto name = "other_p";
+    static constexpr auto rule = lexy::dsl::any;
+};
+
+struct root_p
+{
+    static constexpr auto name = "root_p";
+    static constexpr auto rule = lexy::dsl::any;
+};
+
+// Owns the saved bytes; std::vector<char> is suitably aligned for the nodes.
+std::vector<char> save(const lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>& tree)
+{
+    std::vector<char> result;
+    lexy::save_parse_tree(std::back_inserter(result), tree);
+    return result;
+}
+} // namespace
+
+TEST_CASE("mapped_parse_tree")
+{
+    using parse_tree  = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+    using mapped_tree = lexy::mapped_parse_tree_for<lexy::string_input<>, token_kind>;
+    auto input        = lexy::zstring_input("abcd");
+
+    SUBCASE("empty")
+    {
+        auto data = save(parse_tree());
+        CHECK(data.size() == 32);
+
+        auto tree = lexy::load_parse_tree<token_kind>(input, data.data(), data.size());
+        CHECK(tree.empty());
+        CHECK(tree.size() == 0);
+        CHECK(tree.remaining_input().empty());
+    }
+    SUBCASE("tree")
+    {
+        auto original = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+
+            auto child = builder.start_production(child_p{});
+            builder.token(token_kind::a, input.data(), input.data() + 1);
+
+            auto grand_child = builder.start_production(other_p{});
+            builder.token(token_kind::b, input.data() + 1, input.data() + 2);
+            builder.finish_production(LEXY_MOV(grand_child));
+
+            builder.token(token_kind::c, input.data() + 2, input.data() + 3);
+            builder.finish_production(LEXY_MOV(child));
+
+            return LEXY_MOV(builder).finish({input.data() + 3, input.data() + 4});
+        }();
+        auto data = save(original);
+        CHECK(data.size() == 32 + 7 * 16 + 3 * 4 + 23);
+
+        auto tree = lexy::load_parse_tree<token_kind>(input, data.data(), data.size());
+        CHECK(!tree.empty());
+        CHECK(tree.size() == original.size());
+        CHECK(tree.depth() == original.depth());
+        CHECK(tree.remaining_input().begin() == input.data() + 3);
+        CHECK(tree.remaining_input().end() == input.data() + 4);
+
+        auto expected = lexy_ext::parse_tree_desc<token_kind>(root_p{})
+                            .production(child_p{})
+                            .token(token_kind::a, "a")
+                            .production(other_p{})
+                            .token(token_kind::b, "b")
+                            .finish()
+                            .token(token_kind::c, "c")
+                            .finish();
+        CHECK(tree == expected);
+
+        auto root = tree.root();
+        CHECK(root.kind() == root_p{});
+        CHECK(root.kind() == original.root().kind());
+        CHECK(root.kind() != child_p{});
+        CHECK(root.kind().is_root());
+
+        auto child = *root.children().begin();
+        CHECK(child.kind() == child_p{});
+        CHECK(child.kind() != original.root().kind());
+        CHECK(child.parent() == root);
+        CHECK(child.covering_lexeme().begin() == input.data());
+        CHECK(child.covering_lexeme().end() == input.data() + 3);
+    }
+    SUBCASE("container")
+    {
+        // The production of the container is stored after its children.
+        auto original = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+
+            auto container = builder.start_container();
+            builder.token(token_kind::a, input.data(), input.data() + 1);
+            builder.token(token_kind::b, input.data() + 1, input.data() + 2);
+            builder.set_container_production(child_p{});
+            builder.finish_container(LEXY_MOV(container));
+
+            return LEXY_MOV(builder).finish({input.data() + 2, input.data() + 4});
+        }();
+        auto data = save(original);
+
+        auto tree = lexy::load_parse_tree<token_kind>(input, data.data(), data.size());
+        CHECK(tree == lexy_ext::parse_tree_desc<token_kind>(root_p{})
+                          .production(child_p{})
+                          .token(token_kind::a, "a")
+                          .token(token_kind::b, "b")
+                          .finish());
+    }
+    SUBCASE("different input")
+    {
+        auto original = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+            builder.token(token_kind::a, input.data() + 1, input.data() + 3);
+            return LEXY_MOV(builder).finish(input.data() + 4);
+        }();
+        auto data = save(original);
+
+        // Tokens are relative to the beginning of the input.
+        auto other = lexy::zstring_input("wxyz");
+        auto tree  = lexy::load_parse_tree<token_kind>(other, data.data(), data.size());
+        CHECK(tree == lexy_ext::parse_tree_desc<token_kind>(root_p{}).token(token_kind::a, "xy"));
+    }
+    SUBCASE("invalid")
+    {
+        auto original = parse_tree::builder(root_p{}, input.data()).finish(input.data() + 4);
+        auto data     = save(original);
+        CHECK(!lexy::load_parse_tree<token_kind>(input, data.data(), data.size()).empty());
+
+        // Truncated.
+        CHECK(lexy::load_parse_tree<token_kind>(input, data.data(), data.size() - 1).empty());
+        CHECK(lexy::load_parse_tree<token_kind>(input, data.data(), 16).empty());
+        // Not a tree.
+        data[0] = 'X';
+        CHECK(lexy::load_parse_tree<token_kind>(input, data.data(), data.size()).empty());
+        CHECK(mapped_tree(input.data(), 4, nullptr, 0).empty());
+    }
+    SUBCASE("stale")
+    {
+        auto original = [&] {
+            parse_tree::builder builder(root_p{}, input.data());
+            auto                child = builder.start_production(child_p{});
+            builder.token(token_kind::a, input.data(), input.data() + 2);
+            builder.finish_production(LEXY_MOV(child));
+            return LEXY_MOV(builder).finish(input.data() + 4);
+        }();
+        auto data = save(original);
+        CHECK(!lexy::load_parse_tree<token_kind>(input, data.data(), data.size()).empty());
+
+        // The nodes follow the 32 byte header; every node consists of four indices.
+        auto set_field = [&](std::vector<char> copy, std::size_t node, std::size_t field,
+                             std::uint_least32_t value) {
+            std::memcpy(copy.data() + 32 + node * 16 + field * 4, &value, sizeof(value));
+            return copy;
+        };
+        auto loads = [&](const std::vector<char>& bytes) {
+            return !lexy::load_parse_tree<token_kind>(input, bytes.data(), bytes.size()).empty();
+        };
+
+        // A different input size.
+        CHECK(lexy::load_parse_tree<token_kind>(lexy::zstring_input("abc"), data.data(),
+                                                data.size())
+                  .empty());
+        CHECK(lexy::load_parse_tree<token_kind>(lexy::zstring_input("abcde"), data.data(),
+                                                data.size())
+                  .empty());
+
+        // Node 0 is the root, node 1 the child, node 2 the token, node 3 the remaining input.
+        CHECK(!loads(set_field(data, 1, 0, 42)));           // next node out of range
+        CHECK(!loads(set_field(data, 1, 1, (7u << 3) | 1))); // production id out of range
+        CHECK(!loads(set_field(data, 1, 2, 42)));           // first child out of range
+        CHECK(!loads(set_field(data, 2, 2, 3)));            // token offset out of range
+        CHECK(!loads(set_field(data, 2, 3, 5)));            // token length out of range
+        CHECK(!loads(set_field(data, 0, 0, 1)));            // remaining input is not a token
+        CHECK(loads(set_field(data, 2, 3, 4)));             // token is still inside the input
+
+        // The child is its own first child.
+        CHECK(!loads(set_field(data, 1, 2, 1)));
+        // The token is its own next sibling (token kind a, sibling role).
+        CHECK(!loads(set_field(set_field(data, 2, 0, 2), 2, 1, 0)));
+        // The token links back to the root instead of the child.
+        CHECK(!loads(set_field(data, 2, 0, 0)));
+        // The child claims more children than there are.
+        CHECK(!loads(set_field(data, 1, 3, 2)));
+    }
+    SUBCASE("FILE")
+    {
+        auto original = parse_tree::builder(root_p{}, input.data()).finish(input.data() + 4);
+
+        auto file = std::tmpfile();
+        REQUIRE(file != nullptr);
+        CHECK(lexy::save_parse_tree(file, original));
+
+        std::vector<char> data(std::size_t(std::ftell(file)));
+        std::rewind(file);
+        CHECK(std::fread(data.data(), 1, data.size(), file) == data.size());
+        std::fclose(file);
+        CHECK(data == save(original));
+    }
+}
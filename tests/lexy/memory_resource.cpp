@@ -0,0 +1,134 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/memory_resource.hpp>
+
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <lexy/action/parse_as_tree.hpp>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/identifier.hpp>
+#include <lexy/dsl/list.hpp>
+#include <lexy/dsl/whitespace.hpp>
+#include <lexy/input/buffer.hpp>
+#include <lexy/parse_tree.hpp>
+#include <thread>
+#include <vector>
+
+namespace
+{
+bool is_aligned(void* ptr, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+struct production
+{
+    static constexpr auto whitespace = lexy::dsl::ascii::space;
+    static constexpr auto rule = lexy::dsl::list(lexy::dsl::identifier(lexy::dsl::ascii::alpha));
+};
+} // namespace
+
+TEST_CASE("monotonic_resource")
+{
+    lexy::monotonic_resource resource(64);
+    CHECK(resource == resource);
+    CHECK(resource != lexy::monotonic_resource());
+
+    SUBCASE("bump allocation")
+    {
+        auto a = static_cast<unsigned char*>(resource.allocate(8, 1));
+        auto b = static_cast<unsigned char*>(resource.allocate(8, 1));
+        CHECK(b == a + 8);
+
+        // Deallocation does not make the memory available again.
+        resource.deallocate(b, 8, 1);
+        CHECK(resource.allocate(8, 1) == b + 8);
+    }
+    SUBCASE("alignment")
+    {
+        resource.allocate(1, 1);
+        CHECK(is_aligned(resource.allocate(4, 4), 4));
+        CHECK(is_aligned(resource.allocate(8, 8), 8));
+        CHECK(is_aligned(resource.allocate(1, 256), 256));
+    }
+    SUBCASE("big allocations")
+    {
+        for (auto i = 0; i != 100; ++i)
+        {
+            auto ptr = static_cast<unsigned char*>(resource.allocate(100, 1));
+            ptr[0]   = 1;
+            ptr[99]  = 1;
+        }
+        auto big = static_cast<unsigned char*>(resource.allocate(1024 * 1024, 1));
+        big[1024 * 1024 - 1] = 1;
+    }
+    SUBCASE("release")
+    {
+        resource.allocate(1000, 1);
+        resource.release();
+
+        auto ptr = static_cast<unsigned char*>(resource.allocate(8, 1));
+        ptr[7]   = 1;
+    }
+    SUBCASE("entire parse")
+    {
+        using buffer_type = lexy::buffer<lexy::utf8_encoding, lexy::monotonic_resource>;
+        buffer_type buffer("abc def ghi", 11, &resource);
+        CHECK(buffer.size() == 11);
+
+        using tree_type = lexy::parse_tree_for<buffer_type, void, lexy::monotonic_resource>;
+        tree_type tree(&resource);
+        auto      result = lexy::parse_as_tree<production>(tree, buffer, lexy::noop);
+        CHECK(result.is_success());
+        CHECK(tree.size() == 6); // root, three identifiers and two whitespace tokens
+    }
+}
+
+TEST_CASE("thread_local_pool_resource")
+{
+    using resource = lexy::thread_local_pool_resource;
+    CHECK(resource() == resource());
+
+    SUBCASE("re-use")
+    {
+        auto a = resource::allocate(24, 8);
+        resource::deallocate(a, 24, 8);
+        CHECK(resource::allocate(20, 4) == a);
+        resource::deallocate(a, 20, 4);
+
+        // A different size class does not re-use it.
+        auto b = resource::allocate(4, 4);
+        CHECK(b != a);
+        resource::deallocate(b, 4, 4);
+    }
+    SUBCASE("big allocations")
+    {
+        auto a = resource::allocate(resource::max_pooled_size + 1, 1);
+        auto b = resource::allocate(64, 256);
+        CHECK(is_aligned(b, 256));
+        resource::deallocate(a, resource::max_pooled_size + 1, 1);
+        resource::deallocate(b, 64, 256);
+    }
+    SUBCASE("threads")
+    {
+        // Memory can be deallocated on a different thread than it was allocated on.
+        std::vector<void*> memory;
+        for (auto i = 0; i != 100; ++i)
+            memory.push_back(resource::allocate(std::size_t(i + 1), 1));
+
+        std::thread thread([&] {
+            for (auto i = 0; i != 100; ++i)
+                resource::deallocate(memory[std::size_t(i)], std::size_t(i + 1), 1);
+        });
+        thread.join();
+    }
+    SUBCASE("allocator")
+    {
+        std::vector<int, lexy::memory_resource_allocator<int, resource>> vec;
+        for (auto i = 0; i != 100; ++i)
+            vec.push_back(i);
+        CHECK(vec[99] == 99);
+        CHECK(vec.get_allocator().resource() == nullptr);
+    }
+}
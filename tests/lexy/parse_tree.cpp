@@ -1214,3 +1214,91 @@ TEST_CASE("parse_tree::traverse_range")
     }
 }
 
+
+namespace
+{
+struct counting_resource
+{
+    std::size_t allocations   = 0;
+    std::size_t deallocations = 0;
+
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        ++allocations;
+        return lexy::_detail::default_memory_resource::allocate(bytes, alignment);
+    }
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        ++deallocations;
+        lexy::_detail::default_memory_resource::deallocate(ptr, bytes, alignment);
+    }
+
+    friend bool operator==(const counting_resource& lhs, const counting_resource& rhs)
+    {
+        return &lhs == &rhs;
+    }
+};
+} // namespace
+
+TEST_CASE("parse_tree memory")
+{
+    using parse_tree = lexy::parse_tree_for<lexy::string_input<>, token_kind, counting_resource>;
+    auto input       = lexy::zstring_input("abc");
+
+    // Needs multiple blocks of the default size.
+    auto build = [&](parse_tree&& tree) {
+        parse_tree::builder builder(LEXY_MOV(tree), root_p{});
+        for (auto i = 0; i != 1024; ++i)
+        {
+            auto m = builder.start_production(child_p{});
+            builder.token(token_kind::a, input.data(), input.data() + input.size());
+            builder.finish_production(LEXY_MOV(m));
+        }
+        return LEXY_MOV(builder).finish(input.data() + input.size());
+    };
+
+    counting_resource resource;
+    SUBCASE("default")
+    {
+        {
+            parse_tree tree(&resource);
+            tree.clear();
+            CHECK(resource.allocations == 0);
+
+            tree = build(LEXY_MOV(tree));
+            CHECK(tree.size() == 2049);
+            CHECK(resource.allocations > 1);
+        }
+        CHECK(resource.deallocations == resource.allocations);
+    }
+    SUBCASE("re-use")
+    {
+        {
+            parse_tree tree(&resource);
+            tree = build(LEXY_MOV(tree));
+
+            auto allocations = resource.allocations;
+            tree.clear();
+            CHECK(tree.empty());
+            CHECK(resource.deallocations == 0);
+
+            tree = build(LEXY_MOV(tree));
+            CHECK(tree.size() == 2049);
+            CHECK(resource.allocations == allocations);
+
+            tree = build(LEXY_MOV(tree));
+            CHECK(resource.allocations == allocations);
+        }
+        CHECK(resource.deallocations == resource.allocations);
+    }
+    SUBCASE("size hint")
+    {
+        {
+            parse_tree tree(1024 * 1024, &resource);
+            tree = build(LEXY_MOV(tree));
+            CHECK(tree.size() == 2049);
+            CHECK(resource.allocations == 1);
+        }
+        CHECK(resource.deallocations == 1);
+    }
+}
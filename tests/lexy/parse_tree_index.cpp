@@ -0,0 +1,252 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/parse_tree_index.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/compact_parse_tree.hpp>
+#include <lexy/input/string_input.hpp>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+enum class token_kind
+{
+    a,
+    b,
+    c,
+};
+
+struct child_p
+{
+    static constexpr auto name = "child_p";
+    static constexpr auto rule = 0; // Need a rule to identify as production.
+};
+
+struct other_p
+{
+    static constexpr auto name = "other_p";
+    static constexpr auto rule = 0; // Need a rule to identify as production.
+};
+
+struct root_p
+{
+    static constexpr auto name = "root_p";
+    static constexpr auto rule = 0; // Need a rule to identify as production.
+};
+
+// '(' and ')' open and close a child_p with a b token each, '[' and ']' an other_p,
+// '_' is an empty child_p, and every other character is an a token.
+template <typename Builder, typename Input>
+auto build_tree(Builder builder, const Input& input)
+{
+    std::vector<typename Builder::marker> stack;
+    auto                                 ptr = input.data();
+    for (auto end = input.data() + input.size(); ptr != end; ++ptr)
+    {
+        if (*ptr == '(' || *ptr == '[')
+        {
+            if (*ptr == '(')
+                stack.push_back(builder.start_production(child_p{}));
+            else
+                stack.push_back(builder.start_production(other_p{}));
+            builder.token(token_kind::b, ptr, ptr + 1);
+        }
+        else if (*ptr == ')' || *ptr == ']')
+        {
+            builder.token(token_kind::b, ptr, ptr + 1);
+            builder.finish_production(LEXY_MOV(stack.back()));
+            stack.pop_back();
+        }
+        else if (*ptr == '_')
+        {
+            auto m = builder.start_production(child_p{});
+            builder.finish_production(LEXY_MOV(m));
+        }
+        else
+        {
+            builder.token(token_kind::a, ptr, ptr + 1);
+        }
+    }
+
+    return LEXY_MOV(builder).finish(ptr);
+}
+
+// Compares every query against a traversal of the tree.
+template <typename Tree, typename Input, typename Kind>
+void check_kind(const Tree& tree, const lexy::parse_tree_index<Tree>& index, const Input& input,
+                Kind kind)
+{
+    using node = typename Tree::node;
+
+    std::vector<node> all;
+    for (auto [event, n] : tree.traverse())
+        if (event != lexy::traverse_event::exit && n.kind() == kind)
+            all.push_back(n);
+
+    auto range = index.nodes(kind);
+    REQUIRE(range.size() == all.size());
+    CHECK(std::vector<node>(range.begin(), range.end()) == all);
+
+    for (auto [event, ancestor] : tree.traverse())
+    {
+        if (event == lexy::traverse_event::exit)
+            continue;
+
+        std::vector<node> descendants;
+        for (auto [e, n] : tree.traverse(ancestor))
+            if (e != lexy::traverse_event::exit && n != ancestor && n.kind() == kind)
+                descendants.push_back(n);
+
+        auto sub = index.nodes(kind, ancestor);
+        CHECK(std::vector<node>(sub.begin(), sub.end()) == descendants);
+    }
+
+    auto begin    = input.data();
+    auto end      = input.data() + input.size();
+    auto last_end = begin;
+    for (auto [event, n] : tree.traverse())
+        if (event == lexy::traverse_event::leaf)
+            last_end = n.lexeme().end();
+
+    for (auto first = begin; first != end; ++first)
+        for (auto last = first; last != end + 1; ++last)
+        {
+            std::vector<node> in_range;
+            for (auto n : all)
+            {
+                // The first token at or after the node in pre-order.
+                auto position = last_end;
+                auto entered  = false;
+                for (auto [e, t] : tree.traverse())
+                {
+                    if (t == n)
+                        entered = true;
+                    if (entered && e == lexy::traverse_event::leaf)
+                    {
+                        position = t.lexeme().begin();
+                        break;
+                    }
+                }
+                if (first <= position && position < last)
+                    in_range.push_back(n);
+            }
+
+            auto sub = index.nodes(kind, first, last);
+            CHECK(std::vector<node>(sub.begin(), sub.end()) == in_range);
+        }
+}
+
+// Counts the memory that is still allocated, and can fail after some allocations.
+struct counting_resource
+{
+    std::size_t allocated = 0;
+    // The number of allocations that succeed before one throws.
+    std::size_t remaining = std::size_t(-1);
+
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (remaining == 0)
+            throw std::bad_alloc();
+        --remaining;
+
+        allocated += bytes;
+        return lexy::_detail::default_memory_resource::allocate(bytes, alignment);
+    }
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        allocated -= bytes;
+        lexy::_detail::default_memory_resource::deallocate(ptr, bytes, alignment);
+    }
+};
+
+template <typename Tree, typename Input>
+void check_index(const Tree& tree, const Input& input)
+{
+    lexy::parse_tree_index<Tree> index(tree);
+    CHECK(index.size() == tree.size());
+
+    check_kind(tree, index, input, lexy::production_info(root_p{}));
+    check_kind(tree, index, input, lexy::production_info(child_p{}));
+    check_kind(tree, index, input, lexy::production_info(other_p{}));
+    check_kind(tree, index, input, lexy::token_kind<token_kind>(token_kind::a));
+    check_kind(tree, index, input, lexy::token_kind<token_kind>(token_kind::b));
+    CHECK(index.nodes(token_kind::c).empty());
+}
+} // namespace
+
+TEST_CASE("parse_tree_index")
+{
+    using parse_tree = lexy::parse_tree_for<lexy::string_input<>, token_kind>;
+    auto input       = lexy::zstring_input("ab(c_[d(e)])_[f(_)g]h");
+    auto tree        = build_tree(parse_tree::builder(root_p{}), input);
+
+    lexy::parse_tree_index<parse_tree> index(tree);
+    CHECK(index.size() == 27);
+    CHECK(index.kind_count() == 5);
+
+    auto children = index.nodes(child_p{});
+    REQUIRE(children.size() == 6);
+    auto paren = *children.begin();
+    CHECK(paren.position() == input.data() + 2);
+
+    auto nested = index.nodes(child_p{}, paren);
+    REQUIRE(nested.size() == 2);
+    CHECK((*nested.begin()).kind() == child_p{});
+    CHECK(index.nodes(other_p{}, paren).size() == 1);
+    CHECK(index.nodes(token_kind::a, paren).size() == 3);
+    CHECK(index.nodes(token_kind::a, *index.nodes(token_kind::a).begin()).empty());
+
+    auto tokens = index.nodes(token_kind::a, input.data() + 2, input.data() + 9);
+    REQUIRE(tokens.size() == 3);
+    CHECK((*tokens.begin()).lexeme().begin() == input.data() + 3);
+    // The empty production at position 4 begins at the next token.
+    CHECK(index.nodes(child_p{}, input.data() + 4, input.data() + 6).size() == 1);
+    CHECK(index.nodes(child_p{}, input.data() + 4, input.data() + 5).empty());
+
+    SUBCASE("parse_tree")
+    {
+        check_index(tree, input);
+    }
+    SUBCASE("compact_parse_tree")
+    {
+        using compact_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+        check_index(build_tree(compact_tree::builder(root_p{}, input.data()), input), input);
+    }
+    SUBCASE("trailing empty productions")
+    {
+        auto trailing = lexy::zstring_input("a(b)__");
+        check_index(build_tree(parse_tree::builder(root_p{}), trailing), trailing);
+    }
+    SUBCASE("memory resource")
+    {
+        counting_resource resource;
+        {
+            lexy::parse_tree_index<parse_tree, counting_resource> index(tree, &resource);
+            CHECK(resource.allocated > 0);
+            CHECK(index.nodes(child_p{}, paren).size() == 2);
+        }
+        CHECK(resource.allocated == 0);
+    }
+    SUBCASE("allocation failure")
+    {
+        // Every allocation fails once; nothing allocated before it must leak.
+        for (auto count = std::size_t(0);; ++count)
+        {
+            counting_resource resource;
+            resource.remaining = count;
+            try
+            {
+                lexy::parse_tree_index<parse_tree, counting_resource> index(tree, &resource);
+                CHECK(index.size() == tree.size());
+                break;
+            }
+            catch (const std::bad_alloc&)
+            {
+                CHECK(resource.allocated == 0);
+            }
+        }
+    }
+}
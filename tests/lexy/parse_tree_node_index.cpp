@@ -0,0 +1,232 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/parse_tree_node_index.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/compact_parse_tree.hpp>
+#include <lexy/input/string_input.hpp>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+enum class token_kind
+{
+    a,
+    b,
+    c,
+};
+
+struct child_p
+{
+    static constexpr auto name = "child_p";
+    static constexpr auto rule = 0; // Need a rule to identify as production.
+};
+
+struct root_p
+{
+    static constexpr auto name = "root_p";
+    static constexpr auto rule = 0; // Need a rule to identify as production.
+};
+
+// '(' and ')' open and close a production with a token each, '_' is an empty production,
+// and every other character is a token.
+template <typename Builder, typename Input>
+auto build_tree(Builder builder, const Input& input)
+{
+    std::vector<typename Builder::marker> stack;
+    auto                                 ptr = input.data();
+    for (auto end = input.data() + input.size(); ptr != end; ++ptr)
+    {
+        if (*ptr == '(')
+        {
+            stack.push_back(builder.start_production(child_p{}));
+            builder.token(token_kind::b, ptr, ptr + 1);
+        }
+        else if (*ptr == ')')
+        {
+            builder.token(token_kind::b, ptr, ptr + 1);
+            builder.finish_production(LEXY_MOV(stack.back()));
+            stack.pop_back();
+        }
+        else if (*ptr == '_')
+        {
+            // An empty production.
+            auto m = builder.start_production(child_p{});
+            builder.finish_production(LEXY_MOV(m));
+        }
+        else
+        {
+            builder.token(token_kind::a, ptr, ptr + 1);
+        }
+    }
+
+    return LEXY_MOV(builder).finish(ptr);
+}
+
+// Counts the memory that is still allocated, and can fail after some allocations.
+struct counting_resource
+{
+    std::size_t allocated = 0;
+    // The number of allocations that succeed before one throws.
+    std::size_t remaining = std::size_t(-1);
+
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (remaining == 0)
+            throw std::bad_alloc();
+        --remaining;
+
+        allocated += bytes;
+        return lexy::_detail::default_memory_resource::allocate(bytes, alignment);
+    }
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        allocated -= bytes;
+        lexy::_detail::default_memory_resource::deallocate(ptr, bytes, alignment);
+    }
+};
+
+template <typename Tree, typename Input>
+void check_index(const Tree& tree, const Input& input)
+{
+    lexy::parse_tree_node_index<Tree> index(tree);
+    CHECK(index.root() == tree.root());
+
+    auto count = std::size_t(0);
+    for (auto [event, node] : tree.traverse())
+    {
+        if (event == lexy::traverse_event::exit)
+            continue;
+        ++count;
+
+        CHECK(index.parent(node) == node.parent());
+
+        auto i = std::size_t(0);
+        for (auto child : node.children())
+        {
+            REQUIRE(i < index.child_count(node));
+            CHECK(index.child(node, i) == child);
+            ++i;
+        }
+        CHECK(index.child_count(node) == i);
+    }
+    CHECK(index.size() == count);
+
+    for (auto pos = input.data(); pos != input.data() + input.size(); ++pos)
+    {
+        // The first token that ends after the position.
+        auto expected = tree.root();
+        for (auto [event, node] : tree.traverse())
+            if (event == lexy::traverse_event::leaf && pos < node.lexeme().end())
+            {
+                expected = node;
+                break;
+            }
+
+        auto token = index.find_covering_node(pos);
+        REQUIRE(token.kind().is_token());
+        CHECK(token == expected);
+    }
+}
+} // namespace
+
+TEST_CASE("parse_tree_node_index")
+{
+    using parse_tree = lexy::parse_tree_for<lexy::string_input<>, token_kind>;
+    auto input       = lexy::zstring_input("ab(c_d)_(e(f()g)h)i");
+    auto tree        = build_tree(parse_tree::builder(root_p{}), input);
+
+    lexy::parse_tree_node_index<parse_tree> index(tree);
+    CHECK(index.size() == 24);
+
+    auto root = tree.root();
+    CHECK(index.root() == root);
+    CHECK(index.parent(root) == root);
+    REQUIRE(index.child_count(root) == 6);
+
+    auto a = index.child(root, 0);
+    CHECK(a.lexeme().begin() == input.data());
+    CHECK(index.parent(a) == root);
+    CHECK(index.child_count(a) == 0);
+    CHECK(index.position(a) == input.data());
+    CHECK(index.has_token(a));
+
+    auto paren = index.child(root, 2);
+    CHECK(paren.kind() == child_p{});
+    CHECK(index.position(paren) == input.data() + 2);
+    CHECK(index.has_token(paren));
+    REQUIRE(index.child_count(paren) == 5);
+    CHECK(index.parent(index.child(paren, 4)) == paren);
+
+    auto empty = index.child(paren, 2);
+    CHECK(empty.kind() == child_p{});
+    CHECK(index.child_count(empty) == 0);
+    CHECK(index.position(empty) == input.data() + 4);
+    CHECK(!index.has_token(empty));
+    CHECK(index.position(index.child(root, 3)) == input.data() + 7);
+
+    CHECK(index.child_at(root, input.data()) == a);
+    CHECK(index.child_at(root, input.data() + 2) == paren);
+    CHECK(index.child_at(root, input.data() + 6) == paren);
+    CHECK(index.child_at(root, input.data() + 7) == index.child(root, 4));
+    CHECK(index.child_at(root, input.data() + 19) == index.child(root, 5));
+    CHECK(index.child_at(paren, input.data() + 4) == index.child(paren, 3));
+    CHECK(index.child_at(paren, input.data()) == index.child(paren, 0));
+
+    CHECK(index.find_covering_node(input.data() + 4) == index.child(paren, 3));
+    CHECK(index.find_covering_node(input.data() + 7) == index.child(index.child(root, 4), 0));
+    CHECK(index.find_covering_node(input.data() + 13).lexeme().begin() == input.data() + 13);
+
+    SUBCASE("parse_tree")
+    {
+        check_index(tree, input);
+    }
+    SUBCASE("compact_parse_tree")
+    {
+        using compact_tree = lexy::compact_parse_tree_for<lexy::string_input<>, token_kind>;
+        check_index(build_tree(compact_tree::builder(root_p{}, input.data()), input), input);
+    }
+    SUBCASE("deep")
+    {
+        std::string str;
+        for (auto i = 0; i != 200; ++i)
+            str += "a(b_";
+        for (auto i = 0; i != 200; ++i)
+            str += ")c";
+
+        auto deep_input = lexy::string_input(str.data(), str.size());
+        check_index(build_tree(parse_tree::builder(root_p{}), deep_input), deep_input);
+    }
+    SUBCASE("memory resource")
+    {
+        counting_resource resource;
+        {
+            lexy::parse_tree_node_index<parse_tree, counting_resource> index(tree, &resource);
+            CHECK(resource.allocated > 0);
+        CHECK(index.child_at(root, input.data() + 2) == paren);
+        }
+        CHECK(resource.allocated == 0);
+    }
+    SUBCASE("allocation failure")
+    {
+        // Every allocation fails once; nothing allocated before it must leak.
+        for (auto count = std::size_t(0);; ++count)
+        {
+            counting_resource resource;
+            resource.remaining = count;
+            try
+            {
+                lexy::parse_tree_node_index<parse_tree, counting_resource> index(tree, &resource);
+                CHECK(index.size() == tree.size());
+                break;
+            }
+            catch (const std::bad_alloc&)
+            {
+                CHECK(resource.allocated == 0);
+            }
+        }
+    }
+}
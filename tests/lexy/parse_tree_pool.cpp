@@ -0,0 +1,125 @@
+// Copyright (C) 2020-2025 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/parse_tree_pool.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/input/string_input.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct root_p
+{
+    static constexpr auto name = "root_p";
+    static constexpr auto rule = 0; // Need a rule to identify as production.
+};
+
+// Counts the memory that is still allocated.
+struct counting_resource
+{
+    std::size_t allocated = 0;
+
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        allocated += bytes;
+        return lexy::_detail::default_memory_resource::allocate(bytes, alignment);
+    }
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        allocated -= bytes;
+        lexy::_detail::default_memory_resource::deallocate(ptr, bytes, alignment);
+    }
+};
+} // namespace
+
+TEST_CASE("parse_tree_pool")
+{
+    using pool_type = lexy::parse_tree_pool_for<lexy::string_input<>>;
+    using tree_type = lexy::parse_tree_for<lexy::string_input<>>;
+
+    auto input = lexy::zstring_input("abc");
+    auto build = [&](tree_type& tree) {
+        tree_type::builder builder(LEXY_MOV(tree), root_p{});
+        builder.token(lexy::token_kind<>(1), input.data(), input.data() + input.size());
+        tree = LEXY_MOV(builder).finish(input.data() + input.size());
+    };
+
+    pool_type pool(64 * 1024);
+    CHECK(pool.available() == 0);
+
+    SUBCASE("acquire and release")
+    {
+        void* address = nullptr;
+        {
+            auto tree = pool.acquire();
+            CHECK(tree->empty());
+            CHECK(pool.available() == 0);
+
+            build(*tree);
+            CHECK(tree->size() == 2);
+            address = tree->root().address();
+        }
+        CHECK(pool.available() == 1);
+
+        {
+            auto tree = pool.acquire();
+            CHECK(pool.available() == 0);
+            CHECK(tree.get().empty());
+
+            // The memory of the previous tree is re-used.
+            build(tree.get());
+            CHECK(tree->root().address() == address);
+
+            auto other = pool.acquire();
+            CHECK(other->empty());
+        }
+        CHECK(pool.available() == 2);
+    }
+    SUBCASE("move")
+    {
+        auto tree  = pool.acquire();
+        auto other = LEXY_MOV(tree);
+        build(*other);
+        CHECK(other->size() == 2);
+    }
+    SUBCASE("threads")
+    {
+        std::atomic<int>         failures(0);
+        std::vector<std::thread> threads;
+        for (auto i = 0; i != 4; ++i)
+            threads.emplace_back([&] {
+                for (auto j = 0; j != 100; ++j)
+                {
+                    auto tree = pool.acquire();
+                    if (!tree->empty())
+                        ++failures;
+
+                    build(*tree);
+                    if (tree->size() != 2)
+                        ++failures;
+                }
+            });
+        for (auto& thread : threads)
+            thread.join();
+
+        CHECK(failures == 0);
+        CHECK(pool.available() >= 1);
+        CHECK(pool.available() <= 4);
+    }
+    SUBCASE("memory resource")
+    {
+        counting_resource resource;
+        {
+            // Without a size hint, only the entry of the pool is allocated.
+            lexy::parse_tree_pool_for<lexy::string_input<>, void, counting_resource>
+                resource_pool(0, &resource);
+            resource_pool.acquire();
+            CHECK(resource.allocated > 0);
+            CHECK(resource_pool.available() == 1);
+        }
+        CHECK(resource.allocated == 0);
+    }
+}
@@ -127,6 +127,14 @@ TEST_CASE("find_covering_node()")
 
     auto c = lexy_ext::find_covering_node(tree, input.data() + 6);
     CHECK(c.lexeme().begin() == input.data() + 4);
+
+    SUBCASE("index")
+    {
+        lexy::parse_tree_node_index<parse_tree> index(tree);
+        for (auto pos = input.data(); pos != input.data() + 11; ++pos)
+            CHECK(lexy_ext::find_covering_node(tree, pos, index)
+                  == lexy_ext::find_covering_node(tree, pos));
+    }
 }
 
 TEST_CASE("children()")
@@ -305,5 +313,11 @@ TEST_CASE("node_position()")
         else if (event == lexy::traverse_event::leaf)
             CHECK(lexy_ext::node_position(tree, node) == node.lexeme().begin());
     REQUIRE(prod_count == 6);
+
+    lexy::parse_tree_node_index<parse_tree> index(tree);
+    for (auto [event, node] : tree.traverse())
+        if (event != lexy::traverse_event::exit)
+            CHECK(lexy_ext::node_position(tree, node, index)
+                  == lexy_ext::node_position(tree, node));
 }
 
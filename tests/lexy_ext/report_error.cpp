@@ -109,6 +109,28 @@ TEST_CASE("_detail::write_error")
 )*");
     }
 
+    SUBCASE("line index")
+    {
+        auto input = lexy::zstring_input("hello\nworld\nfoo");
+        auto index = lexy::input_line_index(input);
+
+        auto context = lexy::error_context(production{}, input, input.data() + 6);
+        lexy::string_error<error_tag> error(input.data() + 13);
+
+        std::string str;
+        lexy_ext::diagnostic_writer writer(input, index);
+        lexy_ext::_detail::write_error(std::back_insert_iterator(str), writer, context, error,
+                                       nullptr);
+        CHECK(str == R"*(error: while parsing production
+     |
+   2 | world
+     | ~ beginning here
+     |
+   3 | foo
+     |  ^ error tag
+)*");
+    }
+
     SUBCASE("error at newline")
     {
         auto input = lexy::zstring_input("hello\nworld");